@@ -0,0 +1,42 @@
+#include <iostream>
+#include <filesystem>
+#include <cctype>
+
+#include "sm83_aot_compiler.hpp"
+#include "../CARTRIDGE/gb_cartridge.hpp"
+
+// sm83_aot <rom> <output directory>
+//
+// Writes the sources of an sm83_aot module for the ROM, build them with
+//     cmake -S <output directory> -B <build directory>
+//     cmake --build <build directory>
+// and hand the shared object to sharpsm83::load_aot_module().
+int main(int argc, char* argv[])
+{
+    if(argc != 3)
+    {
+        std::cout<<"usage: "<<argv[0]<<" <rom> <output directory>"<<'\n';
+        return 1;
+    }
+
+    std::shared_ptr<gb_cartridge> cartridge = load_and_construct_cartridge(argv[1]);
+
+    // the module is named after the ROM file, as a valid CMake target name
+    std::string name = std::filesystem::path(argv[1]).stem().string();
+
+    for(char& c : name)
+    {
+        if(!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+    }
+
+    sm83_aot_compiler compiler(cartridge->get_data());
+
+    compiler.trace();
+    compiler.print_stats();
+
+    if(!compiler.write(argv[2], name + "_aot")) return 1;
+
+    std::cout<<"Wrote "<<name<<"_aot to "<<argv[2]<<'\n';
+
+    return 0;
+}
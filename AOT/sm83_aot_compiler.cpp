@@ -0,0 +1,318 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+
+#include "sm83_aot_compiler.hpp"
+#include "../CARTRIDGE/gb_cartridge.hpp"
+#include "../CPU/sm83_aot.hpp"
+
+//##############################################################################
+sm83_aot_compiler::sm83_aot_compiler(const std::vector<uint8_t>& rom) : rom(rom)
+{
+    bank_count = std::max<uint32_t>(2, (rom.size() + 0x3FFF) / 0x4000);
+    has_mbc = rom.size() > cartridge_header::CARTRIDGE_TYPE && rom[cartridge_header::CARTRIDGE_TYPE] != 0x00;
+}
+//##############################################################################
+uint8_t sm83_aot_compiler::read(uint16_t address, uint32_t bank) const
+{
+    uint32_t offset = address < 0x4000 ? address : bank * 0x4000 + (address - 0x4000);
+
+    return offset < rom.size() ? rom[offset] : 0xFF;
+}
+//##############################################################################
+void sm83_aot_compiler::add_target(uint16_t address, uint32_t mapped_bank)
+{
+    // code in RAM is only known at run time
+    if(address >= 0x8000)
+    {
+        ram_targets++;
+        return;
+    }
+
+    if(address >= 0x4000 && mapped_bank == 0)
+    {
+        if(has_mbc)
+        {
+            unknown_bank_targets++;
+            return;
+        }
+
+        mapped_bank = 1;
+    }
+
+    if(traced.insert({address, mapped_bank}).second)
+    {
+        pending.push_back({address, mapped_bank});
+    }
+}
+//##############################################################################
+void sm83_aot_compiler::trace_block(uint16_t address, uint32_t mapped_bank)
+{
+    uint32_t bank = address >= 0x4000 ? mapped_bank : 0;
+
+    if(bank >= bank_count) return;
+
+    // ROM is cacheable all the way, the boot ROM is gone by the time the
+    // cartridge code runs
+    sm83_block block = sm83_block_cache::decode(address,
+        [this, bank](uint16_t pc) { return read(pc, bank); },
+        [](uint16_t pc) { return pc < 0x8000; });
+
+    if(block.instructions.empty()) return;
+
+    // bank 0 code is the same whatever is mapped, it is only traced again
+    // to follow that bank
+    uint32_t key = sm83_block_cache::make_key(address, bank);
+    blocks.emplace(key, block);
+
+    bool a_known = false;
+    uint8_t a_value = 0;
+
+    for(const sm83_decoded_instr& instr : block.instructions)
+    {
+        uint8_t opcode = instr.opcode;
+        uint16_t immediate = instr.operands[0] | (instr.operands[1] << 8);
+
+        switch(opcode)
+        {
+            // JR
+            case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+                add_target(instr.address + 2 + static_cast<int8_t>(instr.operands[0]), mapped_bank);
+                break;
+            // JP and CALL
+            case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA:
+            case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC:
+                add_target(immediate, mapped_bank);
+                break;
+            // RST
+            case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+                add_target(opcode & 0x38, mapped_bank);
+                break;
+            // JP (HL)
+            case 0xE9:
+                computed_jumps++;
+                break;
+            // LD (a16),A switching the ROM bank (MBC1 takes the low 5 bits)
+            case 0xEA:
+                if(has_mbc && 0x2000 <= immediate && immediate < 0x4000)
+                {
+                    mapped_bank = a_known ? std::max<uint8_t>(a_value & 0x1F, 1) : 0;
+                }
+                break;
+        }
+
+        a_known = opcode == 0x3E;
+        a_value = instr.operands[0];
+    }
+
+    const sm83_decoded_instr& last = block.instructions.back();
+
+    switch(last.opcode)
+    {
+        // JR, JP, RET, RETI, JP (HL)
+        case 0x18: case 0xC3: case 0xC9: case 0xD9: case 0xE9:
+        // unused opcodes, this is data
+        case 0xD3: case 0xDB: case 0xDD: case 0xE3: case 0xE4: case 0xEB:
+        case 0xEC: case 0xED: case 0xF4: case 0xFC: case 0xFD:
+            break;
+        default:
+            add_target(last.address + last.length, mapped_bank);
+            break;
+    }
+}
+//##############################################################################
+void sm83_aot_compiler::trace()
+{
+    // the cartridge starts with bank 1 mapped, the vectors can run under any
+    add_target(0x0100, 1);
+
+    for(uint16_t vector = 0x00; vector <= 0x60; vector += 0x08)
+    {
+        add_target(vector, 0);
+    }
+
+    while(!pending.empty())
+    {
+        std::pair<uint16_t, uint32_t> target = pending.back();
+        pending.pop_back();
+
+        trace_block(target.first, target.second);
+    }
+}
+//##############################################################################
+std::string sm83_aot_compiler::block_name(uint32_t key) const
+{
+    std::ostringstream name;
+
+    name<<"block_"<<std::hex<<std::setfill('0')<<std::setw(2)<<(key >> 16)<<'_'<<std::setw(4)<<(key & 0xFFFF);
+
+    return name.str();
+}
+//##############################################################################
+bool sm83_aot_compiler::write_file(const std::string& path, const std::string& text) const
+{
+    std::ofstream file(path);
+
+    if(!file)
+    {
+        std::cout<<"sm83_aot: can't write "<<path<<'\n';
+        return false;
+    }
+
+    file<<text;
+
+    return static_cast<bool>(file);
+}
+//##############################################################################
+bool sm83_aot_compiler::write(const std::string& directory, const std::string& name) const
+{
+    if(blocks.empty())
+    {
+        std::cout<<"sm83_aot: no code found"<<'\n';
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    if(error)
+    {
+        std::cout<<"sm83_aot: can't create "<<directory<<": "<<error.message()<<'\n';
+        return false;
+    }
+
+    std::ostringstream header;
+    std::ostringstream module;
+    std::map<uint32_t, std::ostringstream> banks;
+
+    header<<"// Generated by sm83_aot, do not edit.\n"
+        <<"#ifndef _SM83_AOT_MODULE_\n"
+        <<"#define _SM83_AOT_MODULE_\n\n"
+        <<"#include \"sm83_aot.hpp\"\n\n"
+        <<"// the step table of the core that loaded the module\n"
+        <<"extern sm83_aot_step_table steps;\n\n";
+
+    module<<"// Generated by sm83_aot, do not edit.\n"
+        <<"#include \"module.hpp\"\n\n"
+        <<"sm83_aot_step_table steps;\n\n"
+        <<"static void bind(const sm83_aot_step_table* table)\n{\n    steps = *table;\n}\n\n"
+        <<"static const sm83_aot_block blocks[] =\n{\n";
+
+    for(const auto& entry : blocks)
+    {
+        uint32_t key = entry.first;
+        const std::vector<sm83_decoded_instr>& instructions = entry.second.instructions;
+        std::string function = block_name(key);
+
+        header<<"void "<<function<<"(sharpsm83* cpu);\n";
+
+        module<<"    {0x"<<std::hex<<std::setfill('0')<<std::setw(6)<<key<<", "
+            <<std::dec<<instructions.size()<<", "<<function<<"},\n";
+
+        std::ostringstream& code = banks[key >> 16];
+
+        code<<"//##############################################################################\n"
+            <<"static const sm83_decoded_instr "<<function<<"_code[] =\n{\n";
+
+        for(const sm83_decoded_instr& instr : instructions)
+        {
+            code<<std::hex<<std::setfill('0')
+                <<"    {0x"<<std::setw(4)<<instr.address
+                <<", 0x"<<std::setw(2)<<static_cast<int>(instr.opcode)
+                <<", {0x"<<std::setw(2)<<static_cast<int>(instr.operands[0])
+                <<", 0x"<<std::setw(2)<<static_cast<int>(instr.operands[1])<<"}, "
+                <<std::dec<<static_cast<int>(instr.length)<<", "
+                <<static_cast<int>(instr.cycles)<<"},\n";
+        }
+
+        code<<"};\n\n"
+            <<"void "<<function<<"(sharpsm83* cpu)\n{\n"
+            <<"    const sm83_decoded_instr* code = "<<function<<"_code;\n\n";
+
+        for(std::size_t i = 0; i < instructions.size(); ++i)
+        {
+            std::ostringstream step;
+            step<<"steps[0x"<<std::hex<<std::setfill('0')<<std::setw(2)<<static_cast<int>(instructions[i].opcode)
+                <<"](cpu, &code["<<std::dec<<i<<"], "<<i<<")";
+
+            if(i + 1 < instructions.size())
+            {
+                code<<"    if(!"<<step.str()<<") return;\n";
+            }
+            else
+            {
+                code<<"    "<<step.str()<<";\n";
+            }
+        }
+
+        code<<"}\n";
+    }
+
+    header<<"\n#endif\n";
+
+    module<<"};\n\n"
+        <<"static const sm83_aot_module module =\n{\n"
+        <<"    SM83_AOT_ABI_VERSION,\n"
+        <<"    "<<std::dec<<rom.size()<<"u,\n"
+        <<"    0x"<<std::hex<<sm83_aot::rom_hash(rom)<<"u,\n"
+        <<"    sizeof(blocks) / sizeof(blocks[0]),\n"
+        <<"    blocks,\n"
+        <<"    bind\n"
+        <<"};\n\n"
+        <<"extern \"C\" const sm83_aot_module* sm83_aot_get_module()\n{\n    return &module;\n}\n";
+
+    std::ostringstream cmake;
+    cmake<<"# Generated by sm83_aot, builds the module "<<name<<"\n"
+        <<"cmake_minimum_required(VERSION 3.15)\n"
+        <<"project("<<name<<" CXX)\n\n"
+        <<"set(CMAKE_CXX_STANDARD 17)\n"
+        <<"set(CMAKE_CXX_STANDARD_REQUIRED ON)\n\n"
+        <<"if(NOT CMAKE_BUILD_TYPE)\n    set(CMAKE_BUILD_TYPE Release)\nendif()\n\n"
+        <<"add_library("<<name<<" MODULE module.cpp";
+
+    for(const auto& bank : banks)
+    {
+        std::ostringstream file_name;
+        file_name<<"bank_"<<std::hex<<std::setfill('0')<<std::setw(2)<<bank.first<<".cpp";
+
+        std::string text = "// Generated by sm83_aot, do not edit.\n#include \"module.hpp\"\n\n" + bank.second.str();
+
+        if(!write_file(directory + "/" + file_name.str(), text)) return false;
+
+        cmake<<" "<<file_name.str();
+    }
+
+    cmake<<")\n"
+        <<"target_include_directories("<<name<<" PRIVATE \""<<SM83_AOT_CPU_DIR<<"\")\n";
+
+    return write_file(directory + "/module.hpp", header.str()) &&
+        write_file(directory + "/module.cpp", module.str()) &&
+        write_file(directory + "/CMakeLists.txt", cmake.str());
+}
+//##############################################################################
+void sm83_aot_compiler::print_stats()
+{
+    std::map<uint32_t, unsigned long int> blocks_by_bank;
+    unsigned long int instructions = 0;
+
+    for(const auto& entry : blocks)
+    {
+        blocks_by_bank[entry.first >> 16]++;
+        instructions += entry.second.instructions.size();
+    }
+
+    std::cout<<"sm83_aot: "<<std::dec<<blocks.size()<<" blocks, "<<instructions<<" instructions"<<'\n';
+
+    for(const auto& bank : blocks_by_bank)
+    {
+        std::cout<<"  bank "<<bank.first<<": "<<bank.second<<" blocks"<<'\n';
+    }
+
+    std::cout<<"Left to the interpreter: "
+        <<computed_jumps<<" computed jumps, "
+        <<unknown_bank_targets<<" targets in an unknown bank, "
+        <<ram_targets<<" targets in RAM"<<'\n';
+}
@@ -0,0 +1,59 @@
+#ifndef _SM83_AOT_COMPILER_
+#define _SM83_AOT_COMPILER_
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <utility>
+
+#include "../CPU/sm83_block_cache.hpp"
+
+// Finds the code of a cartridge and writes it out as the C++ sources of an
+// sm83_aot module (see CPU/sm83_aot.hpp).
+//
+// Code is traced from the entry point, the restart and the interrupt vectors,
+// following jumps, calls and fall-throughs, and decoded into the same blocks
+// the block cache would build. Which bank is mapped at 0x4000-0x7FFF is only
+// followed through "LD A,d8 ; LD (0x2000-0x3FFF),A", jumps whose bank can't be
+// told and computed jumps are left to the interpreter.
+class sm83_aot_compiler
+{
+private:
+    std::vector<uint8_t> rom;
+    uint32_t bank_count;
+    bool has_mbc;
+
+    // by block cache key, ordered so the output doesn't change between runs
+    std::map<uint32_t, sm83_block> blocks;
+
+    // (address, mapped bank) pairs waiting to be traced, and the ones that were;
+    // bank 0 means the mapped bank isn't known
+    std::vector<std::pair<uint16_t, uint32_t>> pending;
+    std::set<std::pair<uint16_t, uint32_t>> traced;
+
+    unsigned long int computed_jumps = 0;
+    unsigned long int unknown_bank_targets = 0;
+    unsigned long int ram_targets = 0;
+
+    uint8_t read(uint16_t address, uint32_t bank) const;
+
+    void add_target(uint16_t address, uint32_t mapped_bank);
+    void trace_block(uint16_t address, uint32_t mapped_bank);
+
+    std::string block_name(uint32_t key) const;
+    bool write_file(const std::string& path, const std::string& text) const;
+public:
+    sm83_aot_compiler(const std::vector<uint8_t>& rom);
+
+    void trace();
+
+    // module.hpp, module.cpp, one bank_NN.cpp per bank and a CMakeLists.txt
+    // building them into the shared object name
+    bool write(const std::string& directory, const std::string& name) const;
+
+    void print_stats();
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../GAMEBOY/gameboy.hpp"
+
+// The page table in bus_read/bus_write against read_slow/write_slow, the
+// chain of range checks every access went through before the table and
+// that the pages with side effects still use.
+
+static const int ROUNDS = 20000;
+
+//##############################################################################
+template<typename access>
+static double nanoseconds_per_access(const std::vector<uint16_t>& addresses, access run)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for(int round = 0; round < ROUNDS; ++round)
+    {
+        for(uint16_t address : addresses) run(address, round);
+    }
+
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / (double(ROUNDS) * addresses.size());
+}
+//##############################################################################
+int main(int argc, char** argv)
+{
+    gameboy gb;
+    gb.load_cartridge(argc > 1 ? argv[1] : GB_BENCH_ROM);
+
+    gb_bus& bus = *gb.get_bus();
+
+    // cartridge code, not the boot ROM
+    bus.boot_rom_active = false;
+    bus.map_pages();
+
+    std::mt19937 random(1);
+
+    // the address mix of an instruction stream: mostly ROM, work RAM and
+    // HRAM, some VRAM and LCD registers
+    std::vector<uint16_t> reads;
+
+    for(int i = 0; i < 4096; ++i)
+    {
+        uint32_t kind = random() % 100;
+
+        if(kind < 40) reads.push_back(0x0150 + random() % 0x3E00);
+        else if(kind < 60) reads.push_back(0x4000 + random() % 0x4000);
+        else if(kind < 80) reads.push_back(0xC000 + random() % 0x2000);
+        else if(kind < 88) reads.push_back(0xFF80 + random() % 0x7F);
+        else if(kind < 95) reads.push_back(0x8000 + random() % 0x2000);
+        else reads.push_back(0xFF40 + random() % 0x0C);
+    }
+
+    std::vector<uint16_t> writes;
+
+    for(int i = 0; i < 4096; ++i)
+    {
+        writes.push_back(0xC000 + random() % 0x2000);
+    }
+
+    unsigned int sink = 0;
+
+    double read_chain = nanoseconds_per_access(reads, [&](uint16_t address, int) { sink += bus.read_slow(address); });
+    double read_table = nanoseconds_per_access(reads, [&](uint16_t address, int) { sink += bus.bus_read(address); });
+    double write_chain = nanoseconds_per_access(writes, [&](uint16_t address, int round) { bus.write_slow(address, round); });
+    double write_table = nanoseconds_per_access(writes, [&](uint16_t address, int round) { bus.bus_write(address, round); });
+
+    std::printf("read:  if-chain %.2f ns, page table %.2f ns\n", read_chain, read_table);
+    std::printf("write: if-chain %.2f ns, page table %.2f ns\n", write_chain, write_table);
+
+    // keeps the reads from being optimized out
+    std::printf("checksum %08x\n", sink);
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include "../BUS/gb_flat_bus.hpp"
+
+// Every 0xCB opcode on its own: 64 copies of it and a JP back, run on the
+// flat bus so nothing but the instruction itself is timed. HL points into
+// work RAM for the (HL) forms, the ones changing H or L move it anywhere,
+// which the flat bus doesn't mind.
+
+static const int COPIES = 64;
+static const long int LOOPS = 10000;
+
+// M-cycles of CB opcode
+static int cb_cycles(uint8_t opcode)
+{
+    if((opcode & 0x07) != 0x06) return 2;
+
+    // BIT n,(HL) only reads
+    return (opcode & 0xC0) == 0x40 ? 3 : 4;
+}
+//##############################################################################
+static double nanoseconds_per_instruction(uint8_t opcode)
+{
+    auto bus = std::make_shared<gb_flat_bus>();
+
+    for(int i = 0; i < COPIES; ++i)
+    {
+        bus->memory[0x0100 + i * 2] = 0xCB;
+        bus->memory[0x0100 + i * 2 + 1] = opcode;
+    }
+
+    // JP 0x0100
+    bus->memory[0x0100 + COPIES * 2] = 0xC3;
+    bus->memory[0x0100 + COPIES * 2 + 1] = 0x00;
+    bus->memory[0x0100 + COPIES * 2 + 2] = 0x01;
+
+    flat_sharpsm83 cpu;
+    cpu.set_bus(bus);
+    cpu.reset();
+
+    sm83_registers registers = cpu.get_registers();
+    registers.PC = 0x0100;
+    registers.SP = 0xFFFE;
+    registers.H = 0xC8;
+    registers.L = 0x00;
+    cpu.set_registers(registers);
+
+    long int cycles = LOOPS * (COPIES * cb_cycles(opcode) + 4);
+    long int total = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    while(total < cycles) total += cpu.tick();
+
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / (LOOPS * COPIES);
+}
+//##############################################################################
+int main()
+{
+    double timings[256];
+    double sum = 0;
+
+    for(int opcode = 0; opcode < 256; ++opcode)
+    {
+        // best of 3, the machine is rarely quiet for a whole sweep
+        timings[opcode] = nanoseconds_per_instruction(opcode);
+        timings[opcode] = std::min(timings[opcode], nanoseconds_per_instruction(opcode));
+        timings[opcode] = std::min(timings[opcode], nanoseconds_per_instruction(opcode));
+
+        sum += timings[opcode];
+    }
+
+    std::printf("ns per instruction, row: high nibble of the CB opcode, column: low nibble\n    ");
+
+    for(int column = 0; column < 16; ++column) std::printf("    x%X", column);
+
+    for(int opcode = 0; opcode < 256; ++opcode)
+    {
+        if(opcode % 16 == 0) std::printf("\n%Xx  ", opcode / 16);
+
+        std::printf("%6.2f", timings[opcode]);
+    }
+
+    std::printf("\naverage %.2f ns\n", sum / 256);
+
+    return 0;
+}
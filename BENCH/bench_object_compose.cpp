@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "../GAMEBOY/gameboy.hpp"
+#include "../VIDEO/gb_tile_decode.hpp"
+
+// Frames from random VRAM, OAM and LCD registers rendered by gb_ppu, whose
+// objects go through the object line and compose_objects, checked pixel by
+// pixel against a per-pixel compositor with the DMG rules, then timed
+// against it. "--check" stops after the checks.
+
+struct lcd_registers
+{
+    uint8_t LCDC, SCY, SCX, WY, WX, BGP, OBP0, OBP1;
+};
+
+//##############################################################################
+static uint8_t tile_pixel(const uint8_t* video_ram, uint32_t tile, int row, int column)
+{
+    const uint8_t* data = &video_ram[tile * 16 + row * 2];
+
+    return (((data[1] >> (7 - column)) & 1) << 1) | ((data[0] >> (7 - column)) & 1);
+}
+//##############################################################################
+static uint8_t map_pixel(const uint8_t* video_ram, const lcd_registers& r, uint16_t map_address, int x, int y)
+{
+    uint8_t tile_index = video_ram[map_address - 0x8000 + (y / 8) * 32 + x / 8];
+
+    uint32_t tile = (r.LCDC & 0x10) ? tile_index : 256 + static_cast<int8_t>(tile_index);
+
+    return tile_pixel(video_ram, tile, y % 8, x % 8);
+}
+//##############################################################################
+// one pixel at a time: the background or window index under it, then the
+// first object of the line's ten with a pixel there, BG over OBJ applied to
+// that object alone
+static void plain_frame(const uint8_t* video_ram, const uint8_t* oam, const lcd_registers& r, uint8_t* shades)
+{
+    int height = (r.LCDC & 0x04) ? 16 : 8;
+
+    for(int line = 0; line < 144; ++line)
+    {
+        int objects[10];
+        int object_count = 0;
+
+        for(int object = 0; object < 40 && object_count < 10; ++object)
+        {
+            int top = oam[object * 4] - 16;
+
+            if(line >= top && line < top + height) objects[object_count++] = object;
+        }
+
+        for(int x = 0; x < 160; ++x)
+        {
+            uint8_t index = 0;
+            uint8_t shade = 0;
+
+            if(r.LCDC & 0x01)
+            {
+                bool window = (r.LCDC & 0x20) && line >= r.WY && r.WX <= 166 && x >= r.WX - 7;
+
+                if(window) index = map_pixel(video_ram, r, (r.LCDC & 0x40) ? 0x9C00 : 0x9800, x - (r.WX - 7), line - r.WY);
+                else index = map_pixel(video_ram, r, (r.LCDC & 0x08) ? 0x9C00 : 0x9800, (x + r.SCX) & 0xFF, (line + r.SCY) & 0xFF);
+
+                shade = (r.BGP >> (index * 2)) & 0x03;
+            }
+
+            // the smaller X wins, then the lower OAM index
+            int winner = -1;
+            uint8_t winner_index = 0;
+
+            for(int i = 0; (r.LCDC & 0x02) && i < object_count; ++i)
+            {
+                const uint8_t* object = &oam[objects[i] * 4];
+
+                int column = x - (object[1] - 8);
+
+                if(column < 0 || column >= 8) continue;
+                if(winner >= 0 && oam[winner * 4 + 1] <= object[1]) continue;
+
+                int row = line - (object[0] - 16);
+
+                if(object[3] & 0x40) row = height - 1 - row;
+                if(object[3] & 0x20) column = 7 - column;
+
+                uint32_t tile = height == 16 ? (object[2] & 0xFE) + row / 8 : object[2];
+
+                uint8_t object_index = tile_pixel(video_ram, tile, row % 8, column);
+
+                if(object_index == 0) continue;
+
+                winner = objects[i];
+                winner_index = object_index;
+            }
+
+            if(winner >= 0 && !((oam[winner * 4 + 3] & 0x80) && index != 0))
+            {
+                uint8_t palette = (oam[winner * 4 + 3] & 0x10) ? r.OBP1 : r.OBP0;
+
+                shade = (palette >> (winner_index * 2)) & 0x03;
+            }
+
+            shades[line * 160 + x] = shade;
+        }
+    }
+}
+//##############################################################################
+static void random_frame(std::mt19937& random, uint8_t* video_ram, uint8_t* oam, lcd_registers& r)
+{
+    for(int i = 0; i < 0x2000; ++i) video_ram[i] = random();
+
+    // a few columns of objects so they overlap, some at the same X; Y over
+    // the screen and past both edges
+    int columns[4];
+
+    for(int& column : columns) column = random() % 176;
+
+    for(int object = 0; object < 40; ++object)
+    {
+        oam[object * 4 + 0] = random() % 176;
+        oam[object * 4 + 1] = (random() & 3) ? std::min(columns[random() % 4] + static_cast<int>(random() % 5), 255) : random();
+        oam[object * 4 + 2] = random();
+        oam[object * 4 + 3] = random();
+    }
+
+    // the display on and objects on most of the time
+    r.LCDC = 0x80 | (random() & 0x7F) | ((random() & 3) ? 0x02 : 0x00);
+    r.SCY = random();
+    r.SCX = random();
+    r.WY = random() % 160;
+    r.WX = random() % 176;
+    r.BGP = random();
+    r.OBP0 = random();
+    r.OBP1 = random();
+}
+//##############################################################################
+static void load_frame(gb_bus& bus, gb_ppu& video, const uint8_t* video_ram, const uint8_t* oam, const lcd_registers& r)
+{
+    for(uint16_t i = 0; i < 0x2000; ++i) video.write(i, video_ram[i]);
+    for(uint16_t i = 0; i < 0xA0; ++i) bus.mem.write_oam(i, oam[i]);
+
+    video.write_LCDC(r.LCDC);
+    video.write_SCY(r.SCY);
+    video.write_SCX(r.SCX);
+    video.write_WY(r.WY);
+    video.write_WX(r.WX);
+    video.write_BGP(r.BGP);
+    video.write_OBP0(r.OBP0);
+    video.write_OBP1(r.OBP1);
+}
+//##############################################################################
+static bool check_frames(gb_bus& bus, gb_ppu& video)
+{
+    std::mt19937 random(0x0BE);
+
+    static uint8_t video_ram[0x2000];
+    static uint8_t expected[144 * 160];
+    uint8_t oam[0xA0];
+    lcd_registers r;
+
+    for(int frame = 0; frame < 1000; ++frame)
+    {
+        random_frame(random, video_ram, oam, r);
+        load_frame(bus, video, video_ram, oam, r);
+
+        // from LY 0 round to LY 0, every line with the registers above
+        video.tick(CLOCKS_PER_VBLANK * LINES_PER_FRAME);
+
+        plain_frame(video_ram, oam, r, expected);
+
+        const frame_buffer& buffer = video.get_frame_buffer();
+
+        for(int y = 0; y < 144; ++y)
+        {
+            for(int x = 0; x < 160; ++x)
+            {
+                int shade = static_cast<int>(buffer.get_pixel(x, y));
+
+                if(shade != expected[y * 160 + x])
+                {
+                    std::printf("object compose: mismatch in frame %d at (%d, %d), LCDC %02X: shade %d, per pixel %d\n",
+                        frame, x, y, r.LCDC, shade, expected[y * 160 + x]);
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+//##############################################################################
+int main(int argc, char** argv)
+{
+    // the PPU on the bus without a cartridge, nothing else reads VRAM
+    gameboy gb;
+
+    gb_bus& bus = *gb.get_bus();
+    gb_ppu& video = *gb.get_video();
+
+    if(!check_frames(bus, video)) return 1;
+
+    std::printf("%s object compose matches the per-pixel compositor\n", tile_decode_kernel());
+
+    if(argc > 1 && std::strcmp(argv[1], "--check") == 0) return 0;
+
+    // one busy frame: 8x16 objects over the background, 10 on most lines
+    std::mt19937 random(0x0BE);
+
+    static uint8_t video_ram[0x2000];
+    static uint8_t shades[144 * 160];
+    uint8_t oam[0xA0];
+    lcd_registers r;
+
+    random_frame(random, video_ram, oam, r);
+
+    for(int object = 0; object < 40; ++object) oam[object * 4] = 16 + (object * 37) % 144;
+
+    r.LCDC = 0x97;
+
+    load_frame(bus, video, video_ram, oam, r);
+
+    double plain = 1e9, renderer = 1e9;
+
+    for(int trial = 0; trial < 50; ++trial)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        plain_frame(video_ram, oam, r, shades);
+
+        auto middle = std::chrono::steady_clock::now();
+
+        video.tick(CLOCKS_PER_VBLANK * LINES_PER_FRAME);
+
+        std::chrono::duration<double, std::micro> plain_time = middle - start;
+        std::chrono::duration<double, std::micro> renderer_time = std::chrono::steady_clock::now() - middle;
+
+        plain = std::min(plain, plain_time.count());
+        renderer = std::min(renderer, renderer_time.count());
+    }
+
+    std::printf("frame with objects: per pixel %8.2f us, renderer %8.2f us (%.1fx)\n", plain, renderer, plain / renderer);
+
+    return 0;
+}
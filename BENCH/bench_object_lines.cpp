@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "../MEMORY/gb_memory.hpp"
+
+// The per-line object bitsets gb_memory::write_oam keeps, checked against a
+// scan of every OAM entry after random OAM writes, for 8x8 and 8x16 objects
+// (LCDC.2), then timed against that scan for a whole frame. "--check" stops
+// after the checks.
+
+//##############################################################################
+static uint64_t scan_objects_on_line(const gb_memory& mem, int line, bool tall)
+{
+    uint64_t objects = 0;
+
+    for(int object = 0; object < 40; ++object)
+    {
+        int top = mem.oam[object * 4] - 16;
+
+        if(line >= top && line < top + (tall ? 16 : 8)) objects |= uint64_t(1) << object;
+    }
+
+    return objects;
+}
+//##############################################################################
+static bool check_lines(const gb_memory& mem, bool tall, int write)
+{
+    // past the last visible line nothing is selected
+    for(int line = 0; line < 256; ++line)
+    {
+        uint64_t expected = line < 144 ? scan_objects_on_line(mem, line, tall) : 0;
+        uint64_t objects = mem.get_objects_on_line(line, tall);
+
+        if(objects != expected)
+        {
+            std::printf("object_lines: mismatch after write %d, line %d, %s objects: %016llX, scan %016llX\n",
+                write, line, tall ? "8x16" : "8x8", static_cast<unsigned long long>(objects), static_cast<unsigned long long>(expected));
+            return false;
+        }
+    }
+
+    return true;
+}
+//##############################################################################
+static bool check_object_lines()
+{
+    std::mt19937 random(0x0A4);
+
+    gb_memory mem;
+
+    if(!check_lines(mem, false, 0) || !check_lines(mem, true, 0)) return false;
+
+    // Y bytes over the whole range, around the top and bottom edges more
+    // often, writes of the Y already there, and the other three bytes
+    // around them; LCDC.2 flips at random in between
+    bool tall = false;
+
+    for(int write = 1; write <= 200000; ++write)
+    {
+        uint32_t pick = random();
+        uint16_t address = (pick >> 8) % 0xA0;
+
+        if(pick & 0x08) address &= ~0x03;
+
+        uint8_t data;
+
+        switch(pick & 0x07)
+        {
+            case 0: data = mem.oam[address]; break;
+            case 1: data = random() % 24; break;
+            case 2: data = 150 + random() % 16; break;
+            default: data = random(); break;
+        }
+
+        mem.write_oam(address, data);
+
+        if((random() & 0x0F) == 0) tall = !tall;
+
+        // every line after the first writes, then spot checks
+        if(write > 2000 && (random() & 0x3F)) continue;
+
+        if(!check_lines(mem, tall, write)) return false;
+    }
+
+    // the same sequence an OAM DMA writes, from scratch
+    gb_memory copied;
+
+    for(uint16_t address = 0; address < 0xA0; ++address) copied.write_oam(address, mem.oam[address]);
+
+    return check_lines(copied, false, 0) && check_lines(copied, true, 0);
+}
+//##############################################################################
+template<typename kernel>
+static double best_microseconds(kernel run)
+{
+    double best = 1e9;
+
+    for(int trial = 0; trial < 200; ++trial)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        for(int repeat = 0; repeat < 20; ++repeat) run();
+
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+        best = std::min(best, elapsed.count() / 20);
+    }
+
+    return best;
+}
+//##############################################################################
+int main(int argc, char** argv)
+{
+    if(!check_object_lines()) return 1;
+
+    std::printf("object line bitsets match the OAM scan\n");
+
+    if(argc > 1 && std::strcmp(argv[1], "--check") == 0) return 0;
+
+    // 40 objects spread over the screen, the lines of one frame
+    gb_memory mem;
+
+    for(int object = 0; object < 40; ++object)
+    {
+        mem.write_oam(object * 4, 16 + (object * 37) % 144);
+        mem.write_oam(object * 4 + 1, 8 + (object * 53) % 160);
+    }
+
+    volatile uint64_t sink;
+
+    double scan = best_microseconds([&] { uint64_t all = 0; for(int line = 0; line < 144; ++line) all ^= scan_objects_on_line(mem, line, false); sink = all; });
+    double bitsets = best_microseconds([&] { uint64_t all = 0; for(int line = 0; line < 144; ++line) all ^= mem.get_objects_on_line(line, false); sink = all; });
+
+    std::printf("objects of 144 lines: OAM scan %6.2f us, bitsets %6.2f us (%.1fx)\n", scan, bitsets, scan / bitsets);
+
+    return 0;
+}
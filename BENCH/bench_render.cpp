@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "../GAMEBOY/gameboy.hpp"
+
+// Whole frames rendered from the VRAM a ROM leaves behind, in lines per
+// second, with the background alone, scrolled, with the window and with
+// objects on top.
+
+static const int FRAMES = 1000;
+
+//##############################################################################
+static double lines_per_second(gb_ppu& video)
+{
+    double best = 0;
+
+    for(int trial = 0; trial < 3; ++trial)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        for(int frame = 0; frame < FRAMES; ++frame) video.tick(CLOCKS_PER_VBLANK * LINES_PER_FRAME);
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        best = std::max(best, FRAMES * GAMEBOY_HEIGHT / elapsed.count());
+    }
+
+    return best;
+}
+//##############################################################################
+static uint64_t frame_hash(gb_ppu& video)
+{
+    const frame_buffer& buffer = video.get_frame_buffer();
+
+    uint64_t hash = 1469598103934665603ULL;
+
+    for(uint32_t y = 0; y < GAMEBOY_HEIGHT; ++y)
+    {
+        for(uint32_t x = 0; x < GAMEBOY_WIDTH; ++x)
+        {
+            hash ^= static_cast<uint64_t>(buffer.get_pixel(x, y));
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+//##############################################################################
+int main(int argc, char** argv)
+{
+    gameboy gb;
+    gb.load_cartridge(argc > 1 ? argv[1] : GB_BENCH_ROM);
+    gb.get_cpu()->reset();
+
+    // far enough for the ROM to have its font and text in VRAM
+    long int cycles = 0;
+
+    while(cycles < 20000000)
+    {
+        int taken = gb.get_cpu()->tick();
+
+        if(taken < 0) break;
+
+        cycles += taken;
+    }
+
+    gb_bus& bus = *gb.get_bus();
+    gb_ppu& video = *gb.get_video();
+
+    struct scenario
+    {
+        const char* name;
+        uint8_t LCDC, SCX, WY, WX;
+        bool objects;
+    };
+
+    const scenario scenarios[] =
+    {
+        {"background", 0x91, 0, 0, 0, false},
+        {"background, SCX 3", 0x91, 3, 0, 0, false},
+        {"background and window", 0xB1, 3, 0x40, 0x30, false},
+        {"40 objects 8x8", 0x93, 3, 0, 0, true},
+        {"40 objects 8x16", 0x97, 3, 0, 0, true},
+    };
+
+    for(const scenario& s : scenarios)
+    {
+        bus.bus_write(0xFF40, s.LCDC);
+        bus.bus_write(0xFF43, s.SCX);
+        bus.bus_write(0xFF4A, s.WY);
+        bus.bus_write(0xFF4B, s.WX);
+
+        // spread over the screen, some of them overlapping
+        for(int object = 0; object < 40; ++object)
+        {
+            bus.mem.write_oam(object * 4 + 0, s.objects ? 16 + (object * 13) % 150 : 0);
+            bus.mem.write_oam(object * 4 + 1, 8 + (object * 29) % 160);
+            bus.mem.write_oam(object * 4 + 2, 0x30 + object);
+            bus.mem.write_oam(object * 4 + 3, (object % 4) << 4);
+        }
+
+        double rate = lines_per_second(video);
+
+        std::printf("%-24s %10.0f lines/s  frame %016llx\n", s.name, rate, static_cast<unsigned long long>(frame_hash(video)));
+    }
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "../VIDEO/gb_tile_decode.hpp"
+
+// The tile decode, palette and object compose kernels of this build
+// (VIDEO_SIMD) checked against plain per-pixel loops over every input that
+// matters, then timed against the per-pixel shift loop the renderer used
+// before them. "--check" stops after the checks.
+
+//##############################################################################
+static void shift_decode(const uint8_t* planes, std::size_t count, uint8_t* pixels, bool flipped)
+{
+    for(std::size_t row = 0; row < count; ++row)
+    {
+        uint8_t low = planes[row * 2];
+        uint8_t high = planes[row * 2 + 1];
+
+        for(int x = 0; x < 8; ++x)
+        {
+            int bit = flipped ? x : 7 - x;
+
+            pixels[row * 8 + x] = (((high >> bit) & 1) << 1) | ((low >> bit) & 1);
+        }
+    }
+}
+//##############################################################################
+static void shift_palette(const uint8_t* pixels, std::size_t count, uint8_t palette, uint8_t* shades)
+{
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        shades[i] = (palette >> (pixels[i] * 2)) & 0x03;
+    }
+}
+//##############################################################################
+static void plain_compose(const uint8_t* objects, const uint8_t* background, std::size_t count, uint8_t obp0, uint8_t obp1, uint8_t* shades)
+{
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        uint8_t index = objects[i] & 0x03;
+        bool behind = (objects[i] & 0x08) && background[i] != 0;
+
+        if(index == 0 || behind) continue;
+
+        shades[i] = (((objects[i] & 0x04) ? obp1 : obp0) >> (index * 2)) & 0x03;
+    }
+}
+//##############################################################################
+static bool check_kernels()
+{
+    // every pair of bitplanes, in both directions, and counts leaving tails
+    std::vector<uint8_t> planes(65536 * 2);
+
+    for(uint32_t i = 0; i < 65536; ++i)
+    {
+        planes[i * 2] = i & 0xFF;
+        planes[i * 2 + 1] = i >> 8;
+    }
+
+    std::vector<uint8_t> expected(65536 * 8), pixels(65536 * 8);
+
+    for(bool flipped : {false, true})
+    {
+        for(std::size_t count : {65536, 65533, 7, 3})
+        {
+            std::fill(expected.begin(), expected.end(), 9);
+            std::fill(pixels.begin(), pixels.end(), 9);
+
+            shift_decode(planes.data(), count, expected.data(), flipped);
+            decode_tile_rows(planes.data(), count, pixels.data(), flipped);
+
+            if(expected != pixels)
+            {
+                std::printf("decode_tile_rows: mismatch, %zu rows%s\n", count, flipped ? ", flipped" : "");
+                return false;
+            }
+        }
+    }
+
+    // every palette over every index, and counts leaving tails
+    shift_decode(planes.data(), 65536, pixels.data(), false);
+
+    for(uint32_t palette = 0; palette < 256; ++palette)
+    {
+        for(std::size_t count : {65536 * 8, 161, 31})
+        {
+            std::vector<uint8_t> expected_shades(count), shades(count);
+
+            shift_palette(pixels.data(), count, palette, expected_shades.data());
+            apply_palette(pixels.data(), count, palette, shades.data());
+
+            if(expected_shades != shades)
+            {
+                std::printf("apply_palette: mismatch, palette %02X, %zu pixels\n", palette, count);
+                return false;
+            }
+        }
+    }
+
+    // every object byte over every background index and shade, for a few
+    // palette pairs
+    std::vector<uint8_t> objects, background, under;
+
+    for(uint32_t object = 0; object < 16; ++object)
+    {
+        for(uint32_t index = 0; index < 4; ++index)
+        {
+            for(uint32_t shade = 0; shade < 4; ++shade)
+            {
+                objects.push_back(object);
+                background.push_back(index);
+                under.push_back(shade);
+            }
+        }
+    }
+
+    for(std::pair<uint8_t, uint8_t> palettes : {std::make_pair(0xE4, 0x1B), std::make_pair(0xD2, 0x2D), std::make_pair(0x00, 0xFF)})
+    {
+        for(std::size_t count : {objects.size(), objects.size() - 5, std::size_t(13)})
+        {
+            std::vector<uint8_t> expected_shades(under), shades(under);
+
+            plain_compose(objects.data(), background.data(), count, palettes.first, palettes.second, expected_shades.data());
+            compose_objects(objects.data(), background.data(), count, palettes.first, palettes.second, shades.data());
+
+            if(expected_shades != shades)
+            {
+                std::printf("compose_objects: mismatch, OBP0 %02X, OBP1 %02X, %zu pixels\n", palettes.first, palettes.second, count);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+//##############################################################################
+template<typename kernel>
+static double best_microseconds(kernel run)
+{
+    double best = 1e9;
+
+    for(int trial = 0; trial < 200; ++trial)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        for(int repeat = 0; repeat < 20; ++repeat) run();
+
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+        best = std::min(best, elapsed.count() / 20);
+    }
+
+    return best;
+}
+//##############################################################################
+int main(int argc, char** argv)
+{
+    if(!check_kernels()) return 1;
+
+    std::printf("%s kernels match the per-pixel loops\n", tile_decode_kernel());
+
+    if(argc > 1 && std::strcmp(argv[1], "--check") == 0) return 0;
+
+    // all 384 tiles of VRAM at once, as dump_tiles decodes them
+    std::vector<uint8_t> video_ram(384 * 16);
+
+    for(std::size_t i = 0; i < video_ram.size(); ++i)
+    {
+        video_ram[i] = (i * 2654435761u) >> 13;
+    }
+
+    std::vector<uint8_t> pixels(384 * 64), shades(384 * 64);
+    volatile uint8_t sink;
+
+    double decode_loop = best_microseconds([&] { shift_decode(video_ram.data(), 3072, pixels.data(), false); sink = pixels[5]; });
+    double decode_kernel = best_microseconds([&] { decode_tile_rows(video_ram.data(), 3072, pixels.data()); sink = pixels[5]; });
+    double palette_loop = best_microseconds([&] { shift_palette(pixels.data(), pixels.size(), 0xE4, shades.data()); sink = shades[5]; });
+    double palette_kernel = best_microseconds([&] { apply_palette(pixels.data(), pixels.size(), 0xE4, shades.data()); sink = shades[5]; });
+
+    std::printf("decode 3072 rows:   shift loop %6.2f us, kernel %6.2f us (%.1fx)\n", decode_loop, decode_kernel, decode_loop / decode_kernel);
+    std::printf("palette %zu px: shift loop %6.2f us, kernel %6.2f us (%.1fx)\n", pixels.size(), palette_loop, palette_kernel, palette_loop / palette_kernel);
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../GAMEBOY/gameboy.hpp"
+
+// gameboy (sm83_exact_timing) against fast_gameboy (sm83_fast_timing) on the
+// same ROM, run in turns so both see the same state of the host, with the
+// best and the median of the rounds and whether the last frames match.
+
+static const long int CYCLES = 80000000;  // T-cycles per run
+static const int ROUNDS = 9;
+
+//##############################################################################
+template<typename machine>
+static double run_seconds(const char* rom, std::vector<gb_color>& frame)
+{
+    machine gb;
+    gb.load_cartridge(rom);
+    gb.get_cpu()->reset();
+
+    auto start = std::chrono::steady_clock::now();
+
+    long int cycles = 0;
+
+    while(cycles < CYCLES)
+    {
+        int taken = gb.get_cpu()->tick();
+
+        if(taken < 0) break;
+
+        cycles += taken;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const frame_buffer& buffer = gb.get_video()->get_frame_buffer();
+
+    frame.clear();
+
+    for(uint32_t y = 0; y < GAMEBOY_HEIGHT; ++y)
+    {
+        for(uint32_t x = 0; x < GAMEBOY_WIDTH; ++x) frame.push_back(buffer.get_pixel(x, y));
+    }
+
+    return elapsed.count();
+}
+//##############################################################################
+static double median(std::vector<double> times)
+{
+    std::sort(times.begin(), times.end());
+
+    return times[times.size() / 2];
+}
+//##############################################################################
+int main(int argc, char** argv)
+{
+    const char* rom = argc > 1 ? argv[1] : GB_BENCH_ROM;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : ROUNDS;
+
+    std::vector<double> exact, fast;
+    std::vector<gb_color> exact_frame, fast_frame;
+
+    // the order flips every round, neither always runs on a warm cache
+    for(int round = 0; round < rounds; ++round)
+    {
+        if(round % 2)
+        {
+            fast.push_back(run_seconds<fast_gameboy>(rom, fast_frame));
+            exact.push_back(run_seconds<gameboy>(rom, exact_frame));
+        }
+        else
+        {
+            exact.push_back(run_seconds<gameboy>(rom, exact_frame));
+            fast.push_back(run_seconds<fast_gameboy>(rom, fast_frame));
+        }
+    }
+
+    double exact_best = *std::min_element(exact.begin(), exact.end());
+    double fast_best = *std::min_element(fast.begin(), fast.end());
+
+    std::printf("%ld T-cycles, %d rounds\n", CYCLES, rounds);
+    std::printf("gameboy       best %6.3f s  median %6.3f s\n", exact_best, median(exact));
+    std::printf("fast_gameboy  best %6.3f s  median %6.3f s  (%.2fx, median %.2fx)\n",
+        fast_best, median(fast), exact_best / fast_best, median(exact) / median(fast));
+    std::printf("last frame %s\n", exact_frame == fast_frame ? "the same" : "differs");
+
+    return 0;
+}
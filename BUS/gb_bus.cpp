@@ -20,8 +20,96 @@ const std::array<uint8_t, 256> bootDMG = {
     0xF5, 0x06, 0x19, 0x78, 0x86, 0x23, 0x05, 0x20, 0xFB, 0x86, 0x00, 0x00, 0x3E, 0x01, 0xE0, 0x50
 };
 
-uint8_t gb_bus::bus_read(const uint16_t& address)
+gb_bus::gb_bus()
 {
+    // registers that live on the bus itself
+    set_io_handler(0xFF00, {nullptr, &gb_bus::write_io, this, 0xC0, 0x30}); // joypad
+    set_io_handler(0xFF01, {&gb_bus::read_io, &gb_bus::write_io, this});    // SB - serial data
+    set_io_handler(0xFF02, {&gb_bus::read_io, &gb_bus::write_io, this, 0x7E, 0x81}); // SC - serial control
+    set_io_handler(0xFF46, {nullptr, &gb_bus::write_io, this});             // OAM DMA
+    set_io_handler(0xFF4D, {&gb_bus::read_io, &gb_bus::write_io, this, 0x7E, 0x01}); // KEY1
+    set_io_handler(0xFF50, {nullptr, &gb_bus::write_io, this});             // boot ROM unmap
+}
+void gb_bus::set_io_handler(const uint16_t& address, const gb_io_handler& handler)
+{
+    if(address == 0xFFFF) interrupt_enable = handler;
+    else io_handlers[address - 0xFF00] = handler;
+}
+void gb_bus::request_interrupt(uint8_t mask)
+{
+    const gb_io_handler& handler = io_handlers[0x0F];
+
+    handler.write(handler.context, 0xFF0F, handler.read(handler.context, 0xFF0F) | mask);
+}
+uint8_t gb_bus::read_io(void* context, const uint16_t& address)
+{
+    gb_bus* bus = static_cast<gb_bus*>(context);
+
+    switch(address)
+    {
+        case 0xFF01: return bus->serial_data;
+        case 0xFF02: return bus->serial_control;
+        default: return bus->mem.KEY1;
+    }
+}
+void gb_bus::write_io(void* context, const uint16_t& address, const uint8_t& data)
+{
+    gb_bus* bus = static_cast<gb_bus*>(context);
+
+    switch(address)
+    {
+        case 0xFF00: // Joypad
+        {
+            bus->mem.JOYP = data;
+            break;
+        }
+        case 0xFF01: // SB - serial data
+        {
+            bus->serial_data = data;
+            break;
+        }
+        case 0xFF02: // SC - serial control
+        {
+            if (data == 0x81) 
+            {
+                // Blargg’s test: print immediately
+                std::cout << static_cast<char>(bus->serial_data);
+            }
+            bus->serial_control = data;
+            break;
+        }
+        case 0xFF46:
+        {
+            bus->dma_transfer(data);
+            break;
+        }
+        case 0xFF4D:
+        {
+            bus->mem.KEY1 = (bus->mem.KEY1 & 0x80) | data;
+            break;
+        }
+        case 0xFF50:
+        {
+            std::cout<<"BOOT ROM deactivated!"<<"\n";
+            bus->boot_rom_active = false;  // unmap boot ROM
+            bus->map_cartridge_pages();
+            break;
+        }
+    }
+}
+uint8_t gb_bus::read_slow(const uint16_t& address)
+{
+    // I/O registers
+    if(0xFF00 <= address && address <= 0xFF7F)
+    {
+        const gb_io_handler& handler = io_handlers[address - 0xFF00];
+
+        // not implemented
+        if(!handler.read) return 0xFF;
+
+        return handler.read(handler.context, address) | handler.unused_bits;
+    }
+
     // cartridge read
     if(address < 0x8000)
     {
@@ -35,7 +123,11 @@ uint8_t gb_bus::bus_read(const uint16_t& address)
     }
 
     // VRAM read
-    if(0x8000 <= address && address <= 0x9FFF) return video->read(address - 0x8000);
+    if(0x8000 <= address && address <= 0x9FFF) 
+    {
+        video->sync();
+        return video->read(address - 0x8000);
+    }
 
     // external RAM read
     if(0xA000 <= address && address <= 0xBFFF)  return cartridge->read(address);
@@ -53,6 +145,7 @@ uint8_t gb_bus::bus_read(const uint16_t& address)
     // OAM read
     if(0xFE00 <= address && address <= 0xFE9F) 
     {
+        video->sync();
         return mem.read_oam(address - 0xFE00);
     }
 
@@ -64,59 +157,45 @@ uint8_t gb_bus::bus_read(const uint16_t& address)
         return 0xFF;
     }
 
-    // I/O registers
-    if(0xFF00 <= address && address <= 0xFF7F)
-    {
-        //std::cout<<"[READ] IO: "<<std::hex<<address<<'\n';
-        //if (address == 0xFF00) return mem.JOYP | 0x0F; //TODO: implement properly
-        if (address == 0xFF01) return serial_data;
-        if (address == 0xFF02) return serial_control;
-        if (address == 0xFF04) return timer->get_DIV();
-        if (address == 0xFF05) return timer->get_TIMA();
-        if (address == 0xFF06) return timer->get_TMA();
-        if (address == 0xFF07) return timer->get_TAC();
-        if (address == 0xFF0F) return cpu->get_IF(); // Interrupt flags
-        if (address == 0xFF40) return video->read_LCDC();
-        if (address == 0xFF41) return video->read_STAT();
-        if (address == 0xFF42) return video->read_SCY();
-        if (address == 0xFF43) return video->read_SCX();
-        if (address == 0xFF44) return video->read_LY();
-        if (address == 0xFF45) return video->read_LYC();
-        if (address == 0xFF47) return video->read_BGP();
-        if (address == 0xFF48) return video->read_OPB0();
-        if (address == 0xFF49) return video->read_OPB1();
-
-        if (address == 0xFF4D) return mem.KEY1 & 0x81;
-
-        //std::cout<<"[READ] IO not implemented: 0x"<<std::hex<<static_cast<int>(address)<<'\n';
-        
-        // TODO
-        return 0xFF;
-    };
-
     // HRAM
     if(0xFF80 <= address && address <= 0xFFFE)  return mem.read_hram(address - 0xFF80);
 
     // Interrupt enable register
-    if(address == 0xFFFF) return cpu->get_IE();
+    if(address == 0xFFFF) return interrupt_enable.read(interrupt_enable.context, address);
 
     std::cout<<"[READ end] No valid address: 0x"<<std::hex<<static_cast<int>(address)<<'\n';
 
     exit(-1);
 }
-void gb_bus::bus_write(const uint16_t& address, const uint8_t& data)
+void gb_bus::write_slow(const uint16_t& address, const uint8_t& data)
 {
+    // I/O registers
+    if(0xFF00 <= address && address <= 0xFF7F)
+    {
+        const gb_io_handler& handler = io_handlers[address - 0xFF00];
+
+        if(handler.write) handler.write(handler.context, address, data & handler.writable_bits);
+
+        return;
+    }
+
     // cartridge write
     if(address < 0x8000)
     {
         if(cartridge)
+        {
             cartridge->write(address, data);
+            
+            // MBC register, the banks may have moved
+            map_cartridge_pages();
+        }
         return;
     }
 
     // VRAM write
     if(0x8000 <= address && address <= 0x9FFF) 
     {
+        video->sync();
         video->write(address - 0x8000, data);
         return;
     }
@@ -146,6 +225,7 @@ void gb_bus::bus_write(const uint16_t& address, const uint8_t& data)
     // OAM write
     if(0xFE00 <= address && address <= 0xFE9F)
     {
+        video->sync();
         mem.write_oam(address - 0xFE00, data);
         return;
     }
@@ -158,124 +238,6 @@ void gb_bus::bus_write(const uint16_t& address, const uint8_t& data)
         //exit(-1);
     }
 
-    // I/O registers
-    if(0xFF00 <= address && address <= 0xFF7F)
-    {
-        //std::cout<<"[WRITE] IO: "<<std::hex<<address<<'\n';
-
-        if (address == 0xFF00) // Joypad
-        { 
-            mem.JOYP = data & 0x30;
-            return;
-        }
-        if (address == 0xFF01) // SB - serial data
-        { 
-            serial_data = data;
-            return;
-        }
-        if (address == 0xFF02) // SC - serial control
-        {
-            if (data == 0x81) 
-            {
-                // Blargg’s test: print immediately
-                std::cout << static_cast<char>(serial_data);
-            }
-            serial_control = data;
-            return;
-        }
-        if (address == 0xFF04) 
-        { 
-            timer->reset_DIV(); 
-            return; 
-        }
-        if (address == 0xFF05) 
-        { 
-            timer->set_TIMA(data); 
-            return; 
-        }
-        if (address == 0xFF06) 
-        { 
-            timer->set_TMA(data); 
-            return; 
-        }
-        if (address == 0xFF07) 
-        { 
-            timer->set_TAC(data); 
-            return; 
-        }
-        if (address == 0xFF0F) // IF - interrupt flags
-        {
-            cpu->set_IF(data);
-            return;
-        }
-        if (address == 0xFF40)
-        {
-            video->write_LCDC(data);
-            return;
-        }
-        if (address == 0xFF41)
-        {
-            video->write_STAT(data);
-            return;
-        }
-        if (address == 0xFF42)
-        {
-            video->write_SCY(data);
-            return;
-        }
-        if (address == 0xFF43)
-        {
-            video->write_SCX(data);
-            return;
-        }
-        if (address == 0xFF44)
-        {
-            video->write_LY(data);
-            return;
-        }
-        if (address == 0xFF45)
-        {
-            video->write_LYC(data);
-            return;
-        }
-        if (address == 0xFF46)
-        {
-            dma_transfer(data);
-            return;
-        }
-        if (address == 0xFF47)
-        {
-            video->write_BGP(data);
-            return;
-        }
-        if (address == 0xFF48)
-        {
-            video->write_OBP0(data);
-            return;
-        }
-        if (address == 0xFF49)
-        {
-            video->write_OBP1(data);
-            return;
-        }
-        if (address == 0xFF4D)
-        {
-            mem.KEY1 = (mem.KEY1 & 0x80) | (data & 0x01);
-            return;
-        }
-
-        if (address == 0xFF50) 
-        {
-            std::cout<<"BOOT ROM deactivated!"<<"\n";
-            boot_rom_active = false;  // unmap boot ROM
-            return;
-        }
-
-        //std::cout<<"[WRITE] IO not implemented: 0x"<<std::hex<<static_cast<int>(address)<<" data: 0x"<<std::hex<<static_cast<int>(data)<<'\n';
-        // TODO
-        return;
-    }
-
     // HRAM
     if(0xFF80 <= address && address <= 0xFFFE)
     {
@@ -287,7 +249,7 @@ void gb_bus::bus_write(const uint16_t& address, const uint8_t& data)
     // Interrupt enable register
     if(address == 0xFFFF)
     {
-        cpu->set_IE(data);
+        interrupt_enable.write(interrupt_enable.context, address, data);
         return;
     }
     
@@ -298,16 +260,70 @@ void gb_bus::bus_write(const uint16_t& address, const uint8_t& data)
 void gb_bus::set_cartridge(const std::shared_ptr<gb_cartridge>& c)
 {
    cartridge = c; 
+
+   map_pages();
 }
-void gb_bus::set_cpu(const std::shared_ptr<sharpsm83>& c)
+bool gb_bus::is_plain_memory(const uint16_t& first, const uint16_t& last, bool write)
 {
-    cpu = c;
+    for(uint32_t page = first >> 8; page <= static_cast<uint32_t>(last >> 8); ++page)
+    {
+        uint16_t address = page << 8;
+
+        // ROM and external RAM only when the page table maps them, writes to
+        // them are MBC registers
+        if(address < 0x8000 || (0xA000 <= address && address <= 0xBFFF))
+        {
+            if(write ? !write_pages[page] : !read_pages[page]) return false;
+            continue;
+        }
+
+        // VRAM, work RAM and its echo
+        if(address < 0xFE00) continue;
+
+        // OAM, the unusable area, I/O, HRAM and IE share the last pages
+        if(page == 0xFE) 
+        {
+            if(last > 0xFE9F) return false;
+            continue;
+        }
+
+        if(first < 0xFF80 || last > 0xFFFE) return false;
+    }
+
+    return true;
 }
-void gb_bus::tick(int cycles) 
-{ 
-    video->tick(4*cycles);//!!!!!!!!!!!!!!!!!!!
-    
-    timer->tick(4*cycles); 
+uint64_t gb_bus::next_observation(const uint16_t& first, const uint16_t& last)
+{
+    bool vram = first <= 0x9FFF && last >= 0x8000;
+    bool oam = first <= 0xFE9F && last >= 0xFE00;
+
+    // VRAM is read when a line is drawn, OAM when the objects of a line are
+    // picked, both happen at mode changes
+    if(oam || (vram && (video->read_LCDC() & 0x80))) return video->stable_until(0xFF41);
+
+    return gb_scheduler::NEVER;
+}
+uint64_t gb_bus::stable_until(const uint16_t& address)
+{
+    // work RAM and HRAM only change when the CPU writes them
+    if((0xC000 <= address && address <= 0xDFFF) || (0xFF80 <= address && address <= 0xFFFE)) 
+    {
+        return gb_scheduler::NEVER;
+    }
+
+    switch(address)
+    {
+        case 0xFF04: // DIV
+        case 0xFF05: // TIMA
+            return timer->stable_until(address);
+        case 0xFF41: // STAT
+        case 0xFF44: // LY
+            return video->stable_until(address);
+        case 0xFF0F: // IF, only raised from scheduler events
+            return scheduler->get_next_deadline();
+        default:
+            return scheduler->get_now();
+    }
 }
 void gb_bus::set_timer(const std::shared_ptr<gb_timer>& t)
 {
@@ -316,6 +332,64 @@ void gb_bus::set_timer(const std::shared_ptr<gb_timer>& t)
 void gb_bus::set_video(const std::shared_ptr<gb_ppu>& v)
 {
     video = v;
+
+    map_pages();
+}
+void gb_bus::map_pages()
+{
+    page_generation++;
+
+    read_pages.fill(nullptr);
+    write_pages.fill(nullptr);
+
+    map_cartridge_pages();
+
+    // VRAM writes have to let the PPU catch up first
+    if(video)
+    {
+        for(int page = 0x80; page <= 0x9F; ++page)
+        {
+            read_pages[page] = video->get_video_ram() + ((page - 0x80) << 8);
+        }
+    }
+
+    // WRAM and its echo
+    for(int page = 0xC0; page <= 0xFD; ++page)
+    {
+        uint8_t* ram = mem.main_ram + (((page - 0xC0) & 0x1F) << 8);
+
+        read_pages[page] = ram;
+        write_pages[page] = ram;
+    }
+}
+void gb_bus::map_cartridge_pages()
+{
+    if(!cartridge) return;
+
+    page_generation++;
+
+    // ROM is read only, writes go to the MBC
+    for(int page = 0x00; page <= 0x7F; ++page)
+    {
+        read_pages[page] = cartridge->rom_page(page << 8);
+    }
+
+    if(boot_rom_active)
+    {
+        read_pages[0x00] = bootDMG.data();
+    }
+
+    for(int page = 0xA0; page <= 0xBF; ++page)
+    {
+        uint8_t* ram = cartridge->ram_page(page << 8);
+
+        read_pages[page] = ram;
+        write_pages[page] = ram;
+    }
+}
+void gb_bus::set_scheduler(const std::shared_ptr<gb_scheduler>& s)
+{
+    scheduler = s;
 }
 void gb_bus::dma_transfer(uint8_t byte)
 {
@@ -323,13 +397,15 @@ void gb_bus::dma_transfer(uint8_t byte)
 
     //std::cout<<"DMA with "<<start_address<<'\n';
 
+    // the PPU catches up once for the whole copy instead of on every byte
+    video->sync();
+
     for (int i = 0; i < 160; ++i) 
     {
         uint16_t from_address = start_address + i;
-        uint16_t to_address = 0xFE00 + i;
 
         uint8_t value_at_address = bus_read(from_address);
 
-        bus_write(to_address, value_at_address);
+        mem.write_oam(i, value_at_address);
     }
 }
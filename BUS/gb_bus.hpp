@@ -1,22 +1,39 @@
 #ifndef _GB_BUS_
 #define _GB_BUS_
 
+#include <array>
+
 #include "../MEMORY/gb_memory.hpp"
 #include "../CARTRIDGE/gb_cartridge.hpp"
-#include "../CPU/cpu_sharpsm83.hpp"
 #include "../TIMER/gb_timer.hpp"
 #include "../VIDEO/gb_ppu.hpp"
+#include "../GAMEBOY/gb_scheduler.hpp"
 
-class sharpsm83;
+struct gb_bus;
 class gb_timer;
 class gb_ppu;
 
+// read/write callbacks of one I/O register in 0xFF00-0xFF7F or of IE (0xFFFF),
+// registered by the component that owns it
+struct gb_io_handler
+{
+    using read_function = uint8_t (*)(void* context, const uint16_t& address);
+    using write_function = void (*)(void* context, const uint16_t& address, const uint8_t& data);
+
+    read_function read = nullptr;    // nullptr reads 0xFF
+    write_function write = nullptr;  // nullptr ignores the write
+    void* context = nullptr;
+
+    uint8_t unused_bits = 0x00;      // always read back as 1
+    uint8_t writable_bits = 0xFF;    // the rest is masked off before write
+};
+
 struct gb_bus
 {
     std::shared_ptr<gb_cartridge> cartridge;
-    std::shared_ptr<sharpsm83> cpu;
     std::shared_ptr<gb_ppu>  video;
     std::shared_ptr<gb_timer> timer;
+    std::shared_ptr<gb_scheduler> scheduler;
 
     bool boot_rom_active = true;
 
@@ -25,15 +42,74 @@ struct gb_bus
     uint8_t serial_data = 0;     // SB (0xFF01)
     uint8_t serial_control = 0;  // SC (0xFF02)
 
-    uint8_t bus_read(const uint16_t& address);
-    void bus_write(const uint16_t& address, const uint8_t& data);
+    std::array<gb_io_handler, 0x80> io_handlers;
+    gb_io_handler interrupt_enable;
+
+    gb_bus();
+
+    void set_io_handler(const uint16_t& address, const gb_io_handler& handler);
+
+    // sets the bits of mask in IF, through the handler of whichever CPU
+    // registered it
+    void request_interrupt(uint8_t mask);
+
+    // serial, joypad, DMA, KEY1 and the boot ROM switch
+    static uint8_t read_io(void* context, const uint16_t& address);
+    static void write_io(void* context, const uint16_t& address, const uint8_t& data);
+
+    // host memory behind each 256 byte page, nullptr if the page has side
+    // effects (I/O, OAM, MBC registers, VRAM writes) and needs the slow path
+    std::array<const uint8_t*, 256> read_pages{};
+    std::array<uint8_t*, 256> write_pages{};
+
+    // bumped every time the page table is repointed
+    uint32_t page_generation = 0;
+
+    // HRAM (0xFF80-0xFFFE) for instruction fetches, page 0xFF stays out of
+    // the page table for the I/O registers
+    const uint8_t* get_hram() const { return mem.hram; }
+
+    uint8_t bus_read(const uint16_t& address)
+    {
+        const uint8_t* page = read_pages[address >> 8];
+
+        return page ? page[address & 0xFF] : read_slow(address);
+    }
+    void bus_write(const uint16_t& address, const uint8_t& data)
+    {
+        uint8_t* page = write_pages[address >> 8];
+
+        if(page) page[address & 0xFF] = data;
+        else write_slow(address, data);
+    }
+
+    uint8_t read_slow(const uint16_t& address);
+    void write_slow(const uint16_t& address, const uint8_t& data);
+
+    // repoint the page table after a bank switch or the boot ROM unmap
+    void map_pages();
+    void map_cartridge_pages();
 
     void set_cartridge(const std::shared_ptr<gb_cartridge>& c);
-    void set_cpu(const std::shared_ptr<sharpsm83>& c);
     void set_timer(const std::shared_ptr<gb_timer>& t);
     void set_video(const std::shared_ptr<gb_ppu>& v);
+    void set_scheduler(const std::shared_ptr<gb_scheduler>& s);
+
+    void tick(int cycles)
+    {
+        // the PPU and the timer run from their scheduler deadlines
+        scheduler->advance(4*cycles);
+    }
+
+    // first T-cycle at which a read of address may return something else,
+    // as long as the CPU does not write to it
+    uint64_t stable_until(const uint16_t& address);
+
+    // true if only memory sits behind [first, last], no registers
+    bool is_plain_memory(const uint16_t& first, const uint16_t& last, bool write);
 
-    void tick(int cycles);
+    // first T-cycle at which the PPU may look at [first, last]
+    uint64_t next_observation(const uint16_t& first, const uint16_t& last);
 
     void dma_transfer(uint8_t byte);
 };
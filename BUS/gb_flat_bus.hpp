@@ -0,0 +1,70 @@
+#ifndef _GB_FLAT_BUS_
+#define _GB_FLAT_BUS_
+
+#include <cstdint>
+#include <array>
+#include <memory>
+
+#include "../CARTRIDGE/gb_cartridge.hpp"
+#include "../GAMEBOY/gb_scheduler.hpp"
+#include "../CPU/cpu_sharpsm83.hpp"
+
+// 64KB of plain memory behind the whole address space, for running the CPU
+// alone (benchmarks, fuzzing). 0x0000-0x7FFF is ROM, filled through memory
+// and ignoring CPU writes like a cartridge without MBC, the rest is RAM.
+// There is no I/O: IE, IF and the registers are plain bytes, so nothing
+// raises an interrupt and a HALT only gives up after MAX_HALT_SKIP.
+struct gb_flat_bus
+{
+    std::array<uint8_t, 0x10000> memory{};
+
+    // what basic_sharpsm83 looks at on a bus, with nothing behind it
+    std::shared_ptr<gb_cartridge> cartridge;
+    std::shared_ptr<gb_scheduler> scheduler = std::make_shared<gb_scheduler>();
+    bool boot_rom_active = false;
+
+    // every page is memory, and stays where it is
+    std::array<const uint8_t*, 256> read_pages;
+    uint32_t page_generation = 0;
+
+    const uint8_t* get_hram() const { return &memory[0xFF80]; }
+
+    gb_flat_bus()
+    {
+        for(uint32_t page = 0; page < read_pages.size(); ++page)
+        {
+            read_pages[page] = &memory[page << 8];
+        }
+    }
+
+    gb_flat_bus(const gb_flat_bus&) = delete;
+    gb_flat_bus& operator=(const gb_flat_bus&) = delete;
+
+    uint8_t bus_read(const uint16_t& address)
+    {
+        return memory[address];
+    }
+    void bus_write(const uint16_t& address, const uint8_t& data)
+    {
+        if(address >= 0x8000) memory[address] = data;
+    }
+
+    // the CPU registers IF and IE here, they stay memory bytes
+    void set_io_handler(const uint16_t&, const gb_io_handler&) {}
+
+    void tick(int cycles)
+    {
+        scheduler->advance(4*cycles);
+    }
+
+    // memory only changes when the CPU writes it, and nothing looks at it
+    uint64_t stable_until(const uint16_t&) { return gb_scheduler::NEVER; }
+    bool is_plain_memory(const uint16_t&, const uint16_t&, bool) { return true; }
+    uint64_t next_observation(const uint16_t&, const uint16_t&) { return gb_scheduler::NEVER; }
+};
+
+using flat_sharpsm83 = basic_sharpsm83<gb_flat_bus, sm83_exact_timing>;
+
+extern template struct basic_sharpsm83<gb_flat_bus, sm83_exact_timing>;
+
+#endif
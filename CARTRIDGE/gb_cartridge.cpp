@@ -43,7 +43,8 @@ gb_cartridge::gb_cartridge(std::vector<uint8_t>& rom)
 
     load_info();
 
-    ram.resize(info.ram_size);
+    auto ram_size = gb_ram_size_bytes.find(info.ram_size);
+    ram.resize(ram_size != gb_ram_size_bytes.end() ? ram_size->second : 0);
 
     print_info();
 }
@@ -203,6 +204,31 @@ void gb_cartridge::print_info()
     std::cout<<"Global checksum: 0x"<<std::hex<<static_cast<int>(info.global_checksum)<<'\n';
 }
 
+uint32_t gb_cartridge::get_rom_bank() const
+{
+    return rom_bank;
+}
+
+const std::vector<uint8_t>& gb_cartridge::get_data() const
+{
+    return raw_data;
+}
+
+const cartridge_info& gb_cartridge::get_info() const
+{
+    return info;
+}
+
+const uint8_t* gb_cartridge::rom_page(const uint16_t&)
+{
+    return nullptr;
+}
+
+uint8_t* gb_cartridge::ram_page(const uint16_t&)
+{
+    return nullptr;
+}
+
 no_mbc::no_mbc(std::vector<uint8_t>& rom) : gb_cartridge(rom)
 {
     std::cout<<"No mbc cartridge!"<<'\n';
@@ -218,6 +244,13 @@ void no_mbc::write(const uint16_t& address, const uint8_t& data)
     //std::cout<<"[CARTRIDGE] No MBC write!"<<'\n';
 }
 
+const uint8_t* no_mbc::rom_page(const uint16_t& address)
+{
+    uint32_t offset = address & 0xFF00;
+
+    return offset + 0x100 <= raw_data.size() ? &raw_data[offset] : nullptr;
+}
+
 mbc1::mbc1(std::vector<uint8_t>& rom) : gb_cartridge(rom)
 {
     std::cout<<"MBC1 cartridge!"<<'\n';
@@ -233,12 +266,16 @@ void mbc1::write(const uint16_t& address, const uint8_t& data)
         rom_bank_low = data & 0x1F;
 
         if(rom_bank_low == 0x0) rom_bank_low = 0x1;
+
+        rom_bank = (rom_bank_high << 5) | rom_bank_low;
     }
     else if(address < 0x6000)
     {
         // either the high bits of rom or the ram depending on the mode
         rom_bank_high = data & 0x03;
         ram_bank = data & 0x03;
+
+        rom_bank = (rom_bank_high << 5) | (rom_bank_low == 0 ? 0x1 : rom_bank_low);
     }
     else if(address < 0x8000)
     {
@@ -250,7 +287,7 @@ void mbc1::write(const uint16_t& address, const uint8_t& data)
         
         uint32_t bank = (mode == 0) ? 0 : ram_bank;
         uint32_t offset = bank * 0x2000 + (address - 0xA000);
-        ram[offset] = data;
+        if (offset < ram.size()) ram[offset] = data;
     }
 }
 
@@ -262,11 +299,8 @@ uint8_t mbc1::read(const uint16_t& address)
     }
     else if (address < 0x8000) 
     {
-        // Switchable bank
-        if (rom_bank_low == 0) rom_bank_low = 0x1; // hardware quirk: bank 0 -> 1
-        uint32_t bank = (rom_bank_high << 5) | rom_bank_low;
-        
-        uint32_t offset = bank * 0x4000 + (address - 0x4000);
+        // Switchable bank, kept up to date by write()
+        uint32_t offset = rom_bank * 0x4000 + (address - 0x4000);
 
         return raw_data[offset];
     }
@@ -276,9 +310,31 @@ uint8_t mbc1::read(const uint16_t& address)
         
         uint32_t bank = (mode == 0) ? 0 : ram_bank;
         uint32_t offset = bank * 0x2000 + (address - 0xA000);
-        return ram[offset];
+        return offset < ram.size() ? ram[offset] : 0xFF;
     }
     
     return 0xFF;
 }
 
+
+const uint8_t* mbc1::rom_page(const uint16_t& address)
+{
+    uint32_t offset = address & 0xFF00;
+
+    if (offset >= 0x4000)
+    {
+        offset = rom_bank * 0x4000 + (offset - 0x4000);
+    }
+
+    return offset + 0x100 <= raw_data.size() ? &raw_data[offset] : nullptr;
+}
+
+uint8_t* mbc1::ram_page(const uint16_t& address)
+{
+    if (!ram_enabled) return nullptr;
+
+    uint32_t bank = (mode == 0) ? 0 : ram_bank;
+    uint32_t offset = bank * 0x2000 + ((address & 0xFF00) - 0xA000);
+
+    return offset + 0x100 <= ram.size() ? &ram[offset] : nullptr;
+}
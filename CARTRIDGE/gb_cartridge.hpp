@@ -169,6 +169,15 @@ inline const std::map<uint8_t, std::string> gb_ram_sizes = {
     {0x05, "64 KiB (8 banks of 8 KiB each)"}
 };
 
+inline const std::map<uint8_t, uint32_t> gb_ram_size_bytes = {
+    {0x00, 0},
+    {0x01, 0},
+    {0x02, 8 * 1024},
+    {0x03, 32 * 1024},
+    {0x04, 128 * 1024},
+    {0x05, 64 * 1024}
+};
+
 inline const std::map<uint8_t, std::string> gb_destination_codes = {
     {0x00, "Japan (and possibly overseas)"},
     {0x01, "Overseas only"}
@@ -357,6 +366,9 @@ protected:
 
     cartridge_info info;
 
+    // ROM bank currently mapped at 0x4000-0x7FFF
+    uint32_t rom_bank = 1;
+
     void load_info();
 public:
     gb_cartridge(std::vector<uint8_t>& rom);
@@ -364,8 +376,19 @@ public:
 
     void print_info();
 
+    uint32_t get_rom_bank() const;
+
+    // the ROM image as it was loaded
+    const std::vector<uint8_t>& get_data() const;
+    const cartridge_info& get_info() const;
+
     virtual uint8_t read(const uint16_t& address) = 0;
     virtual void write(const uint16_t& address, const uint8_t& data) = 0;
+
+    // host memory currently mapped at the 256 byte page of address,
+    // nullptr if the page has to go through read()/write()
+    virtual const uint8_t* rom_page(const uint16_t& address);
+    virtual uint8_t* ram_page(const uint16_t& address);
 };
 
 class no_mbc : public gb_cartridge{
@@ -374,6 +397,8 @@ public:
 
     uint8_t read(const uint16_t& address) override;
     void write(const uint16_t& address, const uint8_t& data) override;
+
+    const uint8_t* rom_page(const uint16_t& address) override;
 };
 
 class mbc1 : public gb_cartridge{
@@ -389,6 +414,9 @@ public:
 
     uint8_t read(const uint16_t& address) override;
     void write(const uint16_t& address, const uint8_t& data) override;
+
+    const uint8_t* rom_page(const uint16_t& address) override;
+    uint8_t* ram_page(const uint16_t& address) override;
 };
 
 std::shared_ptr<gb_cartridge> load_and_construct_cartridge(const std::string& path);
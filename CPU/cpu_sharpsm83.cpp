@@ -1,29 +1,41 @@
 #include<iostream>
 #include "cpu_sharpsm83.hpp"
+#include "../BUS/gb_flat_bus.hpp"
 #include "opcode_to_string.hpp"
+#include "sm83_opcode_list.hpp"
+
+// CPU_LAZY_FLAGS records the last ALU operation and computes F when it is read,
+// CPU_VERIFY_FLAGS keeps the eager writes as well and checks one against the other
+#if !defined(CPU_LAZY_FLAGS) || defined(CPU_VERIFY_FLAGS)
+#define CPU_EAGER_FLAGS
+#endif
 
 //##############################################################################
-sharpsm83::sharpsm83()
-{
-    initialize_opcodes();
-    initialize_cbopcodes();
-}
+template<typename bus_type, typename timing_policy>
+basic_sharpsm83<bus_type, timing_policy>::basic_sharpsm83() = default;
 //##############################################################################
-sharpsm83::~sharpsm83() = default;
+template<typename bus_type, typename timing_policy>
+basic_sharpsm83<bus_type, timing_policy>::~basic_sharpsm83() = default;
 //##############################################################################
-void sharpsm83::set_bus(const std::shared_ptr<gb_bus>& b)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_bus(const std::shared_ptr<bus_type>& b)
 {
     bus = b;
+
+    bus->set_io_handler(0xFF0F, {&basic_sharpsm83::read_IF, &basic_sharpsm83::write_IF, this, 0xE0});
+    bus->set_io_handler(0xFFFF, {&basic_sharpsm83::read_IE, &basic_sharpsm83::write_IE, this});
 }
 //##############################################################################
-void sharpsm83::enable_interrupts()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::enable_interrupts()
 {
-    //std::cout<<"0x"<<std::hex<<(int)PC.b0_15<<": Pending enable interrupts!"<<'\n';
+    //std::cout<<"0x"<<std::hex<<(int)regs.PC<<": Pending enable interrupts!"<<'\n';
     ei_pending = true;
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::disable_interrupts()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::disable_interrupts()
 {
     //std::cout<<"Disable interrupts!"<<'\n';
 
@@ -31,55 +43,181 @@ void sharpsm83::disable_interrupts()
     emulate_cycles(1);
 }
 //##############################################################################
-bool sharpsm83::get_zero_flag()
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::get_zero_flag()
 {
+    materialize_flags();
+
     // z flag
-    return AF.Lo.b7;
+    return regs.F & FLAG_Z;
 }
 //##############################################################################
-void sharpsm83::set_zero_flag(bool val)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_zero_flag(bool val)
 {
+    materialize_flags();
+
     // z flag
-    AF.Lo.b7 = val;
+    regs.F = val ? (regs.F | FLAG_Z) : (regs.F & ~FLAG_Z);
 }
 //##############################################################################
-bool sharpsm83::get_subtraction_flag()
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::get_subtraction_flag()
 {
+    materialize_flags();
+
     // n flag
-    return AF.Lo.b6;
+    return regs.F & FLAG_N;
 }
 //##############################################################################
-void sharpsm83::set_subtraction_flag(bool val)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_subtraction_flag(bool val)
 {
+    materialize_flags();
+
     // n flag
-    AF.Lo.b6 = val;
+    regs.F = val ? (regs.F | FLAG_N) : (regs.F & ~FLAG_N);
 }
 //##############################################################################
-bool sharpsm83::get_half_carry_flag()
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::get_half_carry_flag()
 {
+    materialize_flags();
+
     // h flag
-    return AF.Lo.b5;
+    return regs.F & FLAG_H;
 }
 //##############################################################################
-void sharpsm83::set_half_carry_flag(bool val)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_half_carry_flag(bool val)
 {
+    materialize_flags();
+
     // h flag
-    AF.Lo.b5 = val;
+    regs.F = val ? (regs.F | FLAG_H) : (regs.F & ~FLAG_H);
 }
 //##############################################################################
-bool sharpsm83::get_carry_flag()
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::get_carry_flag()
 {
+    materialize_flags();
+
     // c or Cy flag
-    return AF.Lo.b4;
+    return regs.F & FLAG_C;
 }
 //##############################################################################
-void sharpsm83::set_carry_flag(bool val)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_carry_flag(bool val)
 {
+    materialize_flags();
+
     // c or Cy flag
-    AF.Lo.b4 = val;
+    regs.F = val ? (regs.F | FLAG_C) : (regs.F & ~FLAG_C);
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::record_flags(flag_op op, uint8_t lhs, uint8_t rhs, bool carry)
+{
+    pending_flags = op;
+    flag_lhs = lhs;
+    flag_rhs = rhs;
+    flag_carry = carry;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+uint8_t basic_sharpsm83<bus_type, timing_policy>::evaluate_flags()
+{
+    uint8_t lhs = flag_lhs;
+    uint8_t rhs = flag_rhs;
+    int carry = flag_carry;
+
+    bool z = false, n = false, h = false, c = false;
+
+    switch(pending_flags)
+    {
+        case flag_op::NONE:
+            return regs.F & 0xF0;
+        case flag_op::ADD:
+            z = ((lhs + rhs + carry) & 0xFF) == 0;
+            h = ((lhs & 0xF) + (rhs & 0xF) + carry) > 0xF;
+            c = (lhs + rhs + carry) > 0xFF;
+            break;
+        case flag_op::SUB:
+            z = ((lhs - rhs - carry) & 0xFF) == 0;
+            n = true;
+            h = ((lhs & 0xF) - (rhs & 0xF) - carry) < 0;
+            c = (lhs - rhs - carry) < 0;
+            break;
+        case flag_op::AND:
+            z = lhs == 0;
+            h = true;
+            break;
+        case flag_op::OR:
+        case flag_op::XOR:
+            z = lhs == 0;
+            break;
+        case flag_op::INC:
+            z = lhs == 0xFF;
+            h = (lhs & 0xF) == 0xF;
+            c = carry;
+            break;
+        case flag_op::DEC:
+            z = lhs == 0x01;
+            n = true;
+            h = (lhs & 0xF) == 0;
+            c = carry;
+            break;
+    }
+
+    return (z << 7) | (n << 6) | (h << 5) | (c << 4);
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::materialize_flags()
+{
+#if defined(CPU_LAZY_FLAGS) && !defined(CPU_VERIFY_FLAGS)
+    if(pending_flags != flag_op::NONE)
+    {
+        regs.F = evaluate_flags();
+        pending_flags = flag_op::NONE;
+    }
+#endif
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::pending_carry()
+{
+    switch(pending_flags)
+    {
+        case flag_op::NONE: return regs.F & FLAG_C;
+        case flag_op::ADD: return (flag_lhs + flag_rhs + flag_carry) > 0xFF;
+        case flag_op::SUB: return (flag_lhs - flag_rhs - flag_carry) < 0;
+        case flag_op::INC:
+        case flag_op::DEC: return flag_carry;
+        default: return false;
+    }
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::verify_flags()
+{
+    if(pending_flags == flag_op::NONE) return;
+
+    uint8_t lazy = evaluate_flags();
+
+    if(lazy != (regs.F & 0xF0))
+    {
+        std::cout<<"0x"<<std::hex<<(int)regs.PC<<": lazy flags 0x"<<(int)lazy<<" != 0x"<<(int)(regs.F & 0xF0)
+            <<" (op "<<std::dec<<(int)pending_flags<<", 0x"<<std::hex
+            <<(int)flag_lhs<<", 0x"<<(int)flag_rhs<<", carry "<<flag_carry<<")"<<'\n';
+        exit(-1);
+    }
+
+    pending_flags = flag_op::NONE;
 }
 //##############################################################################
-void sharpsm83::set_carry_flag()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_carry_flag()
 {
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
@@ -89,7 +227,8 @@ void sharpsm83::set_carry_flag()
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::complement_carry_flag()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::complement_carry_flag()
 {
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
@@ -99,17 +238,498 @@ void sharpsm83::complement_carry_flag()
     emulate_cycles(1);
 }
 //##############################################################################
-uint8_t sharpsm83::fetch_data()
+template<typename bus_type, typename timing_policy>
+uint8_t basic_sharpsm83<bus_type, timing_policy>::fetch_data()
 {  
-    return halt_bug ? bus->bus_read(PC.b0_15) : bus->bus_read(PC.b0_15++); 
+    if(decoded_operand)
+    {
+        regs.PC++;
+        return *decoded_operand++;
+    }
+
+    uint16_t address = regs.PC;
+
+    uint16_t offset = address - fetch_first;
+
+    if(fetch_window && offset <= fetch_span && fetch_page_generation == bus->page_generation)
+    {
+        regs.PC++;
+        return fetch_window[offset];
+    }
+
+    return fetch_data_slow();
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+uint8_t basic_sharpsm83<bus_type, timing_policy>::fetch_data_slow()
+{
+    if(halt_bug) 
+    {
+        fetch_window = nullptr;
+        return bus->bus_read(regs.PC);
+    }
+
+    // page crossing, jump or bank switch
+    fetch_first = regs.PC & 0xFF00;
+    fetch_span = 0xFF;
+    fetch_window = bus->read_pages[regs.PC >> 8];
+    fetch_page_generation = bus->page_generation;
+
+    // HRAM writes land in the same bytes, code copied there (the OAM DMA
+    // wait loop) is fetched like the rest
+    if(!fetch_window && regs.PC >= 0xFF80 && regs.PC <= 0xFFFE)
+    {
+        fetch_first = 0xFF80;
+        fetch_span = 0x7E;
+        fetch_window = bus->get_hram();
+    }
+
+    return bus->bus_read(regs.PC++); 
 }
 //##############################################################################
-void sharpsm83::write_data(const uint16_t& address, const uint8_t& data)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::write_data(const uint16_t& address, const uint8_t& data)
 {
     bus->bus_write(address, data);
+
+    if(address < 0x8000)
+    {
+        // MBC register write, the banked code may have changed under us
+        current_block = nullptr;
+        block_cache.unlink_all();
+    }
+    else if((address < 0xFF00 || address >= 0xFF80) && block_cache.is_code(address))
+    {
+        block_cache.invalidate(address);
+        current_block = nullptr;
+    }
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::is_cacheable(const uint16_t& address)
+{
+    // ROM, except the boot ROM overlay
+    if(address < 0x8000) return !(bus->boot_rom_active && address <= 0xFF);
+
+    // WRAM and its echo
+    if(0xC000 <= address && address <= 0xFDFF) return true;
+
+    // HRAM
+    return 0xFF80 <= address && address <= 0xFFFE;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+const sm83_decoded_instr* basic_sharpsm83<bus_type, timing_policy>::next_decoded_instruction()
+{
+    uint16_t address = regs.PC;
+
+    if(current_block && current_block_index < current_block->instructions.size() &&
+       current_block->instructions[current_block_index].address == address)
+    {
+        return &current_block->instructions[current_block_index++];
+    }
+
+    const sm83_block* previous = current_block;
+
+    current_block = nullptr;
+
+    if(!is_cacheable(address)) return nullptr;
+
+    // where the last block went, without hashing
+    const sm83_block* block = previous ? block_cache.find_successor(*previous, address) : nullptr;
+
+    if(!block)
+    {
+        uint32_t rom_bank = bus->cartridge ? bus->cartridge->get_rom_bank() : 1;
+        uint32_t key = sm83_block_cache::make_key(address, rom_bank);
+
+        block = block_cache.find(key);
+        if(!block)
+        {
+            block = decode_block(address, key);
+        }
+
+        if(!block) return nullptr;
+
+        if(previous) block_cache.link(*previous, address, block);
+    }
+
+    current_block = block;
+    current_block_index = 1;
+
+    return &block->instructions[0];
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+const sm83_block* basic_sharpsm83<bus_type, timing_policy>::decode_block(const uint16_t& address, uint32_t key)
+{
+    sm83_block block = sm83_block_cache::decode(address,
+        [this](uint16_t pc) { return bus->bus_read(pc); },
+        [this](uint16_t pc) { return is_cacheable(pc); });
+
+    if(block.instructions.empty()) return nullptr;
+
+    // pairs don't overlap, the second half of one can't start another
+    for(std::size_t i = 0; i + 1 < block.instructions.size(); ++i)
+    {
+        sm83_decoded_instr& first = block.instructions[i];
+
+        first.fusion = sm83_fusion::match(first.opcode, block.instructions[i + 1].opcode);
+
+        if(first.fusion) ++i;
+    }
+
+    block.idle_poll_address = sm83_idle_loop_detector::find_polled_address(block);
+    block.idiom = sm83_loop_idiom::match(block);
+
+#ifdef CPU_AOT
+    if(aot.is_loaded())
+    {
+        block.aot_code = aot.find(key, block.instructions.size());
+    }
+#endif
+
+    return block_cache.insert(key, address, std::move(block));
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::execute_decoded(const sm83_decoded_instr& instr)
+{
+    // the block may be invalidated by the instruction itself
+    decoded_operands = instr.operands;
+    decoded_operand = decoded_operands.data();
+
+    regs.PC++;
+
+    // straight to the handler, the second byte of 0xCB is already decoded
+    if(instr.opcode == 0xCB)
+    {
+        regs.PC++;
+        decoded_operand++;
+        emulate_cycles(1);
+
+        execute_0xCB_instruction(instr.operands[0]);
+    }
+    else
+    {
+        execute_normal_instruction(instr.opcode);
+    }
+
+    decoded_operand = nullptr;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::run_decoded(const sm83_decoded_instr* instr)
+{
+    unsigned long int start = cycle_count;
+
+    for(;;)
+    {
+        if(instr->fusion && fusion_enabled)
+        {
+            (this->*fused_table[instr->fusion])(*instr);
+        }
+        else
+        {
+            execute_decoded(*instr);
+        }
+
+        finish_instruction();
+
+        if(!current_block) return;
+
+        if(current_block_index < current_block->instructions.size())
+        {
+            instr = &current_block->instructions[current_block_index];
+
+            if(!continues_at(instr->address)) return;
+
+            current_block_index++;
+            continue;
+        }
+
+        // on into the block this one is linked to, unless tick() has to
+        // look at it first
+        if(cycle_count - start >= MAX_CHAIN_CYCLES) return;
+
+#ifdef CPU_JIT
+        // tick() counts the entries towards jit_threshold
+        if(jit_enabled) return;
+#endif
+
+        const sm83_block* next = block_cache.find_successor(*current_block, regs.PC);
+
+        if(!next || !enters_plainly(*next) || !continues_at(regs.PC)) return;
+
+        idle_loops.disarm();
+
+        current_block = next;
+        current_block_index = 1;
+        instr = &next->instructions[0];
+    }
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::enters_plainly(const sm83_block& block)
+{
+    if(block.idle_poll_address && idle_loop_skip_enabled) return false;
+    if(block.idiom.kind != sm83_loop_idiom::loop_kind::NONE && loop_idioms_enabled) return false;
+
+#ifdef CPU_AOT
+    if(block.aot_code && aot_enabled) return false;
+#endif
+
+    return true;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::block_continues(const sm83_decoded_instr& instr, std::size_t index)
+{
+    // the block was invalidated or its bank switched out by the previous
+    // instruction
+    if(!current_block) return false;
+
+    // the first instruction is entered from tick(), which already did these
+    if(index == 0) return true;
+
+    return continues_at(instr.address);
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::continues_at(uint16_t address)
+{
+    if(exit_on_infinite_jr || is_halted || halt_bug) return false;
+
+    if(regs.PC != address) return false;
+
+    // let tick() service the interrupt
+    return !(interrupts_enabled && interrupt_pending);
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+template<uint8_t opcode>
+void basic_sharpsm83<bus_type, timing_policy>::normal_instruction()
+{
+    #define SM83_SWITCH_CASE(opcode, handler) case opcode: handler(); break;
+
+    switch(opcode)
+    {
+        SM83_OPCODES(SM83_SWITCH_CASE)
+    }
+
+    #undef SM83_SWITCH_CASE
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+template<uint8_t first, uint8_t second>
+void basic_sharpsm83<bus_type, timing_policy>::fused_instruction(const sm83_decoded_instr& instr)
+{
+    // a write to a code page can free the block, and instr with it
+    const sm83_block* block = current_block;
+    uint8_t fusion = instr.fusion;
+    std::array<uint8_t, 2> second_operands = (&instr)[1].operands;
+
+    decoded_operands = instr.operands;
+    decoded_operand = decoded_operands.data();
+    regs.PC++;
+
+    normal_instruction<first>();
+
+    decoded_operand = nullptr;
+
+    // the instruction boundary tick() would have gone through
+    finish_instruction();
+
+    if(current_block != block || exit_on_infinite_jr) return;
+    if(interrupts_enabled && interrupt_pending) return;
+
+    current_block_index++;
+
+    decoded_operands = second_operands;
+    decoded_operand = decoded_operands.data();
+    regs.PC++;
+
+    normal_instruction<second>();
+
+    decoded_operand = nullptr;
+
+    fusion_stats.hits[fusion]++;
+}
+//##############################################################################
+#define SM83_FUSED_ENTRY(first, second, name) &basic_sharpsm83::fused_instruction<first, second>,
+
+template<typename bus_type, typename timing_policy>
+constexpr std::array<typename basic_sharpsm83<bus_type, timing_policy>::fused_handler, sm83_fusion::COUNT + 1> basic_sharpsm83<bus_type, timing_policy>::fused_table =
+{
+    nullptr,
+    SM83_FUSED_PAIRS(SM83_FUSED_ENTRY)
+};
+
+#undef SM83_FUSED_ENTRY
+#ifdef CPU_JIT
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::execute_jit_block()
+{
+    if constexpr(!runs_native_code)
+    {
+        return false;
+    }
+    else
+    {
+        const sm83_block* block = current_block;
+
+        // EI takes effect in finish_instruction, which native code doesn't run
+        if(ei_scheduled) return false;
+
+        // the same bytes decoded again, e.g. after a write next to them
+        if(!block->native_code && block->executions++ == 0)
+        {
+            block->native_code = jit.find(*block);
+        }
+
+        if(!block->native_code)
+        {
+            if(block->executions < jit_threshold) return false;
+
+            sm83_jit_context context;
+            context.cpu = this;
+            context.regs = &regs;
+            context.cycle_count = &cycle_count;
+            context.block_index = &current_block_index;
+            context.read_pages = bus->read_pages.data();
+            context.write_pages = bus->write_pages.data();
+            context.code_pages = block_cache.get_code_pages();
+            context.scheduler = bus->scheduler.get();
+            context.step = &basic_sharpsm83::jit_step;
+            context.sync = &basic_sharpsm83::jit_sync;
+
+            block->native_code = jit.compile(*block, context);
+
+            if(!block->native_code)
+            {
+                // make room from the code of blocks that were dropped
+                jit.reclaim([this](uint32_t key, sm83_native_code code)
+                {
+                    const sm83_block* live = block_cache.get(key);
+
+                    return live && live->native_code == code;
+                });
+
+                block->native_code = jit.compile(*block, context);
+            }
+
+            if(!block->native_code)
+            {
+                // the arena is full, drop every block along with its code
+                jit.reset();
+                block_cache.clear();
+                current_block = nullptr;
+                idle_loops.disarm();
+
+                return false;
+            }
+        }
+
+        unsigned long int start = cycle_count;
+
+        for(;;)
+        {
+            // native code computes F from the host flags
+            materialize_flags();
+
+            block->native_code(this);
+
+            // on into the block it went to if that one is compiled as well,
+            // with the checks tick() would do in between
+            if(!current_block || current_block_index < block->instructions.size()) return true;
+            if(cycle_count - start >= MAX_CHAIN_CYCLES || ei_scheduled || !continues_at(regs.PC)) return true;
+
+            const sm83_block* next = block_cache.find_successor(*block, regs.PC);
+
+            if(!next || !next->native_code || !enters_plainly(*next)) return true;
+
+            idle_loops.disarm();
+
+            current_block = block = next;
+            current_block_index = 1;
+        }
+    }
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::jit_step(basic_sharpsm83* cpu, std::size_t index)
+{
+    const sm83_decoded_instr& instr = cpu->current_block->instructions[index];
+
+    // the instruction may drop the block, and instr with it
+    uint16_t next = instr.address + instr.length;
+
+    cpu->execute_decoded(instr);
+    cpu->finish_instruction();
+    cpu->materialize_flags();
+
+    // the block was invalidated or its bank switched out
+    if(!cpu->current_block) return false;
+
+    // EI, the next instruction has to go through finish_instruction
+    return !cpu->ei_scheduled && cpu->continues_at(next);
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::jit_sync(basic_sharpsm83* cpu)
+{
+    // the clock is already there, this only runs the events
+    cpu->bus->tick(0);
+
+    return !(cpu->interrupts_enabled && cpu->interrupt_pending);
+}
+#endif
+#ifdef CPU_AOT
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+template<uint8_t opcode>
+bool basic_sharpsm83<bus_type, timing_policy>::aot_step(basic_sharpsm83* cpu, const sm83_decoded_instr* instr, uint8_t index)
+{
+    // instr is the module's copy, the block itself stays in the cache
+    if(!cpu->block_continues(*instr, index)) return false;
+
+    cpu->current_block_index = index + 1;
+
+    cpu->decoded_operands = instr->operands;
+    cpu->decoded_operand = cpu->decoded_operands.data();
+    cpu->regs.PC++;
+
+    // the 0xCB table entry is empty, execute() runs the second byte
+    if constexpr(opcode == 0xCB)
+    {
+        cpu->execute(opcode);
+    }
+    else
+    {
+        cpu->template normal_instruction<opcode>();
+    }
+
+    cpu->decoded_operand = nullptr;
+
+    cpu->finish_instruction();
+
+    return true;
 }
 //##############################################################################
-int sharpsm83::tick()
+#define SM83_AOT_STEP_ENTRY(opcode, handler) &basic_sharpsm83::aot_step<opcode>,
+
+template<typename bus_type, typename timing_policy>
+constexpr typename basic_sharpsm83<bus_type, timing_policy>::aot_step_table basic_sharpsm83<bus_type, timing_policy>::aot_steps =
+{
+    SM83_OPCODES(SM83_AOT_STEP_ENTRY)
+};
+
+#undef SM83_AOT_STEP_ENTRY
+#endif
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+int basic_sharpsm83<bus_type, timing_policy>::tick()
 {
     long int before = cycle_count;
 
@@ -117,20 +737,97 @@ int sharpsm83::tick()
 
     if(is_halted)
     {
-        emulate_cycles(1);
-        return 1;
+        // nothing can raise an interrupt before the next deadline, jump to it
+        int cycles = halt_skip_cycles();
+
+        emulate_cycles(cycles);
+        sync_cycles();
+        return cycles;
     }
 
-    uint8_t opcode = fetch_data();
+    const sm83_decoded_instr* instr = nullptr;
 
-    if (halt_bug) 
+    if(block_cache_enabled && !halt_bug)
     {
-        halt_bug = false;
-        execute(opcode);
-    } 
-    else 
+        instr = next_decoded_instruction();
+    }
+
+    // a block entered at its start
+    if(instr && current_block_index == 1)
+    {
+        int cycles = 0;
+
+        if(current_block->idle_poll_address && idle_loop_skip_enabled)
+        {
+            cycles = skip_idle_loop();
+        }
+        else
+        {
+            idle_loops.disarm();
+
+            if(current_block->idiom.kind != sm83_loop_idiom::loop_kind::NONE && loop_idioms_enabled)
+            {
+                cycles = run_loop_idiom();
+            }
+        }
+
+        if(cycles)
+        {
+            // the loop goes on from its start once that time has passed
+            current_block = nullptr;
+
+            emulate_cycles(cycles);
+            sync_cycles();
+            return cycles;
+        }
+    }
+
+#ifdef CPU_AOT
+    if constexpr(runs_native_code)
+    {
+        if(instr && aot_enabled && current_block_index == 1 && current_block->aot_code)
+        {
+            current_block->aot_code(this);
+
+            return exit_on_infinite_jr ? -1 : cycle_count - before;
+        }
+    }
+#endif
+
+#ifdef CPU_JIT
+    if(instr && jit_enabled && current_block_index == 1)
+    {
+        if(execute_jit_block())
+        {
+            // every instruction of the block has already been finished
+            return exit_on_infinite_jr ? -1 : cycle_count - before;
+        }
+
+        // the caches were flushed to make room in the arena
+        if(!current_block) instr = nullptr;
+    }
+#endif
+
+    if(instr)
     {
-        execute(opcode);
+        // the rest of the block runs here too, finishing every instruction
+        run_decoded(instr);
+
+        return exit_on_infinite_jr ? -1 : cycle_count - before;
+    }
+    else
+    {
+        uint8_t opcode = fetch_data();
+
+        if (halt_bug) 
+        {
+            halt_bug = false;
+            execute(opcode);
+        } 
+        else 
+        {
+            execute(opcode);
+        }
     }
 
     long int after = cycle_count;
@@ -145,61 +842,68 @@ int sharpsm83::tick()
     return after - before;
 }
 //##############################################################################
-void sharpsm83::execute(uint8_t opcode) 
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::execute(uint8_t opcode) 
 {
     if(opcode == 0xCB)
     {
         opcode = fetch_data();
         emulate_cycles(1);
 
-        //std::cout<<"->"<<std::hex<<static_cast<int>(PC.b0_15)<<": "<<cbOpcodeTable[opcode]<<" ["<<"$CB"<<std::hex<<static_cast<int>(opcode)<<']'<<'\n';
+        //std::cout<<"->"<<std::hex<<static_cast<int>(regs.PC)<<": "<<cbOpcodeTable[opcode]<<" ["<<"$CB"<<std::hex<<static_cast<int>(opcode)<<']'<<'\n';
 
         execute_0xCB_instruction(opcode);
     }
     else
     {   
-        //std::cout<<"->"<<std::hex<<static_cast<int>(PC.b0_15)<<": "<<opcodeTable[opcode]<<" ["<<std::hex<<static_cast<int>(opcode)<<']'<<'\n';
+        //std::cout<<"->"<<std::hex<<static_cast<int>(regs.PC)<<": "<<opcodeTable[opcode]<<" ["<<std::hex<<static_cast<int>(opcode)<<']'<<'\n';
 
         execute_normal_instruction(opcode);
     }
 }
 //##############################################################################
-void sharpsm83::execute_normal_instruction(uint8_t opcode)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::execute_normal_instruction(uint8_t opcode)
 {
-    if(opcode_table[opcode])
-    {
-        opcode_table[opcode]();
-    }
-    else
+#ifdef CPU_SWITCH_DISPATCH
+    #define SM83_SWITCH_CASE(opcode, handler) case opcode: handler(); break;
+
+    switch(opcode)
     {
-        std::cout<<"Unrecognized instruction: 0x"<<std::hex<<static_cast<int>(opcode)<<'\n';
-        exit(-1);
+        SM83_OPCODES(SM83_SWITCH_CASE)
     }
+#else
+    (this->*opcode_table[opcode])();
+#endif
 }
 //##############################################################################
-void sharpsm83::execute_0xCB_instruction(uint8_t opcode)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::execute_0xCB_instruction(uint8_t opcode)
 {
-    if(CB_opcode_table[opcode])
-    {
-        CB_opcode_table[opcode]();
-    }
-    else
+#ifdef CPU_SWITCH_DISPATCH
+    switch(opcode)
     {
-        std::cout<<"Unrecognized instruction: 0xCB 0x"<<std::hex<<static_cast<int>(opcode)<<'\n';
-        exit(-1);
+        SM83_CB_OPCODES(SM83_SWITCH_CASE)
     }
+
+    #undef SM83_SWITCH_CASE
+#else
+    (this->*CB_opcode_table[opcode])();
+#endif
 }
 //##############################################################################
-void sharpsm83::execute_nop()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::execute_nop()
 {
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::execute_halt()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::execute_halt()
 {
     std::cout<<"HALT"<<'\n';
 
-    bool any_interrupt_pending = bus->bus_read(0xFFFF) & bus->bus_read(0xFF0F) & 0x1F;
+    bool any_interrupt_pending = interrupt_pending != 0;
 
     if (interrupts_enabled) 
     {
@@ -218,6 +922,7 @@ void sharpsm83::execute_halt()
         {
             // HALT bug: do NOT halt, but PC does not increment on next fetch
             halt_bug = true;
+            fetch_window = nullptr;
         } 
         else 
         {
@@ -226,10 +931,11 @@ void sharpsm83::execute_halt()
     }
 }
 //##############################################################################
-void sharpsm83::execute_stop()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::execute_stop()
 {
     std::cout<<"STOP"<<'\n';
-    PC.b0_15 += 1;   // Skip padding byte
+    regs.PC += 1;   // Skip padding byte
 
     // TODO: see about the halt
     //is_halted = true;
@@ -244,24 +950,26 @@ void sharpsm83::execute_stop()
     }
 }
 //##############################################################################
-void sharpsm83::rlc(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rlc(uint8_t& reg)
 {
-    bool msb = reg.b7;
+    bool msb = (reg >> 7);
 
     set_zero_flag(false); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(msb); // C flag
 
-    reg.b0_7 <<= 1;
-    reg.b0 = msb;
+    reg <<= 1;
+    reg = (reg & 0xFE) | msb;
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::rl(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rl(uint8_t& reg)
 {
-    bool msb = reg.b7;
+    bool msb = (reg >> 7);
     bool old_carry = get_carry_flag();
 
     set_zero_flag(false); // Z flag
@@ -269,30 +977,32 @@ void sharpsm83::rl(reg8& reg)
     set_half_carry_flag(false); // H flag
     set_carry_flag(msb); // C flag
 
-    reg.b0_7 <<= 1;
-    reg.b0 = old_carry;
+    reg <<= 1;
+    reg = (reg & 0xFE) | old_carry;
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::rrc(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rrc(uint8_t& reg)
 {
-    bool lsb = reg.b0;
+    bool lsb = (reg & 0x01);
 
     set_zero_flag(false); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(lsb); // C flag
 
-    reg.b0_7 >>= 1;
-    reg.b7 = lsb;
+    reg >>= 1;
+    reg = (reg & 0x7F) | (lsb << 7);
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::rr(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rr(uint8_t& reg)
 {
-    bool lsb = reg.b0;
+    bool lsb = (reg & 0x01);
     bool old_carry = get_carry_flag();
 
     set_zero_flag(false); // Z flag
@@ -300,25 +1010,26 @@ void sharpsm83::rr(reg8& reg)
     set_half_carry_flag(false); // H flag
     set_carry_flag(lsb); // C flag
 
-    reg.b0_7 >>= 1;
-    reg.b7 = old_carry;
+    reg >>= 1;
+    reg = (reg & 0x7F) | (old_carry << 7);
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::jr(bool cond)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jr(bool cond)
 {
     int8_t offset = fetch_data();
     
     if (offset == -2) {exit_on_infinite_jr = true; return;} // infinite loop detected}
 
-    uint16_t starting_point = PC.b0_15;
+    uint16_t starting_point = regs.PC;
 
     uint16_t new_pc = (uint16_t)(starting_point + offset);
 
     if(cond)
     {
-        PC.b0_15 = new_pc;
+        regs.PC = new_pc;
         emulate_cycles(3);
     }
     else
@@ -327,14 +1038,16 @@ void sharpsm83::jr(bool cond)
     }    
 }
 //##############################################################################
-void sharpsm83::jp(const uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jp(const uint16_t& address)
 {
     emulate_cycles(1);
     
-    PC.b0_15 = address;
+    regs.PC = address;
 }
 //##############################################################################
-void sharpsm83::jp(bool cond)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jp(bool cond)
 {
     uint8_t low = fetch_data();
     uint8_t high = fetch_data();
@@ -343,7 +1056,7 @@ void sharpsm83::jp(bool cond)
 
     if(cond)
     {
-        PC.b0_15 = address;
+        regs.PC = address;
         emulate_cycles(4);
     }
     else
@@ -352,7 +1065,8 @@ void sharpsm83::jp(bool cond)
     }
 }
 //##############################################################################
-void sharpsm83::call(bool cond)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::call(bool cond)
 {
     uint8_t low = fetch_data();
     uint8_t high = fetch_data();
@@ -363,9 +1077,9 @@ void sharpsm83::call(bool cond)
     {
         emulate_cycles(6);
 
-        stack_push(PC.b0_15);
+        stack_push(regs.PC);
         
-        PC.b0_15 = address;
+        regs.PC = address;
     }
     else
     {
@@ -373,18 +1087,20 @@ void sharpsm83::call(bool cond)
     }
 }
 //##############################################################################
-void sharpsm83::rst(const uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rst(const uint16_t& address)
 {
-    stack_push(PC.b0_15);
+    stack_push(regs.PC);
 
     emulate_cycles(4);
 
-    PC.b0_15 = address;
+    regs.PC = address;
 }
 //##############################################################################
-void sharpsm83::da(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::da(uint8_t& reg)
 {
-    uint8_t a = reg.b0_7;
+    uint8_t a = reg;
     bool n = get_subtraction_flag();
     bool h = get_half_carry_flag();
     bool c = get_carry_flag();
@@ -408,7 +1124,7 @@ void sharpsm83::da(reg8& reg)
         // new_carry stays as previous carry
     }
 
-    reg.b0_7 = a;
+    reg = a;
     set_zero_flag(a == 0);
     set_half_carry_flag(false);
     set_carry_flag(new_carry);
@@ -416,9 +1132,10 @@ void sharpsm83::da(reg8& reg)
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::complement(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::complement(uint8_t& reg)
 {
-    reg.b0_7 = ~reg.b0_7;
+    reg = ~reg;
 
     set_subtraction_flag(true); // N flag
     set_half_carry_flag(true); // H flag
@@ -426,23 +1143,26 @@ void sharpsm83::complement(reg8& reg)
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::ld_to_address(const uint16_t& address, const uint8_t& data)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_to_address(const uint16_t& address, const uint8_t& data)
 {
     write_data(address, data);
 
     emulate_cycles(2);
     }
 //##############################################################################
-void sharpsm83::ld_to_address(const reg16& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_to_address(const reg_pair& reg)
 {
     uint8_t data = fetch_data();
     emulate_cycles(1);
 
-    write_data(reg.b0_15, data);
+    write_data(reg, data);
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::ld_to_address(const reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_to_address(const uint8_t& reg)
 {
     uint8_t low = fetch_data();
     emulate_cycles(1);
@@ -452,32 +1172,35 @@ void sharpsm83::ld_to_address(const reg8& reg)
 
     uint16_t address = (high << 0x8) | low;
 
-    write_data(address, reg.b0_7);
+    write_data(address, reg);
 
     emulate_cycles(2);    
 }
 //##############################################################################
-void sharpsm83::ldh_to_address(const reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ldh_to_address(const uint8_t& reg)
 {
     uint8_t imm8 = fetch_data();
     emulate_cycles(1);
 
     uint16_t address = imm8 + 0xFF00;
 
-    write_data(address, reg.b0_7);
+    write_data(address, reg);
     emulate_cycles(2);    
 }
 //##############################################################################
-void sharpsm83::ldh_to_address(const reg8& to, const reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ldh_to_address(const uint8_t& to, const uint8_t& reg)
 {
-    uint16_t address = to.b0_7 + 0xFF00;
+    uint16_t address = to + 0xFF00;
 
-    write_data(address, reg.b0_7);
+    write_data(address, reg);
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::ld_sp()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_sp()
 {
     uint16_t lo = fetch_data();
     emulate_cycles(1);
@@ -488,13 +1211,14 @@ void sharpsm83::ld_sp()
     uint16_t address = (hi << 8) | lo;
     emulate_cycles(1);
 
-    write_data(address, SP.b0_15 & 0xFF);        // low byte
-    write_data(address + 1, (SP.b0_15 >> 8));   // high byte
+    write_data(address, regs.SP & 0xFF);        // low byte
+    write_data(address + 1, (regs.SP >> 8));   // high byte
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::ldh_from_address(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ldh_from_address(uint8_t& reg)
 {
     uint8_t imm8 = fetch_data();
     emulate_cycles(1);
@@ -504,27 +1228,29 @@ void sharpsm83::ldh_from_address(reg8& reg)
     uint8_t data = bus->bus_read(address);;
     emulate_cycles(1);
 
-    reg.b0_7 = data;
+    reg = data;
     emulate_cycles(1);   
 }
 //##############################################################################
-void sharpsm83::ldh_from_address(reg8& to, const reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ldh_from_address(uint8_t& to, const uint8_t& reg)
 {
-    uint16_t address = reg.b0_7 + 0xFF00;
+    uint16_t address = reg + 0xFF00;
 
-    to.b0_7 = bus->bus_read(address);
+    to = bus->bus_read(address);
 
     emulate_cycles(2);    
 }
 //##############################################################################
-void sharpsm83::ld_hl_reg_e8(const reg16& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_hl_reg_e8(const uint16_t& reg)
 {
     int8_t imm8 = static_cast<int8_t>(fetch_data());
 
-    uint16_t sp = reg.b0_15;
+    uint16_t sp = reg;
     uint16_t result = sp + imm8;
 
-    HL.b0_15 = result;
+    HL() = result;
 
     set_zero_flag(false);        // Z is always 0
     set_subtraction_flag(false); // N is always 0
@@ -538,7 +1264,8 @@ void sharpsm83::ld_hl_reg_e8(const reg16& reg)
     emulate_cycles(3);
 }
 //##############################################################################
-void sharpsm83::ld_a_memimm16_op()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_memimm16_op()
 {
     uint8_t low = fetch_data();
     emulate_cycles(1);
@@ -551,18 +1278,20 @@ void sharpsm83::ld_a_memimm16_op()
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
 
-    AF.Hi.b0_7 = data;
+    regs.A = data;
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::ld_sp_hl_op()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_sp_hl_op()
 {
-    SP.b0_15 = HL.b0_15;
+    regs.SP = HL();
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::ld_from_address(uint8_t& reg, const uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_from_address(uint8_t& reg, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
@@ -571,7 +1300,8 @@ void sharpsm83::ld_from_address(uint8_t& reg, const uint16_t& address)
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::ld(uint16_t& to)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld(uint16_t& to)
 {
     uint8_t lo = fetch_data();
 
@@ -582,14 +1312,29 @@ void sharpsm83::ld(uint16_t& to)
     emulate_cycles(3);
 }
 //##############################################################################
-void sharpsm83::ld(uint8_t& to)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld(reg_pair to)
+{
+    uint8_t lo = fetch_data();
+
+    uint8_t hi = fetch_data();
+
+    to.lo = lo;
+    to.hi = hi;
+
+    emulate_cycles(3);
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld(uint8_t& to)
 {
     to = fetch_data();
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::ld(uint8_t& to, const uint8_t& from)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld(uint8_t& to, const uint8_t& from)
 {
     emulate_cycles(1);
 
@@ -597,20 +1342,35 @@ void sharpsm83::ld(uint8_t& to, const uint8_t& from)
 }
 //##############################################################################
 //##############################################################################
-void sharpsm83::inc(uint16_t& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc(uint16_t& reg)
 {
     reg += 1;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::inc(uint8_t& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc(reg_pair reg)
+{
+    reg = reg + 1;
+
+    emulate_cycles(2);
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc(uint8_t& reg)
 {
     uint8_t result = reg + 1;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::INC, reg, 0, pending_carry());
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(((reg & 0x0F) + 1) > 0x0F); // H flag
+#endif
 
     reg = result;
 
@@ -618,58 +1378,86 @@ void sharpsm83::inc(uint8_t& reg)
 
 }
 //##############################################################################
-void sharpsm83::inc_mem(uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_mem(const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
 
     uint8_t result = data + 1;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::INC, data, 0, pending_carry());
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(((data & 0x0F) + 1) > 0x0F); // H flag
+#endif
 
     write_data(address, result);
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::dec(uint8_t& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec(uint8_t& reg)
 {
     uint8_t result = reg - 1;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::DEC, reg, 0, pending_carry());
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(true); // N flag
     set_half_carry_flag(((reg & 0xF) == 0)); // H flag
+#endif
 
     reg = result;
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::dec(uint16_t& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec(uint16_t& reg)
 {
     reg -= 1;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::dec_mem(uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec(reg_pair reg)
+{
+    reg = reg - 1;
+
+    emulate_cycles(2);
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_mem(const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
 
     uint8_t result = data - 1;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::DEC, data, 0, pending_carry());
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(true); // N flag
     set_half_carry_flag((data & 0x0F) == 0x00); // H flag
+#endif
 
     write_data(address, result);
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::add(uint16_t& op1, uint16_t& op2)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add(reg_pair op1, const uint16_t& op2)
 {
     uint32_t result = op1 + op2;
 
@@ -682,56 +1470,75 @@ void sharpsm83::add(uint16_t& op1, uint16_t& op2)
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::add(uint8_t& op1, uint8_t& op2)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add(uint8_t& op1, uint8_t& op2)
 {   
     uint16_t result = op1 + op2;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::ADD, op1, op2, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag((result & 0xFF) == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(((op1 & 0xF) + (op2 & 0xF)) > 0xF); // H flag
     set_carry_flag(result > UINT8_MAX); // C flag
+#endif
 
     op1 = result & 0xFF;
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::add_from_address(uint8_t& op1, uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_from_address(uint8_t& op1, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     uint16_t result = op1 + data;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::ADD, op1, data, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag((result & 0xFF) == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(((op1 & 0xF) + (data & 0xF)) > 0xF); // H flag
     set_carry_flag(result > UINT8_MAX); // C flag
+#endif
 
     op1 = result & 0xFF;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::add(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add(uint8_t& reg)
 {
     uint8_t data = fetch_data();
-    uint16_t result = reg.b0_7 + data;
+    uint16_t result = reg + data;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::ADD, reg, data, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag((result & 0xFF) == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
-    set_half_carry_flag(((reg.b0_7 & 0xF) + (data & 0xF)) > 0xF); // H flag
+    set_half_carry_flag(((reg & 0xF) + (data & 0xF)) > 0xF); // H flag
     set_carry_flag(result > UINT8_MAX); // C flag
+#endif
 
-    reg.b0_7 = result & 0xFF;
+    reg = result & 0xFF;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::add_e8(reg16& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_e8(uint16_t& reg)
 {
     uint8_t data = fetch_data();
     int8_t e8 = static_cast<int8_t>(data);
 
-    uint16_t sp = reg.b0_15;
+    uint16_t sp = reg;
     uint16_t result = sp + e8;
 
     set_zero_flag(false);        // Z flag always cleared
@@ -743,122 +1550,165 @@ void sharpsm83::add_e8(reg16& reg)
     // Carry: check carry from bit 7 -> 8 in low byte
     set_carry_flag(((sp & 0xFF) + (uint8_t)e8) > 0xFF);
 
-    reg.b0_15 = result;
+    reg = result;
 
     emulate_cycles(4);
 }
 //##############################################################################
-void sharpsm83::adc(uint8_t& op1, uint8_t& op2)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc(uint8_t& op1, uint8_t& op2)
 {
     bool old_carry = get_carry_flag();
     uint16_t sum = op1 + op2 + (old_carry ? 1 : 0);
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::ADD, op1, op2, old_carry);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag((sum & 0xFF) == 0);
     set_subtraction_flag(false);
     set_half_carry_flag(((op1 & 0xF) + (op2 & 0xF) + (old_carry ? 1 : 0)) > 0xF);
     set_carry_flag(sum > 0xFF);
+#endif
 
     op1 = sum & 0xFF;
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::adc_from_address(uint8_t& op1, uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc_from_address(uint8_t& op1, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     bool old_carry = get_carry_flag();
     uint16_t result = op1 + data + old_carry;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::ADD, op1, data, old_carry);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag((result & 0xFF) == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(((op1 & 0xF) + (data & 0xF) + old_carry) > 0xF); // H flag
     set_carry_flag(result > UINT8_MAX); // C flag
+#endif
 
     op1 = result & 0xFF;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::adc(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc(uint8_t& reg)
 {
     uint8_t data = fetch_data();
     bool old_carry = get_carry_flag();
 
-    uint16_t result = reg.b0_7 + data + old_carry;
+    uint16_t result = reg + data + old_carry;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::ADD, reg, data, old_carry);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag((result & 0xFF) == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
-    set_half_carry_flag(((reg.b0_7 & 0xF) + (data & 0xF) + old_carry) > 0xF); // H flag
+    set_half_carry_flag(((reg & 0xF) + (data & 0xF) + old_carry) > 0xF); // H flag
     set_carry_flag(result > UINT8_MAX); // C flag
+#endif
 
-    reg.b0_7 = result & 0xFF;
+    reg = result & 0xFF;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::sub(uint8_t& op1, uint8_t& op2)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub(uint8_t& op1, uint8_t& op2)
 {
     uint8_t result = op1 - op2;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::SUB, op1, op2, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(true); // N flag
     set_half_carry_flag((op1 & 0xF) < (op2 & 0xF)); // H flag
     set_carry_flag(op2 > op1); // C flag
+#endif
 
     op1 = result;
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::sub_from_address(uint8_t& op1, uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub_from_address(uint8_t& op1, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     uint8_t result = op1 - data;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::SUB, op1, data, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(true); // N flag
     set_half_carry_flag((data & 0xF) > (op1 & 0xF)); // H flag
     set_carry_flag(data > op1); // C flag
+#endif
 
     op1 = result;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::sub(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub(uint8_t& reg)
 {
     uint8_t data = fetch_data();
 
-    uint8_t result = reg.b0_7 - data;
+    uint8_t result = reg - data;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::SUB, reg, data, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(true); // N flag
-    set_half_carry_flag((reg.b0_7 & 0xF) < (data & 0xF)); // H flag
-    set_carry_flag(data > reg.b0_7);           // C flag
+    set_half_carry_flag((reg & 0xF) < (data & 0xF)); // H flag
+    set_carry_flag(data > reg);           // C flag
+#endif
 
-    reg.b0_7 = result;
+    reg = result;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::sbc(uint8_t& op1, uint8_t& op2)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc(uint8_t& op1, uint8_t& op2)
 {
     bool carry = get_carry_flag();
 
     int result_full = op1 - op2 - carry;
     uint8_t result = result_full & 0xFF;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::SUB, op1, op2, carry);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0);
     set_subtraction_flag(true);
     set_half_carry_flag(((op1 & 0xf) - (op2 & 0xf) - carry) < 0);
     set_carry_flag(result_full < 0);
+#endif
 
     op1 = result;
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::sbc_from_address(uint8_t& op1, uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc_from_address(uint8_t& op1, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     bool carry = get_carry_flag();
@@ -866,275 +1716,367 @@ void sharpsm83::sbc_from_address(uint8_t& op1, uint16_t& address)
     int result_full = op1 - data -carry;
     uint8_t result = result_full & 0xFF;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::SUB, op1, data, carry);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0);
     set_subtraction_flag(true);
     set_half_carry_flag(((op1 & 0xf) - (data & 0xf) - carry) < 0);
     set_carry_flag(result_full < 0);
+#endif
 
     op1 = result;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::sbc(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc(uint8_t& reg)
 {
     uint8_t data = fetch_data();
     bool carry = get_carry_flag();
 
-    int result_full = reg.b0_7 - data - carry;
+    int result_full = reg - data - carry;
     uint8_t result = result_full & 0xFF;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::SUB, reg, data, carry);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0);
     set_subtraction_flag(true);
-    set_half_carry_flag(((reg.b0_7 & 0xf) - (data & 0xf) - carry) < 0);
+    set_half_carry_flag(((reg & 0xf) - (data & 0xf) - carry) < 0);
     set_carry_flag(result_full < 0);
+#endif
 
-    reg.b0_7 = result;
+    reg = result;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::and_op(uint8_t& op1, uint8_t& op2)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_op(uint8_t& op1, uint8_t& op2)
 {
     uint8_t result = op1 & op2;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::AND, result, 0, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(true); // H flag
     set_carry_flag(false); // C flag
+#endif
 
     op1 = result;
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::and_op_from_address(uint8_t& op1, uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_op_from_address(uint8_t& op1, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
 
     uint8_t result = op1 & data;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::AND, result, 0, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(true); // H flag
     set_carry_flag(false); // C flag
+#endif
 
     op1 = result;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::and_op(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_op(uint8_t& reg)
 {
     uint8_t data = fetch_data();
 
-    uint8_t result = reg.b0_7 & data;
+    uint8_t result = reg & data;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::AND, result, 0, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(true); // H flag
     set_carry_flag(false); // C flag
+#endif
 
-    reg.b0_7 = result;
+    reg = result;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::xor_op(uint8_t& op1, uint8_t& op2)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_op(uint8_t& op1, uint8_t& op2)
 {
     uint8_t result = op1 ^ op2;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::XOR, result, 0, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(false); // C flag
+#endif
 
     op1 = result;
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::xor_op_from_address(uint8_t& op1, uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_op_from_address(uint8_t& op1, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
 
     uint8_t result = op1 ^ data;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::XOR, result, 0, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(false); // C flag
+#endif
 
     op1 = result;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::xor_op(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_op(uint8_t& reg)
 {
     uint8_t data = fetch_data();
 
-    uint8_t result = reg.b0_7 ^ data;
+    uint8_t result = reg ^ data;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::XOR, result, 0, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(false); // C flag
+#endif
 
-    reg.b0_7  = result;
+    reg  = result;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::or_op(uint8_t& op1, uint8_t& op2)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_op(uint8_t& op1, uint8_t& op2)
 {
     uint8_t result = op1 | op2;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::OR, result, 0, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(false); // C flag
+#endif
 
     op1 = result;
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::or_op_from_address(uint8_t& op1, uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_op_from_address(uint8_t& op1, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
 
     uint8_t result = op1 | data;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::OR, result, 0, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(false); // C flag
+#endif
 
     op1 = result;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::or_op(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_op(uint8_t& reg)
 {
     uint8_t data = fetch_data();
 
-    uint8_t result = reg.b0_7 | data;
+    uint8_t result = reg | data;
 
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::OR, result, 0, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
     set_zero_flag(result == 0); // Z FLAG
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(false); // C flag
+#endif
 
-    reg.b0_7 = result;
+    reg = result;
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::cp_op(uint8_t& op1, uint8_t& op2)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_op(uint8_t& op1, uint8_t& op2)
 {
-    uint8_t result = op1 - op2;
-
-    set_zero_flag(result == 0); // Z FLAG
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::SUB, op1, op2, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
+    set_zero_flag(op1 == op2); // Z FLAG
     set_subtraction_flag(true); // N flag
     set_half_carry_flag((op1 & 0xF) < (op2 & 0xF)); // H flag
     set_carry_flag(op2 > op1); // C flag
+#endif
 
     emulate_cycles(1);
 }
 //##############################################################################
-void sharpsm83::cp_op_from_address(uint8_t& op1, uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_op_from_address(uint8_t& op1, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
 
-    uint8_t result = op1 - data;
-
-    set_zero_flag(result == 0); // Z FLAG
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::SUB, op1, data, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
+    set_zero_flag(op1 == data); // Z FLAG
     set_subtraction_flag(true); // N flag
     set_half_carry_flag((data & 0xF) > (op1 & 0xF)); // H flag
     set_carry_flag(data > op1); // C flag
+#endif
 
     emulate_cycles(2);
 }
  //##############################################################################
-void sharpsm83::cp_op(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_op(uint8_t& reg)
 {
     uint8_t data = fetch_data();
-    uint8_t result = reg.b0_7 - data;
 
-    set_zero_flag(result == 0); // Z FLAG
+#ifdef CPU_LAZY_FLAGS
+    record_flags(flag_op::SUB, reg, data, false);
+#endif
+#ifdef CPU_EAGER_FLAGS
+    set_zero_flag(reg == data); // Z FLAG
     set_subtraction_flag(true); // N flag
-    set_half_carry_flag((data & 0xF) > (reg.b0_7 & 0xF)); // H flag
-    set_carry_flag(data > reg.b0_7); // C flag
+    set_half_carry_flag((data & 0xF) > (reg & 0xF)); // H flag
+    set_carry_flag(data > reg); // C flag
+#endif
 
     emulate_cycles(2);
 }
 //##############################################################################
-void sharpsm83::stack_pop(uint16_t& val)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::stack_pop(uint16_t& val)
 {
-    uint8_t low = bus->bus_read(SP.b0_15);
-    SP.b0_15 += 1;
+    uint8_t low = bus->bus_read(regs.SP);
+    regs.SP += 1;
 
-    uint8_t high = bus->bus_read(SP.b0_15);
-    SP.b0_15 += 1;
+    uint8_t high = bus->bus_read(regs.SP);
+    regs.SP += 1;
 
     val = (high << 0x8) | low;
 }
 //##############################################################################
-void sharpsm83::pop(reg16& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::pop(reg_pair reg)
 {
-    stack_pop(reg.b0_15); 
+    uint16_t value;
+    stack_pop(value);
+    reg = value;
 
     emulate_cycles(3);
 }
 //##############################################################################
-void sharpsm83::pop_af_op()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::pop_af_op()
 {
-    stack_pop(AF.b0_15);
+    uint16_t value;
+    stack_pop(value);
+    pending_flags = flag_op::NONE;
 
     // the lower nibble of F is always zero
-    AF.b0_15 &= 0xFFF0; 
+    AF() = value & 0xFFF0;
     
     emulate_cycles(3);
 }
 //##############################################################################
-void sharpsm83::push_af_op()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::push_af_op()
 {
+    materialize_flags();
+
     // the lower nibble of F is always zero
-    AF.b0_15 &= 0xFFF0; 
+    regs.F &= 0xF0;
 
-    stack_push(AF.b0_15);
+    stack_push(AF());
 
     emulate_cycles(4);
 }
 //##############################################################################
-void sharpsm83::push(reg16& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::push(reg_pair reg)
 {
-    stack_push(reg.b0_15);
+    stack_push(reg);
 
     emulate_cycles(4);
 }
 //##############################################################################
-void sharpsm83::stack_push(const uint16_t& value)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::stack_push(const uint16_t& value)
 {
-    SP.b0_15 -= 1;
-    write_data(SP.b0_15, value >> 0x8);
-    SP.b0_15 -= 1;
-    write_data(SP.b0_15, value & 0xFF);
+    regs.SP -= 1;
+    write_data(regs.SP, value >> 0x8);
+    regs.SP -= 1;
+    write_data(regs.SP, value & 0xFF);
 }
 //##############################################################################
-void sharpsm83::ret_op()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ret_op()
 {
-    stack_pop(PC.b0_15);   
+    stack_pop(regs.PC);   
     emulate_cycles(4);
 }
 //##############################################################################
-void sharpsm83::ret_condition(bool condition)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ret_condition(bool condition)
 {
     if(condition) 
     {
-        stack_pop(PC.b0_15);   
+        stack_pop(regs.PC);   
         
         emulate_cycles(5);
     }
@@ -1144,7 +2086,8 @@ void sharpsm83::ret_condition(bool condition)
     }
 }
 //##############################################################################
-void sharpsm83::reti_op()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::reti_op()
 {
     interrupts_enabled = true;
 
@@ -1153,13 +2096,14 @@ void sharpsm83::reti_op()
     ret_op();
 }
 //##############################################################################
-void sharpsm83::rlc_param(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rlc_param(uint8_t& reg)
 {
-    bool msb = reg.b7;
-    reg.b0_7 <<= 1;
-    reg.b0 = msb;
+    bool msb = (reg >> 7);
+    reg <<= 1;
+    reg = (reg & 0xFE) | msb;
 
-    set_zero_flag(reg.b0_7 == 0); // Z flag
+    set_zero_flag(reg == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(msb); // C flag
@@ -1167,34 +2111,36 @@ void sharpsm83::rlc_param(reg8& reg)
     emulate_cycles(1);
 }
 
-void sharpsm83::rlcmem_param(uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rlcmem_param(const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
 
-    reg8 result;
+    uint8_t result;
     
-    result.b0_7 = data;
-    bool msb = result.b7;
-    result.b0_7 <<= 1;
-    result.b0 = msb;
+    result = data;
+    bool msb = (result >> 7);
+    result <<= 1;
+    result = (result & 0xFE) | msb;
 
-    set_zero_flag(result.b0_7 == 0); // Z flag
+    set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(msb); // C flag
-    write_data(address, result.b0_7);
+    write_data(address, result);
 
     emulate_cycles(2);
 }
 
-void sharpsm83::rrc_param(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rrc_param(uint8_t& reg)
 {
-    bool lsb = reg.b0;
-    reg.b0_7 >>= 1;
-    reg.b7 = lsb;
+    bool lsb = (reg & 0x01);
+    reg >>= 1;
+    reg = (reg & 0x7F) | (lsb << 7);
 
-    set_zero_flag(reg.b0_7 == 0); // Z flag
+    set_zero_flag(reg == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(lsb); // C flag
@@ -1202,32 +2148,34 @@ void sharpsm83::rrc_param(reg8& reg)
     emulate_cycles(1);
 }
 
-void sharpsm83::rrcmem_param(uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rrcmem_param(const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
-    reg8 result;
+    uint8_t result;
     
-    result.b0_7 = data;
-    bool lsb = result.b0;
-    result.b0_7 >>= 1;
-    result.b7 = lsb;
+    result = data;
+    bool lsb = (result & 0x01);
+    result >>= 1;
+    result = (result & 0x7F) | (lsb << 7);
 
-    set_zero_flag(result.b0_7 == 0); // Z flag
+    set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(lsb); // C flag
-    write_data(address, result.b0_7);
+    write_data(address, result);
     emulate_cycles(2);
 }
 
-void sharpsm83::rl_param(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rl_param(uint8_t& reg)
 {
-    bool msb = reg.b7;
-    reg.b0_7 <<= 1;
-    reg.b0 = get_carry_flag();
+    bool msb = (reg >> 7);
+    reg <<= 1;
+    reg = (reg & 0xFE) | get_carry_flag();
 
-    set_zero_flag(reg.b0_7 == 0); // Z flag
+    set_zero_flag(reg == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(msb); // C flag
@@ -1235,32 +2183,34 @@ void sharpsm83::rl_param(reg8& reg)
     emulate_cycles(1);
 }
 
-void sharpsm83::rlmem_param(uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rlmem_param(const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
-    reg8 result;
+    uint8_t result;
     
-    result.b0_7 = data;
-    bool msb = result.b7;
-    result.b0_7 <<= 1;
-    result.b0 = get_carry_flag();
+    result = data;
+    bool msb = (result >> 7);
+    result <<= 1;
+    result = (result & 0xFE) | get_carry_flag();
 
-    set_zero_flag(result.b0_7 == 0); // Z flag
+    set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(msb); // C flag
-    write_data(address, result.b0_7);
+    write_data(address, result);
     emulate_cycles(2);
 }
 
-void sharpsm83::rr_param(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rr_param(uint8_t& reg)
 {
-    bool lsb = reg.b0;
-    reg.b0_7 >>= 1;
-    reg.b7 = get_carry_flag();
+    bool lsb = (reg & 0x01);
+    reg >>= 1;
+    reg = (reg & 0x7F) | (get_carry_flag() << 7);
 
-    set_zero_flag(reg.b0_7 == 0); // Z flag
+    set_zero_flag(reg == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(lsb); // C flag
@@ -1268,31 +2218,33 @@ void sharpsm83::rr_param(reg8& reg)
     emulate_cycles(1);
 }
 
-void sharpsm83::rrmem_param(uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rrmem_param(const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
-    reg8 result;
+    uint8_t result;
     
-    result.b0_7 = data;
-    bool lsb = result.b0;
-    result.b0_7 >>= 1;
-    result.b7 = get_carry_flag();
+    result = data;
+    bool lsb = (result & 0x01);
+    result >>= 1;
+    result = (result & 0x7F) | (get_carry_flag() << 7);
 
-    set_zero_flag(result.b0_7 == 0); // Z flag
+    set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(lsb); // C flag
-    write_data(address, result.b0_7);
+    write_data(address, result);
     emulate_cycles(2);
 }
 
-void sharpsm83::sla_param(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sla_param(uint8_t& reg)
 {
-    bool msb = reg.b7;
-    reg.b0_7 <<= 1;
+    bool msb = (reg >> 7);
+    reg <<= 1;
 
-    set_zero_flag(reg.b0_7 == 0); // Z flag
+    set_zero_flag(reg == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(msb); // C flag
@@ -1300,32 +2252,34 @@ void sharpsm83::sla_param(reg8& reg)
     emulate_cycles(1);
 }
 
-void sharpsm83::slamem_param(uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::slamem_param(const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
-    reg8 result;
+    uint8_t result;
     
-    result.b0_7 = data;
-    bool msb = result.b7;
-    result.b0_7 <<= 1;
+    result = data;
+    bool msb = (result >> 7);
+    result <<= 1;
 
-    set_zero_flag(result.b0_7 == 0); // Z flag
+    set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(msb); // C flag
-    write_data(address, result.b0_7);
+    write_data(address, result);
     emulate_cycles(2);
 }
 
-void sharpsm83::sra_param(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sra_param(uint8_t& reg)
 {
-    bool msb = reg.b7;
-    bool lsb = reg.b0;
-    reg.b0_7 >>= 1;
-    reg.b7 = msb;
+    bool msb = (reg >> 7);
+    bool lsb = (reg & 0x01);
+    reg >>= 1;
+    reg = (reg & 0x7F) | (msb << 7);
 
-    set_zero_flag(reg.b0_7 == 0); // Z flag
+    set_zero_flag(reg == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(lsb); // C flag
@@ -1333,34 +2287,36 @@ void sharpsm83::sra_param(reg8& reg)
     emulate_cycles(1);
 }
 
-void sharpsm83::sramem_param(uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sramem_param(const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
 
-    reg8 result;
+    uint8_t result;
     
-    result.b0_7 = data;
-    bool msb = result.b7;
-    bool lsb = result.b0;
-    result.b0_7 >>= 1;
-    result.b7 = msb;
+    result = data;
+    bool msb = (result >> 7);
+    bool lsb = (result & 0x01);
+    result >>= 1;
+    result = (result & 0x7F) | (msb << 7);
 
-    set_zero_flag(result.b0_7 == 0); // Z flag
+    set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(lsb); // C flag
-    write_data(address, result.b0_7);
+    write_data(address, result);
     emulate_cycles(2);
 }
 
-void sharpsm83::swap_param(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::swap_param(uint8_t& reg)
 {
-    uint8_t upper = (reg.b0_7 & 0xF0) >> 4;
-    uint8_t lower = (reg.b0_7 & 0x0F) << 4;
-    reg.b0_7 = upper | lower;
+    uint8_t upper = (reg & 0xF0) >> 4;
+    uint8_t lower = (reg & 0x0F) << 4;
+    reg = upper | lower;
 
-    set_zero_flag(reg.b0_7 == 0); // Z flag
+    set_zero_flag(reg == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(false); // C flag
@@ -1368,32 +2324,34 @@ void sharpsm83::swap_param(reg8& reg)
     emulate_cycles(1);
 }
 
-void sharpsm83::swapmem_param(uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::swapmem_param(const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
-    reg8 result;
+    uint8_t result;
     
-    result.b0_7 = data;
-    uint8_t upper = (result.b0_7 & 0xF0) >> 4;
-    uint8_t lower = (result.b0_7 & 0x0F) << 4;
-    result.b0_7 = upper | lower;
+    result = data;
+    uint8_t upper = (result & 0xF0) >> 4;
+    uint8_t lower = (result & 0x0F) << 4;
+    result = upper | lower;
 
-    set_zero_flag(result.b0_7 == 0); // Z flag
+    set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(false); // C flag
-    write_data(address, result.b0_7);
+    write_data(address, result);
     emulate_cycles(2);
 }
 
-void sharpsm83::srl_param(reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::srl_param(uint8_t& reg)
 {
-    bool lsb = reg.b0;
-    reg.b0_7 >>= 1;
-    reg.b7 = 0;
+    bool lsb = (reg & 0x01);
+    reg >>= 1;
+    reg &= 0x7F;
 
-    set_zero_flag(reg.b0_7 == 0); // Z flag
+    set_zero_flag(reg == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(lsb); // C flag
@@ -1401,29 +2359,31 @@ void sharpsm83::srl_param(reg8& reg)
     emulate_cycles(1);
 }
 
-void sharpsm83::srlmem_param(uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::srlmem_param(const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
 
-    reg8 result;
+    uint8_t result;
     
-    result.b0_7 = data;
-    bool lsb = result.b0;
-    result.b0_7 >>= 1;
-    result.b7 = 0;
+    result = data;
+    bool lsb = (result & 0x01);
+    result >>= 1;
+    result &= 0x7F;
 
-    set_zero_flag(result.b0_7 == 0); // Z flag
+    set_zero_flag(result == 0); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(false); // H flag
     set_carry_flag(lsb); // C flag
-    write_data(address, result.b0_7);
+    write_data(address, result);
     emulate_cycles(2);
 }
 
-void sharpsm83::bit_param(uint8_t bit, reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::bit_param(uint8_t bit, uint8_t& reg)
 {
-    bool bit_value = (reg.b0_7 >> bit) & 0x01;
+    bool bit_value = (reg >> bit) & 0x01;
 
     set_zero_flag(!bit_value); // Z flag
     set_subtraction_flag(false); // N flag
@@ -1432,1183 +2392,731 @@ void sharpsm83::bit_param(uint8_t bit, reg8& reg)
     emulate_cycles(1);
 }
 
-void sharpsm83::bitmem_param(uint8_t bit, uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::bitmem_param(uint8_t bit, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
 
-    reg8 result;
+    uint8_t result;
     
-    result.b0_7 = data;
+    result = data;
     emulate_cycles(1);
 
-    bool bit_value = (result.b0_7 >> bit) & 0x01;
+    bool bit_value = (result >> bit) & 0x01;
 
     set_zero_flag(!bit_value); // Z flag
     set_subtraction_flag(false); // N flag
     set_half_carry_flag(true); // H flag
 }
 
-void sharpsm83::res_param(uint8_t bit, reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::res_param(uint8_t bit, uint8_t& reg)
 {
-    reg.b0_7 &= ~(1 << bit);
+    reg &= ~(1 << bit);
 
     emulate_cycles(1);
 }
 
-void sharpsm83::resmem_param(uint8_t bit, uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::resmem_param(uint8_t bit, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
 
-    reg8 result;
+    uint8_t result;
     emulate_cycles(1);
     
-    result.b0_7 = data;
-    result.b0_7 &= ~(1 << bit);
-    write_data(address, result.b0_7);
+    result = data;
+    result &= ~(1 << bit);
+    write_data(address, result);
 
     emulate_cycles(2);
 }
 
-void sharpsm83::set_param(uint8_t bit, reg8& reg)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_param(uint8_t bit, uint8_t& reg)
 {
-    reg.b0_7 |= (1 << bit);
+    reg |= (1 << bit);
 
     emulate_cycles(1);
 }
 
-void sharpsm83::setmem_param(uint8_t bit, uint16_t& address)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::setmem_param(uint8_t bit, const uint16_t& address)
 {
     uint8_t data = bus->bus_read(address);
     emulate_cycles(1);
 
-    reg8 result;
+    uint8_t result;
     
-    result.b0_7 = data;
-    result.b0_7 |= (1 << bit);
+    result = data;
+    result |= (1 << bit);
 
-    write_data(address, result.b0_7);
+    write_data(address, result);
     emulate_cycles(2);
 }
 
 //##############################################################################
-void sharpsm83::nop() { execute_nop(); } // 0x00
-void sharpsm83::ld_bc_imm16() { ld(BC.b0_15); } // 0x01
-void sharpsm83::ld_membc_a() { ld_to_address(BC.b0_15, AF.Hi.b0_7); } // 0x02
-void sharpsm83::inc_bc() { inc(BC.b0_15); } // 0x03
-void sharpsm83::inc_b() { inc(BC.Hi.b0_7); } // 0x04
-void sharpsm83::dec_b() { dec(BC.Hi.b0_7); } // 0x05
-void sharpsm83::ld_b_imm8() { ld(BC.Hi.b0_7); } // 0x06
-void sharpsm83::rlca() { rlc(AF.Hi); } // 0x07
-void sharpsm83::ld_memimm16_sp() { ld_sp();}  // 0x08
-void sharpsm83::add_hl_bc() { add(HL.b0_15, BC.b0_15); } // 0x09
-void sharpsm83::ld_a_membc() { ld_from_address(AF.Hi.b0_7, BC.b0_15); } // 0x0A
-void sharpsm83::dec_bc() { dec(BC.b0_15); } // 0x0B
-void sharpsm83::inc_c() { inc(BC.Lo.b0_7); } // 0x0C
-void sharpsm83::dec_c() { dec(BC.Lo.b0_7); } // 0x0D
-void sharpsm83::ld_c_imm8() { ld(BC.Lo.b0_7); } // 0x0E
-void sharpsm83::rrca() { rrc(AF.Hi); } // 0x0F
-//##############################################################################
-void sharpsm83::stop_imm8() { execute_stop(); }// 0x10
-void sharpsm83::ld_de_imm16() {ld(DE.b0_15);} // 0x11
-void sharpsm83::ld_memde_a() { ld_to_address(DE.b0_15, AF.Hi.b0_7); } // 0x12
-void sharpsm83::inc_de(){ inc(DE.b0_15); }; // 0x13
-void sharpsm83::inc_d(){ inc(DE.Hi.b0_7); }; // 0x14
-void sharpsm83::dec_d(){ dec(DE.Hi.b0_7); }; // 0x15
-void sharpsm83::ld_d_imm8() { ld(DE.Hi.b0_7); } // 0x16
-void sharpsm83::rla() { rl(AF.Hi); } // 0x17
-void sharpsm83::jr_e8() { jr(true); } // 0x18
-void sharpsm83::add_hl_de() { add(HL.b0_15, DE.b0_15); } // 0x19
-void sharpsm83::ld_a_memde() { ld_from_address(AF.Hi.b0_7, DE.b0_15); } // 0x1A
-void sharpsm83::dec_de() { dec(DE.b0_15); } // 0x1B
-void sharpsm83::inc_e() { inc(DE.Lo.b0_7); } // 0x1C
-void sharpsm83::dec_e() { dec(DE.Lo.b0_7); } // 0x1D
-void sharpsm83::ld_e_imm8() { ld(DE.Lo.b0_7); } // 0x1E
-void sharpsm83::rra() { rr(AF.Hi); } // 0x1F
-//##############################################################################
-void sharpsm83::jr_nz_e8() { jr(!get_zero_flag()); }; // 0x20
-void sharpsm83::ld_hl_imm16() { ld(HL.b0_15); } // 0x21
-void sharpsm83::ld_memhlinc_a() { ld_to_address(HL.b0_15++, AF.Hi.b0_7); } // 0x22
-void sharpsm83::inc_hl() { inc(HL.b0_15); } // 0x23
-void sharpsm83::inc_h() { inc(HL.Hi.b0_7); } // 0x24
-void sharpsm83::dec_h() { dec(HL.Hi.b0_7); } // 0x25
-void sharpsm83::ld_h_imm8() { ld(HL.Hi.b0_7); } // 0x26
-void sharpsm83::daa() { da(AF.Hi); } // 0x27
-void sharpsm83::jr_z_e8() { jr(get_zero_flag()); } // 0x28
-void sharpsm83::add_hl_hl() { add(HL.b0_15, HL.b0_15); } // 0x29
-void sharpsm83::ld_a_memhlinc() { ld_from_address(AF.Hi.b0_7, HL.b0_15++); }  // 0x2A
-void sharpsm83::dec_hl() { dec(HL.b0_15); } // 0x2B
-void sharpsm83::inc_l() { inc(HL.Lo.b0_7);  } // 0x2C
-void sharpsm83::dec_l() { dec(HL.Lo.b0_7);  } // 0x2D
-void sharpsm83::ld_l_imm8() { ld(HL.Lo.b0_7);  } // 0x2E
-void sharpsm83::cpl() { complement(AF.Hi); } // 0x2F
-//##############################################################################
-void sharpsm83::jr_nc_e8() { jr(!get_carry_flag()); } // 0x30
-void sharpsm83::ld_sp_imm16() { ld(SP.b0_15); } // 0x31
-void sharpsm83::ld_memhldec_a() { ld_to_address(HL.b0_15--, AF.Hi.b0_7); } // 0x32
-void sharpsm83::inc_sp() { inc(SP.b0_15); } // 0x33
-void sharpsm83::inc_memhl() { inc_mem(HL.b0_15); } // 0x34
-void sharpsm83::dec_memhl() { dec_mem(HL.b0_15); } // 0x35
-void sharpsm83::ld_memhl_imm8() { ld_to_address(HL); }  // 0x36
-void sharpsm83::scf() { set_carry_flag(); } // 0x37
-void sharpsm83::jr_c_e8() { jr(get_carry_flag()); } // 0x38
-void sharpsm83::add_hl_sp() { add(HL.b0_15, SP.b0_15); } // 0x39
-void sharpsm83::ld_a_memhldec() { ld_from_address(AF.Hi.b0_7, HL.b0_15--); } // 0x3A
-void sharpsm83::dec_sp() { dec(SP.b0_15); } // 0x3B
-void sharpsm83::inc_a() { inc(AF.Hi.b0_7); } // 0x3C
-void sharpsm83::dec_a() { dec(AF.Hi.b0_7); } // 0x3D
-void sharpsm83::ld_a_imm8() { ld(AF.Hi.b0_7); } // 0x3E
-void sharpsm83::ccf(){ complement_carry_flag(); }// 0x3F
-//##############################################################################
-void sharpsm83::ld_b_b() { ld(BC.Hi.b0_7, BC.Hi.b0_7); } // 0x40
-void sharpsm83::ld_b_c() { ld(BC.Hi.b0_7, BC.Lo.b0_7); } // 0x41
-void sharpsm83::ld_b_d() { ld(BC.Hi.b0_7, DE.Hi.b0_7); } // 0x42
-void sharpsm83::ld_b_e() { ld(BC.Hi.b0_7, DE.Lo.b0_7); } // 0x43
-void sharpsm83::ld_b_h() { ld(BC.Hi.b0_7, HL.Hi.b0_7); } // 0x44
-void sharpsm83::ld_b_l() { ld(BC.Hi.b0_7, HL.Lo.b0_7); } // 0x45
-void sharpsm83::ld_b_memhl( ) { ld_from_address(BC.Hi.b0_7, HL.b0_15); } // 0x46
-void sharpsm83::ld_b_a() { ld(BC.Hi.b0_7, AF.Hi.b0_7); } // 0x47
-void sharpsm83::ld_c_b() { ld(BC.Lo.b0_7, BC.Hi.b0_7); } // 0x48
-void sharpsm83::ld_c_c() { ld(BC.Lo.b0_7, BC.Lo.b0_7); } // 0x49
-void sharpsm83::ld_c_d() { ld(BC.Lo.b0_7, DE.Hi.b0_7); } // 0x4A
-void sharpsm83::ld_c_e() { ld(BC.Lo.b0_7, DE.Lo.b0_7); } // 0x4B
-void sharpsm83::ld_c_h() { ld(BC.Lo.b0_7, HL.Hi.b0_7); } // 0x4C
-void sharpsm83::ld_c_l() { ld(BC.Lo.b0_7, HL.Lo.b0_7); } // 0x4D
-void sharpsm83::ld_c_memhl(){ ld_from_address(BC.Lo.b0_7, HL.b0_15); } // 0x4E
-void sharpsm83::ld_c_a() { ld(BC.Lo.b0_7, AF.Hi.b0_7); } // 0x4F
-//##############################################################################
-void sharpsm83::ld_d_b() { ld(DE.Hi.b0_7, BC.Hi.b0_7); } // 0x50
-void sharpsm83::ld_d_c() { ld(DE.Hi.b0_7, BC.Lo.b0_7); } // 0x51
-void sharpsm83::ld_d_d() { ld(DE.Hi.b0_7, DE.Hi.b0_7); } // 0x52
-void sharpsm83::ld_d_e() { ld(DE.Hi.b0_7, DE.Lo.b0_7); } // 0x53
-void sharpsm83::ld_d_h() { ld(DE.Hi.b0_7, HL.Hi.b0_7); } // 0x54
-void sharpsm83::ld_d_l() { ld(DE.Hi.b0_7, HL.Lo.b0_7); } // 0x55
-void sharpsm83::ld_d_memhl() { ld_from_address(DE.Hi.b0_7, HL.b0_15); } // 0x56
-void sharpsm83::ld_d_a() { ld(DE.Hi.b0_7, AF.Hi.b0_7); } // 0x57
-void sharpsm83::ld_e_b() { ld(DE.Lo.b0_7, BC.Hi.b0_7); } // 0x58
-void sharpsm83::ld_e_c() { ld(DE.Lo.b0_7, BC.Lo.b0_7); } // 0x59
-void sharpsm83::ld_e_d() { ld(DE.Lo.b0_7, DE.Hi.b0_7); } // 0x5A
-void sharpsm83::ld_e_e() { ld(DE.Lo.b0_7, DE.Lo.b0_7); } // 0x5B
-void sharpsm83::ld_e_h() { ld(DE.Lo.b0_7, HL.Hi.b0_7); } // 0x5C
-void sharpsm83::ld_e_l() { ld(DE.Lo.b0_7, HL.Lo.b0_7); } // 0x5D
-void sharpsm83::ld_e_memhl() { ld_from_address(DE.Lo.b0_7, HL.b0_15); } // 0x5E
-void sharpsm83::ld_e_a() { ld(DE.Lo.b0_7, AF.Hi.b0_7); } // 0x5F
-//##############################################################################
-void sharpsm83::ld_h_b() { ld(HL.Hi.b0_7, BC.Hi.b0_7); } // 0x60
-void sharpsm83::ld_h_c() { ld(HL.Hi.b0_7, BC.Lo.b0_7); } // 0x61
-void sharpsm83::ld_h_d() { ld(HL.Hi.b0_7, DE.Hi.b0_7); } // 0x62
-void sharpsm83::ld_h_e() { ld(HL.Hi.b0_7, DE.Lo.b0_7); } // 0x63
-void sharpsm83::ld_h_h() { ld(HL.Hi.b0_7, HL.Hi.b0_7); } // 0x64
-void sharpsm83::ld_h_l() { ld(HL.Hi.b0_7, HL.Lo.b0_7); } // 0x65
-void sharpsm83::ld_h_memhl() { ld_from_address(HL.Hi.b0_7, HL.b0_15); } // 0x66
-void sharpsm83::ld_h_a() { ld(HL.Hi.b0_7, AF.Hi.b0_7); } // 0x67
-void sharpsm83::ld_l_b() { ld(HL.Lo.b0_7, BC.Hi.b0_7); } // 0x68
-void sharpsm83::ld_l_c() { ld(HL.Lo.b0_7, BC.Lo.b0_7); } // 0x69
-void sharpsm83::ld_l_d() { ld(HL.Lo.b0_7, DE.Hi.b0_7); } // 0x6A
-void sharpsm83::ld_l_e() { ld(HL.Lo.b0_7, DE.Lo.b0_7); } // 0x6B
-void sharpsm83::ld_l_h() { ld(HL.Lo.b0_7, HL.Hi.b0_7); } // 0x6C
-void sharpsm83::ld_l_l() { ld(HL.Lo.b0_7, HL.Lo.b0_7); } // 0x6D
-void sharpsm83::ld_l_memhl() { ld_from_address(HL.Lo.b0_7, HL.b0_15); } // 0x6E
-void sharpsm83::ld_l_a() { ld(HL.Lo.b0_7, AF.Hi.b0_7); } // 0x6F
-//##############################################################################
-void sharpsm83::ld_memhl_b() { ld_to_address(HL.b0_15, BC.Hi.b0_7); } // 0x70
-void sharpsm83::ld_memhl_c() { ld_to_address(HL.b0_15, BC.Lo.b0_7); } // 0x71
-void sharpsm83::ld_memhl_d() { ld_to_address(HL.b0_15, DE.Hi.b0_7); } // 0x72
-void sharpsm83::ld_memhl_e() { ld_to_address(HL.b0_15, DE.Lo.b0_7); } // 0x73
-void sharpsm83::ld_memhl_h() { ld_to_address(HL.b0_15, HL.Hi.b0_7); } // 0x74
-void sharpsm83::ld_memhl_l() { ld_to_address(HL.b0_15, HL.Lo.b0_7); } // 0x75
-void sharpsm83::halt() { execute_halt(); } // 0x76
-void sharpsm83::ld_memhl_a(){ ld_to_address(HL.b0_15, AF.Hi.b0_7); } // 0x77
-void sharpsm83::ld_a_b() { ld(AF.Hi.b0_7, BC.Hi.b0_7); } // 0x78
-void sharpsm83::ld_a_c() { ld(AF.Hi.b0_7, BC.Lo.b0_7); } // 0x79
-void sharpsm83::ld_a_d() { ld(AF.Hi.b0_7, DE.Hi.b0_7); } // 0x7A
-void sharpsm83::ld_a_e() { ld(AF.Hi.b0_7, DE.Lo.b0_7); } // 0x7B
-void sharpsm83::ld_a_h() { ld(AF.Hi.b0_7, HL.Hi.b0_7); } // 0x7C
-void sharpsm83::ld_a_l() { ld(AF.Hi.b0_7, HL.Lo.b0_7); } // 0x7D
-void sharpsm83::ld_a_memhl() { ld_from_address(AF.Hi.b0_7, HL.b0_15); } // 0x7E
-void sharpsm83::ld_a_a() { ld(AF.Hi.b0_7, AF.Hi.b0_7); } // 0x7F
-//##############################################################################
-void sharpsm83::add_a_b() { add(AF.Hi.b0_7, BC.Hi.b0_7); } //0x80
-void sharpsm83::add_a_c() { add(AF.Hi.b0_7, BC.Lo.b0_7); } //0x81
-void sharpsm83::add_a_d() { add(AF.Hi.b0_7, DE.Hi.b0_7); } //0x82
-void sharpsm83::add_a_e() { add(AF.Hi.b0_7, DE.Lo.b0_7); } //0x83
-void sharpsm83::add_a_h() { add(AF.Hi.b0_7, HL.Hi.b0_7); } //0x84
-void sharpsm83::add_a_l() { add(AF.Hi.b0_7, HL.Lo.b0_7); } //0x85
-void sharpsm83::add_a_memhl() { add_from_address(AF.Hi.b0_7, HL.b0_15); } //0x86
-void sharpsm83::add_a_a() { add(AF.Hi.b0_7, AF.Hi.b0_7); } //0x87
-void sharpsm83::adc_a_b() { adc(AF.Hi.b0_7, BC.Hi.b0_7); } //0x88
-void sharpsm83::adc_a_c() { adc(AF.Hi.b0_7, BC.Lo.b0_7); } //0x89
-void sharpsm83::adc_a_d() { adc(AF.Hi.b0_7, DE.Hi.b0_7); } //0x8A
-void sharpsm83::adc_a_e() { adc(AF.Hi.b0_7, DE.Lo.b0_7); } //0x8B
-void sharpsm83::adc_a_h() { adc(AF.Hi.b0_7, HL.Hi.b0_7); } //0x8C
-void sharpsm83::adc_a_l() { adc(AF.Hi.b0_7, HL.Lo.b0_7); } //0x8D
-void sharpsm83::adc_a_memhl() { adc_from_address(AF.Hi.b0_7, HL.b0_15); } //0x8E
-void sharpsm83::adc_a_a() { adc(AF.Hi.b0_7, AF.Hi.b0_7); } //0x8F
-//##############################################################################
-void sharpsm83::sub_a_b() { sub(AF.Hi.b0_7, BC.Hi.b0_7); } //0x90
-void sharpsm83::sub_a_c() { sub(AF.Hi.b0_7, BC.Lo.b0_7); } //0x91
-void sharpsm83::sub_a_d() { sub(AF.Hi.b0_7, DE.Hi.b0_7); } //0x92
-void sharpsm83::sub_a_e() { sub(AF.Hi.b0_7, DE.Lo.b0_7); } //0x93
-void sharpsm83::sub_a_h() { sub(AF.Hi.b0_7, HL.Hi.b0_7); } //0x94
-void sharpsm83::sub_a_l() { sub(AF.Hi.b0_7, HL.Lo.b0_7); } //0x95
-void sharpsm83::sub_a_memhl(){ sub_from_address(AF.Hi.b0_7, HL.b0_15); } //0x96
-void sharpsm83::sub_a_a() { sub(AF.Hi.b0_7, AF.Hi.b0_7); } //0x97
-void sharpsm83::sbc_a_b() { sbc(AF.Hi.b0_7, BC.Hi.b0_7); } //0x98
-void sharpsm83::sbc_a_c() { sbc(AF.Hi.b0_7, BC.Lo.b0_7); } //0x99
-void sharpsm83::sbc_a_d() { sbc(AF.Hi.b0_7, DE.Hi.b0_7); } //0x9A
-void sharpsm83::sbc_a_e() { sbc(AF.Hi.b0_7, DE.Lo.b0_7); } //0x9B
-void sharpsm83::sbc_a_h() { sbc(AF.Hi.b0_7, HL.Hi.b0_7); } //0x9C
-void sharpsm83::sbc_a_l() { sbc(AF.Hi.b0_7, HL.Lo.b0_7); } //0x9D
-void sharpsm83::sbc_a_memhl() { sbc_from_address(AF.Hi.b0_7, HL.b0_15); } //0x9E
-void sharpsm83::sbc_a_a() { sbc(AF.Hi.b0_7, AF.Hi.b0_7); } //0x9F
-//##############################################################################
-void sharpsm83::and_a_b() { and_op(AF.Hi.b0_7, BC.Hi.b0_7); } //0xA0
-void sharpsm83::and_a_c() { and_op(AF.Hi.b0_7, BC.Lo.b0_7); } //0xA1
-void sharpsm83::and_a_d() { and_op(AF.Hi.b0_7, DE.Hi.b0_7); } //0xA2
-void sharpsm83::and_a_e() { and_op(AF.Hi.b0_7, DE.Lo.b0_7); } //0xA3
-void sharpsm83::and_a_h() { and_op(AF.Hi.b0_7, HL.Hi.b0_7); } //0xA4
-void sharpsm83::and_a_l() { and_op(AF.Hi.b0_7, HL.Lo.b0_7); } //0xA5
-void sharpsm83::and_a_memhl() { and_op_from_address(AF.Hi.b0_7, HL.b0_15); } //0xA6
-void sharpsm83::and_a_a() { and_op(AF.Hi.b0_7, AF.Hi.b0_7); } //0xA7
-void sharpsm83::xor_a_b() { xor_op(AF.Hi.b0_7, BC.Hi.b0_7); } //0xA8
-void sharpsm83::xor_a_c() { xor_op(AF.Hi.b0_7, BC.Lo.b0_7); } //0xA9
-void sharpsm83::xor_a_d() { xor_op(AF.Hi.b0_7, DE.Hi.b0_7); } //0xAA
-void sharpsm83::xor_a_e() { xor_op(AF.Hi.b0_7, DE.Lo.b0_7); } //0xAB
-void sharpsm83::xor_a_h() { xor_op(AF.Hi.b0_7, HL.Hi.b0_7); } //0xAC
-void sharpsm83::xor_a_l() { xor_op(AF.Hi.b0_7, HL.Lo.b0_7); } //0xAD
-void sharpsm83::xor_a_memhl() { xor_op_from_address(AF.Hi.b0_7, HL.b0_15); } //0xAE
-void sharpsm83::xor_a_a() { xor_op(AF.Hi.b0_7, AF.Hi.b0_7); } //0xAF
-//##############################################################################
-void sharpsm83::or_a_b() { or_op(AF.Hi.b0_7, BC.Hi.b0_7); } //0xB0
-void sharpsm83::or_a_c() { or_op(AF.Hi.b0_7, BC.Lo.b0_7); } //0xB1
-void sharpsm83::or_a_d() { or_op(AF.Hi.b0_7, DE.Hi.b0_7); } //0xB2
-void sharpsm83::or_a_e() { or_op(AF.Hi.b0_7, DE.Lo.b0_7); } //0xB3
-void sharpsm83::or_a_h() { or_op(AF.Hi.b0_7, HL.Hi.b0_7); } //0xB4
-void sharpsm83::or_a_l() { or_op(AF.Hi.b0_7, HL.Lo.b0_7); } //0xB5
-void sharpsm83::or_a_memhl() { or_op_from_address(AF.Hi.b0_7, HL.b0_15); } //0xB6
-void sharpsm83::or_a_a() { or_op(AF.Hi.b0_7, AF.Hi.b0_7); } //0xB7
-void sharpsm83::cp_a_b() { cp_op(AF.Hi.b0_7, BC.Hi.b0_7); } //0xB8
-void sharpsm83::cp_a_c() { cp_op(AF.Hi.b0_7, BC.Lo.b0_7); } //0xB9
-void sharpsm83::cp_a_d() { cp_op(AF.Hi.b0_7, DE.Hi.b0_7); } //0xBA
-void sharpsm83::cp_a_e() { cp_op(AF.Hi.b0_7, DE.Lo.b0_7); } //0xBB
-void sharpsm83::cp_a_h() { cp_op(AF.Hi.b0_7, HL.Hi.b0_7); } //0xBC
-void sharpsm83::cp_a_l() { cp_op(AF.Hi.b0_7, HL.Lo.b0_7); } //0xBD
-void sharpsm83::cp_a_memhl() { cp_op_from_address(AF.Hi.b0_7, HL.b0_15); } //0xBE
-void sharpsm83::cp_a_a()  { cp_op(AF.Hi.b0_7, AF.Hi.b0_7); } //0xBF
-//##############################################################################
-void sharpsm83::ret_nz() { ret_condition(!get_zero_flag()); } // 0xC0
-void sharpsm83::pop_bc() { pop(BC); } // 0xC1
-void sharpsm83::jp_nz_imm16() { jp(!get_zero_flag()); } // 0xC2
-void sharpsm83::jp_imm16() { jp(true); } // 0xC3
-void sharpsm83::call_nz_imm16() { call(!get_zero_flag()); } // 0xC4
-void sharpsm83::push_bc() { push(BC); } // 0xC5
-void sharpsm83::add_a_imm8() { add(AF.Hi); } // 0xC6
-void sharpsm83::rst_0x00() { rst( (uint16_t)0x0000 ); }// 0xC7
-void sharpsm83::ret_z() { ret_condition(get_zero_flag());  } //0xC8
-void sharpsm83::ret() { ret_op(); } //0xC9
-void sharpsm83::jp_z_imm16() { jp(get_zero_flag()); }  //0xCA
-void sharpsm83::prefix() { }  // 0xCB
-void sharpsm83::call_z_imm16() { call(get_zero_flag()); } // 0xCC
-void sharpsm83::call_imm16() { call(true); } // 0xCD
-void sharpsm83::adc_a_imm8() { adc(AF.Hi); } // 0xCE
-void sharpsm83::rst_0x08() { rst( (uint16_t)0x0008 ); } // 0xCF
-//##############################################################################
-void sharpsm83::ret_nc() { ret_condition(!get_carry_flag()); } // 0xD0
-void sharpsm83::pop_de() { pop(DE); } // 0xD1
-void sharpsm83::jp_nc_imm16() { jp(!get_carry_flag()); } // 0xD2
-void sharpsm83::op_0xD3() {  } // 0xD3
-void sharpsm83::call_nc_imm16() { call(!get_carry_flag()); } // 0xD4
-void sharpsm83::push_de() { push(DE); } // 0xD5
-void sharpsm83::sub_a_imm8() { sub(AF.Hi); } // 0xD6
-void sharpsm83::rst_0x10() {  rst( (uint16_t)0x0010 ); } // 0xD7
-void sharpsm83::ret_c() { ret_condition(get_carry_flag()); } // 0xD8
-void sharpsm83::reti() { reti_op(); } // 0xD9
-void sharpsm83::jp_c_imm16() { jp(get_carry_flag()); } // 0xDA
-void sharpsm83::op_0xDB() { } // 0xDB
-void sharpsm83::call_c_a16() { call(get_carry_flag()); } // 0xDC
-void sharpsm83::op_0xDD() { } // 0xDD
-void sharpsm83::sbc_a_imm8() { sbc(AF.Hi); }// 0xDE
-void sharpsm83::rst_0x18() { rst( (uint16_t)0x0018 ); } // 0xDF
-//##############################################################################
-void sharpsm83::ldh_memimm8_a() { ldh_to_address(AF.Hi); } // 0xE0
-void sharpsm83::pop_hl() { pop(HL); } // 0xE1
-void sharpsm83::ldh_memc_a() { ldh_to_address(BC.Lo, AF.Hi); } // 0xE2
-void sharpsm83::op_0xE3() {  } // 0xE3
-void sharpsm83::op_0xE4() {  } // 0xE4
-void sharpsm83::push_hl() { push(HL); } // 0xE5
-void sharpsm83::and_a_imm8() { and_op(AF.Hi); } // 0xE6
-void sharpsm83::rst_0x20() { rst( (uint16_t)0x0020 ); } // 0xE7
-void sharpsm83::add_sp_e8() { add_e8(SP); } // 0xE8
-void sharpsm83::jp_hl() { jp(HL.b0_15); } // 0xE9
-void sharpsm83::ld_memimm16_a() { ld_to_address(AF.Hi); } // 0xEA
-void sharpsm83::op_0xEB() { } // 0xEB
-void sharpsm83::op_0xEC() { } // 0xEC
-void sharpsm83::op_0xED() { } // 0xED
-void sharpsm83::xor_a_imm8() { xor_op(AF.Hi); } // 0xEE
-void sharpsm83::rst_0x28() { rst( (uint16_t)0x0028 ); }// 0xEF
-//##############################################################################
-void sharpsm83::ldh_a_memimm8(){ ldh_from_address(AF.Hi); } // 0xF0
-void sharpsm83::pop_af() { pop_af_op(); } // 0xF1
-void sharpsm83::ldh_a_memc() { ldh_from_address(AF.Hi, BC.Lo); } // 0xF2
-void sharpsm83::di() { disable_interrupts(); } // 0xF3
-void sharpsm83::op_0xF4() { }
-void sharpsm83::push_af() { push_af_op(); } // 0xF5
-void sharpsm83::or_a_imm8() { or_op(AF.Hi); } // 0xF6
-void sharpsm83::rst_0x30() { rst( (uint16_t)0x0030 ); } // 0xF7
-void sharpsm83::ld_hl_sp_e8() { ld_hl_reg_e8(SP); } // 0xF8
-void sharpsm83::ld_sp_hl() { ld_sp_hl_op(); } // 0xF9   
-void sharpsm83::ld_a_memimm16() { ld_a_memimm16_op(); } // 0xFA
-void sharpsm83::ei() { enable_interrupts(); } // 0xFB
-void sharpsm83::op_0xFC() { } // 0xFC
-void sharpsm83::op_0xFD() { } // 0xFD
-void sharpsm83::cp_a_imm8() { cp_op(AF.Hi); } // 0xFE
-void sharpsm83::rst_0x38() { rst( (uint16_t)0x0038 ); } // 0xFF
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::nop() { execute_nop(); } // 0x00
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_bc_imm16() { ld(BC()); } // 0x01
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_membc_a() { ld_to_address(BC(), regs.A); } // 0x02
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_bc() { inc(BC()); } // 0x03
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_b() { inc(regs.B); } // 0x04
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_b() { dec(regs.B); } // 0x05
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_b_imm8() { ld(regs.B); } // 0x06
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rlca() { rlc(regs.A); } // 0x07
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memimm16_sp() { ld_sp();}  // 0x08
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_hl_bc() { add(HL(), BC()); } // 0x09
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_membc() { ld_from_address(regs.A, BC()); } // 0x0A
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_bc() { dec(BC()); } // 0x0B
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_c() { inc(regs.C); } // 0x0C
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_c() { dec(regs.C); } // 0x0D
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_c_imm8() { ld(regs.C); } // 0x0E
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rrca() { rrc(regs.A); } // 0x0F
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::stop_imm8() { execute_stop(); }// 0x10
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_de_imm16() {ld(DE());} // 0x11
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memde_a() { ld_to_address(DE(), regs.A); } // 0x12
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_de(){ inc(DE()); }; // 0x13
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_d(){ inc(regs.D); }; // 0x14
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_d(){ dec(regs.D); }; // 0x15
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_d_imm8() { ld(regs.D); } // 0x16
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rla() { rl(regs.A); } // 0x17
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jr_e8() { jr(true); } // 0x18
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_hl_de() { add(HL(), DE()); } // 0x19
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_memde() { ld_from_address(regs.A, DE()); } // 0x1A
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_de() { dec(DE()); } // 0x1B
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_e() { inc(regs.E); } // 0x1C
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_e() { dec(regs.E); } // 0x1D
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_e_imm8() { ld(regs.E); } // 0x1E
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rra() { rr(regs.A); } // 0x1F
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jr_nz_e8() { jr(!get_zero_flag()); }; // 0x20
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_hl_imm16() { ld(HL()); } // 0x21
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memhlinc_a() { ld_to_address(HL()++, regs.A); } // 0x22
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_hl() { inc(HL()); } // 0x23
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_h() { inc(regs.H); } // 0x24
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_h() { dec(regs.H); } // 0x25
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_h_imm8() { ld(regs.H); } // 0x26
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::daa() { da(regs.A); } // 0x27
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jr_z_e8() { jr(get_zero_flag()); } // 0x28
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_hl_hl() { add(HL(), HL()); } // 0x29
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_memhlinc() { ld_from_address(regs.A, HL()++); }  // 0x2A
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_hl() { dec(HL()); } // 0x2B
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_l() { inc(regs.L);  } // 0x2C
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_l() { dec(regs.L);  } // 0x2D
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_l_imm8() { ld(regs.L);  } // 0x2E
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cpl() { complement(regs.A); } // 0x2F
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jr_nc_e8() { jr(!get_carry_flag()); } // 0x30
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_sp_imm16() { ld(regs.SP); } // 0x31
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memhldec_a() { ld_to_address(HL()--, regs.A); } // 0x32
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_sp() { inc(regs.SP); } // 0x33
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_memhl() { inc_mem(HL()); } // 0x34
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_memhl() { dec_mem(HL()); } // 0x35
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memhl_imm8() { ld_to_address(HL()); }  // 0x36
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::scf() { set_carry_flag(); } // 0x37
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jr_c_e8() { jr(get_carry_flag()); } // 0x38
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_hl_sp() { add(HL(), regs.SP); } // 0x39
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_memhldec() { ld_from_address(regs.A, HL()--); } // 0x3A
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_sp() { dec(regs.SP); } // 0x3B
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::inc_a() { inc(regs.A); } // 0x3C
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::dec_a() { dec(regs.A); } // 0x3D
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_imm8() { ld(regs.A); } // 0x3E
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ccf(){ complement_carry_flag(); }// 0x3F
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_b_b() { ld(regs.B, regs.B); } // 0x40
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_b_c() { ld(regs.B, regs.C); } // 0x41
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_b_d() { ld(regs.B, regs.D); } // 0x42
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_b_e() { ld(regs.B, regs.E); } // 0x43
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_b_h() { ld(regs.B, regs.H); } // 0x44
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_b_l() { ld(regs.B, regs.L); } // 0x45
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_b_memhl( ) { ld_from_address(regs.B, HL()); } // 0x46
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_b_a() { ld(regs.B, regs.A); } // 0x47
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_c_b() { ld(regs.C, regs.B); } // 0x48
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_c_c() { ld(regs.C, regs.C); } // 0x49
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_c_d() { ld(regs.C, regs.D); } // 0x4A
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_c_e() { ld(regs.C, regs.E); } // 0x4B
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_c_h() { ld(regs.C, regs.H); } // 0x4C
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_c_l() { ld(regs.C, regs.L); } // 0x4D
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_c_memhl(){ ld_from_address(regs.C, HL()); } // 0x4E
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_c_a() { ld(regs.C, regs.A); } // 0x4F
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_d_b() { ld(regs.D, regs.B); } // 0x50
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_d_c() { ld(regs.D, regs.C); } // 0x51
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_d_d() { ld(regs.D, regs.D); } // 0x52
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_d_e() { ld(regs.D, regs.E); } // 0x53
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_d_h() { ld(regs.D, regs.H); } // 0x54
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_d_l() { ld(regs.D, regs.L); } // 0x55
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_d_memhl() { ld_from_address(regs.D, HL()); } // 0x56
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_d_a() { ld(regs.D, regs.A); } // 0x57
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_e_b() { ld(regs.E, regs.B); } // 0x58
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_e_c() { ld(regs.E, regs.C); } // 0x59
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_e_d() { ld(regs.E, regs.D); } // 0x5A
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_e_e() { ld(regs.E, regs.E); } // 0x5B
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_e_h() { ld(regs.E, regs.H); } // 0x5C
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_e_l() { ld(regs.E, regs.L); } // 0x5D
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_e_memhl() { ld_from_address(regs.E, HL()); } // 0x5E
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_e_a() { ld(regs.E, regs.A); } // 0x5F
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_h_b() { ld(regs.H, regs.B); } // 0x60
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_h_c() { ld(regs.H, regs.C); } // 0x61
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_h_d() { ld(regs.H, regs.D); } // 0x62
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_h_e() { ld(regs.H, regs.E); } // 0x63
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_h_h() { ld(regs.H, regs.H); } // 0x64
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_h_l() { ld(regs.H, regs.L); } // 0x65
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_h_memhl() { ld_from_address(regs.H, HL()); } // 0x66
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_h_a() { ld(regs.H, regs.A); } // 0x67
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_l_b() { ld(regs.L, regs.B); } // 0x68
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_l_c() { ld(regs.L, regs.C); } // 0x69
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_l_d() { ld(regs.L, regs.D); } // 0x6A
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_l_e() { ld(regs.L, regs.E); } // 0x6B
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_l_h() { ld(regs.L, regs.H); } // 0x6C
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_l_l() { ld(regs.L, regs.L); } // 0x6D
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_l_memhl() { ld_from_address(regs.L, HL()); } // 0x6E
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_l_a() { ld(regs.L, regs.A); } // 0x6F
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memhl_b() { ld_to_address(HL(), regs.B); } // 0x70
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memhl_c() { ld_to_address(HL(), regs.C); } // 0x71
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memhl_d() { ld_to_address(HL(), regs.D); } // 0x72
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memhl_e() { ld_to_address(HL(), regs.E); } // 0x73
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memhl_h() { ld_to_address(HL(), regs.H); } // 0x74
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memhl_l() { ld_to_address(HL(), regs.L); } // 0x75
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::halt() { execute_halt(); } // 0x76
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memhl_a(){ ld_to_address(HL(), regs.A); } // 0x77
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_b() { ld(regs.A, regs.B); } // 0x78
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_c() { ld(regs.A, regs.C); } // 0x79
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_d() { ld(regs.A, regs.D); } // 0x7A
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_e() { ld(regs.A, regs.E); } // 0x7B
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_h() { ld(regs.A, regs.H); } // 0x7C
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_l() { ld(regs.A, regs.L); } // 0x7D
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_memhl() { ld_from_address(regs.A, HL()); } // 0x7E
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_a() { ld(regs.A, regs.A); } // 0x7F
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_a_b() { add(regs.A, regs.B); } //0x80
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_a_c() { add(regs.A, regs.C); } //0x81
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_a_d() { add(regs.A, regs.D); } //0x82
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_a_e() { add(regs.A, regs.E); } //0x83
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_a_h() { add(regs.A, regs.H); } //0x84
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_a_l() { add(regs.A, regs.L); } //0x85
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_a_memhl() { add_from_address(regs.A, HL()); } //0x86
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_a_a() { add(regs.A, regs.A); } //0x87
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc_a_b() { adc(regs.A, regs.B); } //0x88
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc_a_c() { adc(regs.A, regs.C); } //0x89
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc_a_d() { adc(regs.A, regs.D); } //0x8A
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc_a_e() { adc(regs.A, regs.E); } //0x8B
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc_a_h() { adc(regs.A, regs.H); } //0x8C
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc_a_l() { adc(regs.A, regs.L); } //0x8D
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc_a_memhl() { adc_from_address(regs.A, HL()); } //0x8E
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc_a_a() { adc(regs.A, regs.A); } //0x8F
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub_a_b() { sub(regs.A, regs.B); } //0x90
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub_a_c() { sub(regs.A, regs.C); } //0x91
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub_a_d() { sub(regs.A, regs.D); } //0x92
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub_a_e() { sub(regs.A, regs.E); } //0x93
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub_a_h() { sub(regs.A, regs.H); } //0x94
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub_a_l() { sub(regs.A, regs.L); } //0x95
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub_a_memhl(){ sub_from_address(regs.A, HL()); } //0x96
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub_a_a() { sub(regs.A, regs.A); } //0x97
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc_a_b() { sbc(regs.A, regs.B); } //0x98
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc_a_c() { sbc(regs.A, regs.C); } //0x99
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc_a_d() { sbc(regs.A, regs.D); } //0x9A
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc_a_e() { sbc(regs.A, regs.E); } //0x9B
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc_a_h() { sbc(regs.A, regs.H); } //0x9C
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc_a_l() { sbc(regs.A, regs.L); } //0x9D
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc_a_memhl() { sbc_from_address(regs.A, HL()); } //0x9E
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc_a_a() { sbc(regs.A, regs.A); } //0x9F
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_a_b() { and_op(regs.A, regs.B); } //0xA0
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_a_c() { and_op(regs.A, regs.C); } //0xA1
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_a_d() { and_op(regs.A, regs.D); } //0xA2
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_a_e() { and_op(regs.A, regs.E); } //0xA3
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_a_h() { and_op(regs.A, regs.H); } //0xA4
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_a_l() { and_op(regs.A, regs.L); } //0xA5
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_a_memhl() { and_op_from_address(regs.A, HL()); } //0xA6
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_a_a() { and_op(regs.A, regs.A); } //0xA7
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_a_b() { xor_op(regs.A, regs.B); } //0xA8
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_a_c() { xor_op(regs.A, regs.C); } //0xA9
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_a_d() { xor_op(regs.A, regs.D); } //0xAA
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_a_e() { xor_op(regs.A, regs.E); } //0xAB
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_a_h() { xor_op(regs.A, regs.H); } //0xAC
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_a_l() { xor_op(regs.A, regs.L); } //0xAD
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_a_memhl() { xor_op_from_address(regs.A, HL()); } //0xAE
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_a_a() { xor_op(regs.A, regs.A); } //0xAF
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_a_b() { or_op(regs.A, regs.B); } //0xB0
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_a_c() { or_op(regs.A, regs.C); } //0xB1
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_a_d() { or_op(regs.A, regs.D); } //0xB2
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_a_e() { or_op(regs.A, regs.E); } //0xB3
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_a_h() { or_op(regs.A, regs.H); } //0xB4
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_a_l() { or_op(regs.A, regs.L); } //0xB5
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_a_memhl() { or_op_from_address(regs.A, HL()); } //0xB6
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_a_a() { or_op(regs.A, regs.A); } //0xB7
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_a_b() { cp_op(regs.A, regs.B); } //0xB8
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_a_c() { cp_op(regs.A, regs.C); } //0xB9
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_a_d() { cp_op(regs.A, regs.D); } //0xBA
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_a_e() { cp_op(regs.A, regs.E); } //0xBB
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_a_h() { cp_op(regs.A, regs.H); } //0xBC
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_a_l() { cp_op(regs.A, regs.L); } //0xBD
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_a_memhl() { cp_op_from_address(regs.A, HL()); } //0xBE
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_a_a()  { cp_op(regs.A, regs.A); } //0xBF
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ret_nz() { ret_condition(!get_zero_flag()); } // 0xC0
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::pop_bc() { pop(BC()); } // 0xC1
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jp_nz_imm16() { jp(!get_zero_flag()); } // 0xC2
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jp_imm16() { jp(true); } // 0xC3
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::call_nz_imm16() { call(!get_zero_flag()); } // 0xC4
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::push_bc() { push(BC()); } // 0xC5
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_a_imm8() { add(regs.A); } // 0xC6
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rst_0x00() { rst( (uint16_t)0x0000 ); }// 0xC7
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ret_z() { ret_condition(get_zero_flag());  } //0xC8
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ret() { ret_op(); } //0xC9
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jp_z_imm16() { jp(get_zero_flag()); }  //0xCA
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::prefix() { }  // 0xCB
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::call_z_imm16() { call(get_zero_flag()); } // 0xCC
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::call_imm16() { call(true); } // 0xCD
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::adc_a_imm8() { adc(regs.A); } // 0xCE
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rst_0x08() { rst( (uint16_t)0x0008 ); } // 0xCF
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ret_nc() { ret_condition(!get_carry_flag()); } // 0xD0
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::pop_de() { pop(DE()); } // 0xD1
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jp_nc_imm16() { jp(!get_carry_flag()); } // 0xD2
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::op_0xD3() {  } // 0xD3
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::call_nc_imm16() { call(!get_carry_flag()); } // 0xD4
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::push_de() { push(DE()); } // 0xD5
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sub_a_imm8() { sub(regs.A); } // 0xD6
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rst_0x10() {  rst( (uint16_t)0x0010 ); } // 0xD7
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ret_c() { ret_condition(get_carry_flag()); } // 0xD8
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::reti() { reti_op(); } // 0xD9
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jp_c_imm16() { jp(get_carry_flag()); } // 0xDA
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::op_0xDB() { } // 0xDB
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::call_c_a16() { call(get_carry_flag()); } // 0xDC
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::op_0xDD() { } // 0xDD
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sbc_a_imm8() { sbc(regs.A); }// 0xDE
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rst_0x18() { rst( (uint16_t)0x0018 ); } // 0xDF
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ldh_memimm8_a() { ldh_to_address(regs.A); } // 0xE0
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::pop_hl() { pop(HL()); } // 0xE1
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ldh_memc_a() { ldh_to_address(regs.C, regs.A); } // 0xE2
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::op_0xE3() {  } // 0xE3
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::op_0xE4() {  } // 0xE4
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::push_hl() { push(HL()); } // 0xE5
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::and_a_imm8() { and_op(regs.A); } // 0xE6
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rst_0x20() { rst( (uint16_t)0x0020 ); } // 0xE7
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::add_sp_e8() { add_e8(regs.SP); } // 0xE8
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::jp_hl() { jp(HL()); } // 0xE9
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_memimm16_a() { ld_to_address(regs.A); } // 0xEA
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::op_0xEB() { } // 0xEB
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::op_0xEC() { } // 0xEC
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::op_0xED() { } // 0xED
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::xor_a_imm8() { xor_op(regs.A); } // 0xEE
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rst_0x28() { rst( (uint16_t)0x0028 ); }// 0xEF
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ldh_a_memimm8(){ ldh_from_address(regs.A); } // 0xF0
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::pop_af() { pop_af_op(); } // 0xF1
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ldh_a_memc() { ldh_from_address(regs.A, regs.C); } // 0xF2
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::di() { disable_interrupts(); } // 0xF3
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::op_0xF4() { }
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::push_af() { push_af_op(); } // 0xF5
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::or_a_imm8() { or_op(regs.A); } // 0xF6
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rst_0x30() { rst( (uint16_t)0x0030 ); } // 0xF7
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_hl_sp_e8() { ld_hl_reg_e8(regs.SP); } // 0xF8
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_sp_hl() { ld_sp_hl_op(); } // 0xF9   
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ld_a_memimm16() { ld_a_memimm16_op(); } // 0xFA
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::ei() { enable_interrupts(); } // 0xFB
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::op_0xFC() { } // 0xFC
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::op_0xFD() { } // 0xFD
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::cp_a_imm8() { cp_op(regs.A); } // 0xFE
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::rst_0x38() { rst( (uint16_t)0x0038 ); } // 0xFF
 //##############################################################################
 // 0xCB instructions
 //##############################################################################
-void sharpsm83::rlc_b() { rlc_param(BC.Hi); } // Ox00
-void sharpsm83::rlc_c() { rlc_param(BC.Lo); } // Ox01
-void sharpsm83::rlc_d() { rlc_param(DE.Hi); } // Ox02
-void sharpsm83::rlc_e() { rlc_param(DE.Lo); } // Ox03
-void sharpsm83::rlc_h() { rlc_param(HL.Hi); } // Ox04
-void sharpsm83::rlc_l() { rlc_param(HL.Lo); } // Ox05
-void sharpsm83::rlc_memhl() { rlcmem_param(HL.b0_15); } // Ox06
-void sharpsm83::rlc_a() { rlc_param(AF.Hi); } // Ox07
-
-void sharpsm83::rrc_b() { rrc_param(BC.Hi); } // Ox08
-void sharpsm83::rrc_c() { rrc_param(BC.Lo); } // Ox09
-void sharpsm83::rrc_d() { rrc_param(DE.Hi); } // Ox0A
-void sharpsm83::rrc_e() { rrc_param(DE.Lo); } // Ox0B
-void sharpsm83::rrc_h() { rrc_param(HL.Hi); } // Ox0C
-void sharpsm83::rrc_l() { rrc_param(HL.Lo); } // Ox0D
-void sharpsm83::rrc_memhl() {rrcmem_param(HL.b0_15);} // Ox0E
-void sharpsm83::rrc_a() { rrc_param(AF.Hi); } // Ox0F
-
-void sharpsm83::rl_b() { rl_param(BC.Hi); } // Ox10
-void sharpsm83::rl_c() { rl_param(BC.Lo); } // Ox11
-void sharpsm83::rl_d() { rl_param(DE.Hi); } // Ox12
-void sharpsm83::rl_e() { rl_param(DE.Lo); } // Ox13
-void sharpsm83::rl_h() { rl_param(HL.Hi); } // Ox14
-void sharpsm83::rl_l() { rl_param(HL.Lo); } // Ox15
-void sharpsm83::rl_memhl() { rlmem_param(HL.b0_15); } // Ox16
-void sharpsm83::rl_a() { rl_param(AF.Hi); } // Ox17
-void sharpsm83::rr_b() { rr_param(BC.Hi); } // Ox18
-void sharpsm83::rr_c() { rr_param(BC.Lo); } // Ox19
-void sharpsm83::rr_d() { rr_param(DE.Hi); } // Ox1A
-void sharpsm83::rr_e() { rr_param(DE.Lo); } // Ox1B
-void sharpsm83::rr_h() { rr_param(HL.Hi); } // Ox1C
-void sharpsm83::rr_l() { rr_param(HL.Lo); } // Ox1D
-void sharpsm83::rr_memhl() { rrmem_param(HL.b0_15); } // Ox1E
-void sharpsm83::rr_a() { rr_param(AF.Hi); } // Ox1F
-
-void sharpsm83::sla_b() { sla_param(BC.Hi); } // Ox20
-void sharpsm83::sla_c() { sla_param(BC.Lo); } // Ox21
-void sharpsm83::sla_d() { sla_param(DE.Hi); } // Ox22
-void sharpsm83::sla_e() { sla_param(DE.Lo); } // Ox23
-void sharpsm83::sla_h() { sla_param(HL.Hi); } // Ox24
-void sharpsm83::sla_l() { sla_param(HL.Lo); } // Ox25
-void sharpsm83::sla_memhl() { slamem_param(HL.b0_15); } // Ox26
-void sharpsm83::sla_a() { sla_param(AF.Hi); } // Ox27
-
-void sharpsm83::sra_b() { sra_param(BC.Hi); } // Ox28
-void sharpsm83::sra_c() { sra_param(BC.Lo); } // Ox29
-void sharpsm83::sra_d() { sra_param(DE.Hi); } // Ox2A
-void sharpsm83::sra_e() { sra_param(DE.Lo); } // Ox2B
-void sharpsm83::sra_h() { sra_param(HL.Hi); } // Ox2C
-void sharpsm83::sra_l() { sra_param(HL.Lo); } // Ox2D
-void sharpsm83::sra_memhl() {sramem_param(HL.b0_15);} // Ox2E
-void sharpsm83::sra_a() { sra_param(AF.Hi); } // Ox2F
-
-void sharpsm83::swap_b() { swap_param(BC.Hi); } // Ox30
-void sharpsm83::swap_c() { swap_param(BC.Lo); } // Ox31
-void sharpsm83::swap_d() { swap_param(DE.Hi); } // Ox32
-void sharpsm83::swap_e() { swap_param(DE.Lo); } // Ox33
-void sharpsm83::swap_h() { swap_param(HL.Hi); } // Ox34
-void sharpsm83::swap_l() { swap_param(HL.Lo); } // Ox35
-void sharpsm83::swap_memhl() { swapmem_param(HL.b0_15); } // Ox36
-void sharpsm83::swap_a() { swap_param(AF.Hi); } // Ox37
-
-void sharpsm83::srl_b() { srl_param(BC.Hi); } // Ox38
-void sharpsm83::srl_c() { srl_param(BC.Lo); } // Ox39
-void sharpsm83::srl_d() { srl_param(DE.Hi); } // Ox3A
-void sharpsm83::srl_e() { srl_param(DE.Lo); } // Ox3B
-void sharpsm83::srl_h() { srl_param(HL.Hi); } // Ox3C
-void sharpsm83::srl_l() { srl_param(HL.Lo); } // Ox3D
-void sharpsm83::srl_memhl() { srlmem_param(HL.b0_15); } // Ox3E
-void sharpsm83::srl_a() { srl_param(AF.Hi); } // Ox3F
-
-void sharpsm83::bit_0_b() { bit_param(0, BC.Hi); } // Ox40
-void sharpsm83::bit_0_c() { bit_param(0, BC.Lo); } // Ox41
-void sharpsm83::bit_0_d() { bit_param(0, DE.Hi); } // Ox42
-void sharpsm83::bit_0_e() { bit_param(0, DE.Lo); } // Ox43
-void sharpsm83::bit_0_h() { bit_param(0, HL.Hi); } // Ox44
-void sharpsm83::bit_0_l() { bit_param(0, HL.Lo); } // Ox45
-void sharpsm83::bit_0_memhl() { bitmem_param(0, HL.b0_15); } // Ox46
-void sharpsm83::bit_0_a() { bit_param(0, AF.Hi); } // Ox47
-
-void sharpsm83::bit_1_b() { bit_param(1, BC.Hi); } // Ox48
-void sharpsm83::bit_1_c() { bit_param(1, BC.Lo); } // Ox49
-void sharpsm83::bit_1_d() { bit_param(1, DE.Hi); } // Ox4A
-void sharpsm83::bit_1_e() { bit_param(1, DE.Lo); } // Ox4B
-void sharpsm83::bit_1_h() { bit_param(1, HL.Hi); } // Ox4C
-void sharpsm83::bit_1_l() { bit_param(1, HL.Lo); } // Ox4D
-void sharpsm83::bit_1_memhl() { bitmem_param(1, HL.b0_15); } // Ox4E
-void sharpsm83::bit_1_a() { bit_param(1, AF.Hi); } // Ox4F
-
-void sharpsm83::bit_2_b() { bit_param(2, BC.Hi); } // Ox50
-void sharpsm83::bit_2_c() { bit_param(2, BC.Lo); } // Ox51
-void sharpsm83::bit_2_d() { bit_param(2, DE.Hi); } // Ox52
-void sharpsm83::bit_2_e() { bit_param(2, DE.Lo); } // Ox53
-void sharpsm83::bit_2_h() { bit_param(2, HL.Hi); } // Ox54
-void sharpsm83::bit_2_l() { bit_param(2, HL.Lo); } // Ox55
-void sharpsm83::bit_2_memhl() { bitmem_param(2, HL.b0_15); } // Ox56
-void sharpsm83::bit_2_a() { bit_param(2, AF.Hi); } // Ox57
-
-void sharpsm83::bit_3_b() { bit_param(3, BC.Hi); } // Ox58
-void sharpsm83::bit_3_c() { bit_param(3, BC.Lo); } // Ox59
-void sharpsm83::bit_3_d() { bit_param(3, DE.Hi); } // Ox5A
-void sharpsm83::bit_3_e() { bit_param(3, DE.Lo); } // Ox5B
-void sharpsm83::bit_3_h() { bit_param(3, HL.Hi); } // Ox5C
-void sharpsm83::bit_3_l() { bit_param(3, HL.Lo); } // Ox5D
-void sharpsm83::bit_3_memhl() { bitmem_param(3, HL.b0_15); } // Ox5E
-void sharpsm83::bit_3_a() { bit_param(3, AF.Hi); } // Ox5F
-
-void sharpsm83::bit_4_b() { bit_param(4, BC.Hi); } // Ox60
-void sharpsm83::bit_4_c() { bit_param(4, BC.Lo); } // Ox61
-void sharpsm83::bit_4_d() { bit_param(4, DE.Hi); } // Ox62
-void sharpsm83::bit_4_e() { bit_param(4, DE.Lo); } // Ox63
-void sharpsm83::bit_4_h() { bit_param(4, HL.Hi); } // Ox64
-void sharpsm83::bit_4_l() { bit_param(4, HL.Lo); } // Ox65
-void sharpsm83::bit_4_memhl() { bitmem_param(4, HL.b0_15); } // Ox66
-void sharpsm83::bit_4_a() { bit_param(4, AF.Hi); } // Ox67
-
-void sharpsm83::bit_5_b() { bit_param(5, BC.Hi); } // Ox68
-void sharpsm83::bit_5_c() { bit_param(5, BC.Lo); } // Ox69
-void sharpsm83::bit_5_d() { bit_param(5, DE.Hi); } // Ox6A
-void sharpsm83::bit_5_e() { bit_param(5, DE.Lo); } // Ox6B
-void sharpsm83::bit_5_h() { bit_param(5, HL.Hi); } // Ox6C
-void sharpsm83::bit_5_l() { bit_param(5, HL.Lo); } // Ox6D
-void sharpsm83::bit_5_memhl() { bitmem_param(5, HL.b0_15); } // Ox6E
-void sharpsm83::bit_5_a() { bit_param(5, AF.Hi); } // Ox6F
-
-void sharpsm83::bit_6_b() { bit_param(6, BC.Hi); } // Ox70
-void sharpsm83::bit_6_c() { bit_param(6, BC.Lo); } // Ox71
-void sharpsm83::bit_6_d() { bit_param(6, DE.Hi); } // Ox72
-void sharpsm83::bit_6_e() { bit_param(6, DE.Lo); } // Ox73
-void sharpsm83::bit_6_h() { bit_param(6, HL.Hi); } // Ox74
-void sharpsm83::bit_6_l() { bit_param(6, HL.Lo); } // Ox75
-void sharpsm83::bit_6_memhl() { bitmem_param(6, HL.b0_15); } // Ox76
-void sharpsm83::bit_6_a() { bit_param(6, AF.Hi); } // Ox77
-
-void sharpsm83::bit_7_b() { bit_param(7, BC.Hi); } // Ox78
-void sharpsm83::bit_7_c() { bit_param(7, BC.Lo); } // Ox79
-void sharpsm83::bit_7_d() { bit_param(7, DE.Hi); } // Ox7A
-void sharpsm83::bit_7_e() { bit_param(7, DE.Lo); } // Ox7B
-void sharpsm83::bit_7_h() { bit_param(7, HL.Hi); } // Ox7C
-void sharpsm83::bit_7_l() { bit_param(7, HL.Lo); } // Ox7D
-void sharpsm83::bit_7_memhl() { bitmem_param(7, HL.b0_15); } // Ox7E
-void sharpsm83::bit_7_a() { bit_param(7, AF.Hi); } // Ox7F
-
-void sharpsm83::res_0_b() { res_param(0, BC.Hi); } // Ox80
-void sharpsm83::res_0_c() { res_param(0, BC.Lo); } // Ox81
-void sharpsm83::res_0_d() { res_param(0, DE.Hi); } // Ox82
-void sharpsm83::res_0_e() { res_param(0, DE.Lo); } // Ox83
-void sharpsm83::res_0_h() { res_param(0, HL.Hi); } // Ox84
-void sharpsm83::res_0_l() { res_param(0, HL.Lo); } // Ox85
-void sharpsm83::res_0_memhl() { resmem_param(0, HL.b0_15); } // Ox86
-void sharpsm83::res_0_a() { res_param(0, AF.Hi); } // Ox87
-void sharpsm83::res_1_b() { res_param(1, BC.Hi); } // Ox88
-void sharpsm83::res_1_c() { res_param(1, BC.Lo); } // Ox89
-void sharpsm83::res_1_d() { res_param(1, DE.Hi); } // Ox8A
-void sharpsm83::res_1_e() { res_param(1, DE.Lo); } // Ox8B
-void sharpsm83::res_1_h() { res_param(1, HL.Hi); } // Ox8C
-void sharpsm83::res_1_l() { res_param(1, HL.Lo); } // Ox8D
-void sharpsm83::res_1_memhl() { resmem_param(1, HL.b0_15); } // Ox8E
-void sharpsm83::res_1_a() { res_param(1, AF.Hi); } // Ox8F
-void sharpsm83::res_2_b() { res_param(2, BC.Hi); } // Ox90
-void sharpsm83::res_2_c() { res_param(2, BC.Lo); } // Ox91
-void sharpsm83::res_2_d() { res_param(2, DE.Hi); } // Ox92
-void sharpsm83::res_2_e() { res_param(2, DE.Lo); } // Ox93
-void sharpsm83::res_2_h() { res_param(2, HL.Hi); } // Ox94
-void sharpsm83::res_2_l() { res_param(2, HL.Lo); } // Ox95
-void sharpsm83::res_2_memhl() { resmem_param(2, HL.b0_15); } // Ox96
-void sharpsm83::res_2_a() { res_param(2, AF.Hi); } // Ox97
-void sharpsm83::res_3_b() { res_param(3, BC.Hi); } // Ox98
-void sharpsm83::res_3_c() { res_param(3, BC.Lo); } // Ox99
-void sharpsm83::res_3_d() { res_param(3, DE.Hi); } // Ox9A
-void sharpsm83::res_3_e() { res_param(3, DE.Lo); } // Ox9B
-void sharpsm83::res_3_h() { res_param(3, HL.Hi); } // Ox9C
-void sharpsm83::res_3_l() { res_param(3, HL.Lo); } // Ox9D
-void sharpsm83::res_3_memhl() { resmem_param(3, HL.b0_15); } // Ox9E
-void sharpsm83::res_3_a() { res_param(3, AF.Hi); } // Ox9F
-void sharpsm83::res_4_b() { res_param(4, BC.Hi); } // OxA0
-void sharpsm83::res_4_c() { res_param(4, BC.Lo); } // OxA1
-void sharpsm83::res_4_d() { res_param(4, DE.Hi); } // OxA2
-void sharpsm83::res_4_e() { res_param(4, DE.Lo); } // OxA3
-void sharpsm83::res_4_h() { res_param(4, HL.Hi); } // OxA4
-void sharpsm83::res_4_l() { res_param(4, HL.Lo); } // OxA5
-void sharpsm83::res_4_memhl() { resmem_param(4, HL.b0_15); } // OxA6
-void sharpsm83::res_4_a() { res_param(4, AF.Hi); } // OxA7
-void sharpsm83::res_5_b() { res_param(5, BC.Hi); } // OxA8
-void sharpsm83::res_5_c() { res_param(5, BC.Lo); } // OxA9
-void sharpsm83::res_5_d() { res_param(5, DE.Hi); } // OxAA
-void sharpsm83::res_5_e() { res_param(5, DE.Lo); } // OxAB
-void sharpsm83::res_5_h() { res_param(5, HL.Hi); } // OxAC
-void sharpsm83::res_5_l() { res_param(5, HL.Lo); } // OxAD
-void sharpsm83::res_5_memhl() { resmem_param(5, HL.b0_15); } // OxAE
-void sharpsm83::res_5_a() { res_param(5, AF.Hi); } // OxAF
-void sharpsm83::res_6_b() { res_param(6, BC.Hi); } // OxB0
-void sharpsm83::res_6_c() { res_param(6, BC.Lo); } // OxB1
-void sharpsm83::res_6_d() { res_param(6, DE.Hi); } // OxB2
-void sharpsm83::res_6_e() { res_param(6, DE.Lo); } // OxB3
-void sharpsm83::res_6_h() { res_param(6, HL.Hi); } // OxB4
-void sharpsm83::res_6_l() { res_param(6, HL.Lo); } // OxB5
-void sharpsm83::res_6_memhl() { resmem_param(6, HL.b0_15); } // OxB6
-void sharpsm83::res_6_a() { res_param(6, AF.Hi); } // OxB7
-void sharpsm83::res_7_b() { res_param(7, BC.Hi); } // OxB8
-void sharpsm83::res_7_c() { res_param(7, BC.Lo); } // OxB9
-void sharpsm83::res_7_d() { res_param(7, DE.Hi); } // OxBA
-void sharpsm83::res_7_e() { res_param(7, DE.Lo); } // OxBB
-void sharpsm83::res_7_h() { res_param(7, HL.Hi); } // OxBC
-void sharpsm83::res_7_l() { res_param(7, HL.Lo); } // OxBD
-void sharpsm83::res_7_memhl() { resmem_param(7, HL.b0_15); } // OxBE
-void sharpsm83::res_7_a() { res_param(7, AF.Hi); } // OxBF
-void sharpsm83::set_0_b() { set_param(0, BC.Hi); } // OxC0
-void sharpsm83::set_0_c() { set_param(0, BC.Lo); } // OxC1
-void sharpsm83::set_0_d() { set_param(0, DE.Hi); } // OxC2
-void sharpsm83::set_0_e() { set_param(0, DE.Lo); } // OxC3
-void sharpsm83::set_0_h() { set_param(0, HL.Hi); } // OxC4
-void sharpsm83::set_0_l() { set_param(0, HL.Lo); } // OxC5
-void sharpsm83::set_0_memhl() { setmem_param(0, HL.b0_15); } // OxC6
-void sharpsm83::set_0_a() { set_param(0, AF.Hi); } // OxC7
-void sharpsm83::set_1_b() { set_param(1, BC.Hi); } // OxC8
-void sharpsm83::set_1_c() { set_param(1, BC.Lo); } // OxC9
-void sharpsm83::set_1_d() { set_param(1, DE.Hi); } // OxCA
-void sharpsm83::set_1_e() { set_param(1, DE.Lo); } // OxCB
-void sharpsm83::set_1_h() { set_param(1, HL.Hi); } // OxCC
-void sharpsm83::set_1_l() { set_param(1, HL.Lo); } // OxCD
-void sharpsm83::set_1_memhl() { setmem_param(1, HL.b0_15); } // OxCE
-void sharpsm83::set_1_a() { set_param(1, AF.Hi); } // OxCF
-void sharpsm83::set_2_b() { set_param(2, BC.Hi); } // OxD0
-void sharpsm83::set_2_c() { set_param(2, BC.Lo); } // OxD1
-void sharpsm83::set_2_d() { set_param(2, DE.Hi); } // OxD2
-void sharpsm83::set_2_e() { set_param(2, DE.Lo); } // OxD3
-void sharpsm83::set_2_h() { set_param(2, HL.Hi); } // OxD4
-void sharpsm83::set_2_l() { set_param(2, HL.Lo); } // OxD5
-void sharpsm83::set_2_memhl() { setmem_param(2, HL.b0_15); } // OxD6
-void sharpsm83::set_2_a() { set_param(2, AF.Hi); } // OxD7
-void sharpsm83::set_3_b() { set_param(3, BC.Hi); } // OxD8
-void sharpsm83::set_3_c() { set_param(3, BC.Lo); } // OxD9
-void sharpsm83::set_3_d() { set_param(3, DE.Hi); } // OxDA
-void sharpsm83::set_3_e() { set_param(3, DE.Lo); } // OxDB
-void sharpsm83::set_3_h() { set_param(3, HL.Hi); } // OxDC
-void sharpsm83::set_3_l() { set_param(3, HL.Lo); } // OxDD
-void sharpsm83::set_3_memhl() { setmem_param(3, HL.b0_15); } // OxDE
-void sharpsm83::set_3_a() { set_param(3, AF.Hi); } // OxDF
-void sharpsm83::set_4_b() { set_param(4, BC.Hi); } // OxE0
-void sharpsm83::set_4_c() { set_param(4, BC.Lo); } // OxE1
-void sharpsm83::set_4_d() { set_param(4, DE.Hi); } // OxE2
-void sharpsm83::set_4_e() { set_param(4, DE.Lo); } // OxE3
-void sharpsm83::set_4_h() { set_param(4, HL.Hi); } // OxE4
-void sharpsm83::set_4_l() { set_param(4, HL.Lo); } // OxE5
-void sharpsm83::set_4_memhl() { setmem_param(4, HL.b0_15); } // OxE6
-void sharpsm83::set_4_a() { set_param(4, AF.Hi); } // OxE7
-void sharpsm83::set_5_b() { set_param(5, BC.Hi); } // OxE8
-void sharpsm83::set_5_c() { set_param(5, BC.Lo); } // OxE9
-void sharpsm83::set_5_d() { set_param(5, DE.Hi); } // OxEA
-void sharpsm83::set_5_e() { set_param(5, DE.Lo); } // OxEB
-void sharpsm83::set_5_h() { set_param(5, HL.Hi); } // OxEC
-void sharpsm83::set_5_l() { set_param(5, HL.Lo); } // OxED
-void sharpsm83::set_5_memhl() { setmem_param(5, HL.b0_15); } // OxEE
-void sharpsm83::set_5_a() { set_param(5, AF.Hi); } // OxEF
-void sharpsm83::set_6_b() { set_param(6, BC.Hi); } // OxF0
-void sharpsm83::set_6_c() { set_param(6, BC.Lo); } // OxF1
-void sharpsm83::set_6_d() { set_param(6, DE.Hi); } // OxF2
-void sharpsm83::set_6_e() { set_param(6, DE.Lo); } // OxF3
-void sharpsm83::set_6_h() { set_param(6, HL.Hi); } // OxF4
-void sharpsm83::set_6_l() { set_param(6, HL.Lo); } // OxF5
-void sharpsm83::set_6_memhl() { setmem_param(6, HL.b0_15); } // OxF6
-void sharpsm83::set_6_a() { set_param(6, AF.Hi); } // OxF7
-void sharpsm83::set_7_b() { set_param(7, BC.Hi); } // OxF8
-void sharpsm83::set_7_c() { set_param(7, BC.Lo); } // OxF9
-void sharpsm83::set_7_d() { set_param(7, DE.Hi); } // OxFA
-void sharpsm83::set_7_e() { set_param(7, DE.Lo); } // OxFB
-void sharpsm83::set_7_h() { set_param(7, HL.Hi); } // OxFC
-void sharpsm83::set_7_l() { set_param(7, HL.Lo); } // OxFD
-void sharpsm83::set_7_memhl() { setmem_param(7, HL.b0_15); } // OxFE
-void sharpsm83::set_7_a() { set_param(7, AF.Hi); } // OxFF
-
-
-//##############################################################################
-void sharpsm83::emulate_cycles(int cycles)
+template<typename bus_type, typename timing_policy>
+template<uint8_t operand>
+uint8_t& basic_sharpsm83<bus_type, timing_policy>::cb_register()
+{
+    static_assert(operand != 0x06, "(HL) is not a register");
+
+    switch(operand)
+    {
+        case 0x00: return regs.B;
+        case 0x01: return regs.C;
+        case 0x02: return regs.D;
+        case 0x03: return regs.E;
+        case 0x04: return regs.H;
+        case 0x05: return regs.L;
+        default:   return regs.A;
+    }
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+template<uint8_t opcode>
+void basic_sharpsm83<bus_type, timing_policy>::cb_instruction()
+{
+    constexpr uint8_t group = opcode >> 6;
+    constexpr uint8_t bit = (opcode >> 3) & 0x07;
+    constexpr uint8_t operand = opcode & 0x07;
+    constexpr bool memory = operand == 0x06;
+
+    if constexpr(group == 0x00)
+    {
+        // rotations and shifts, bit is the operation
+        if constexpr(memory)
+        {
+            switch(bit)
+            {
+                case 0: rlcmem_param(HL()); break;
+                case 1: rrcmem_param(HL()); break;
+                case 2: rlmem_param(HL()); break;
+                case 3: rrmem_param(HL()); break;
+                case 4: slamem_param(HL()); break;
+                case 5: sramem_param(HL()); break;
+                case 6: swapmem_param(HL()); break;
+                case 7: srlmem_param(HL()); break;
+            }
+        }
+        else
+        {
+            uint8_t& reg = cb_register<operand>();
+
+            switch(bit)
+            {
+                case 0: rlc_param(reg); break;
+                case 1: rrc_param(reg); break;
+                case 2: rl_param(reg); break;
+                case 3: rr_param(reg); break;
+                case 4: sla_param(reg); break;
+                case 5: sra_param(reg); break;
+                case 6: swap_param(reg); break;
+                case 7: srl_param(reg); break;
+            }
+        }
+    }
+    else if constexpr(group == 0x01)
+    {
+        if constexpr(memory) bitmem_param(bit, HL());
+        else bit_param(bit, cb_register<operand>());
+    }
+    else if constexpr(group == 0x02)
+    {
+        if constexpr(memory) resmem_param(bit, HL());
+        else res_param(bit, cb_register<operand>());
+    }
+    else
+    {
+        if constexpr(memory) setmem_param(bit, HL());
+        else set_param(bit, cb_register<operand>());
+    }
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::emulate_cycles(int cycles)
 {
     cycle_count += cycles;
 
-    bus->tick(cycles);
-}
-//##############################################################################
-void sharpsm83::initialize_opcodes() 
-{
-    opcode_table[0x00] = std::bind(&sharpsm83::nop, this);
-    opcode_table[0x01] = std::bind(&sharpsm83::ld_bc_imm16, this);
-    opcode_table[0x02] = std::bind(&sharpsm83::ld_membc_a, this);
-    opcode_table[0x03] = std::bind(&sharpsm83::inc_bc, this);
-    opcode_table[0x04] = std::bind(&sharpsm83::inc_b, this);
-    opcode_table[0x05] = std::bind(&sharpsm83::dec_b, this);
-    opcode_table[0x06] = std::bind(&sharpsm83::ld_b_imm8, this);
-    opcode_table[0x07] = std::bind(&sharpsm83::rlca, this);
-    opcode_table[0x08] = std::bind(&sharpsm83::ld_memimm16_sp, this);
-    opcode_table[0x09] = std::bind(&sharpsm83::add_hl_bc, this);
-    opcode_table[0x0A] = std::bind(&sharpsm83::ld_a_membc, this);
-    opcode_table[0x0B] = std::bind(&sharpsm83::dec_bc, this);
-    opcode_table[0x0C] = std::bind(&sharpsm83::inc_c, this);
-    opcode_table[0x0D] = std::bind(&sharpsm83::dec_c, this);
-    opcode_table[0x0E] = std::bind(&sharpsm83::ld_c_imm8, this);
-    opcode_table[0x0F] = std::bind(&sharpsm83::rrca, this);
-
-    opcode_table[0x10] = std::bind(&sharpsm83::stop_imm8, this);
-    opcode_table[0x11] = std::bind(&sharpsm83::ld_de_imm16, this);
-    opcode_table[0x12] = std::bind(&sharpsm83::ld_memde_a, this);
-    opcode_table[0x13] = std::bind(&sharpsm83::inc_de, this);
-    opcode_table[0x14] = std::bind(&sharpsm83::inc_d, this);
-    opcode_table[0x15] = std::bind(&sharpsm83::dec_d, this);
-    opcode_table[0x16] = std::bind(&sharpsm83::ld_d_imm8, this);
-    opcode_table[0x17] = std::bind(&sharpsm83::rla, this);
-    opcode_table[0x18] = std::bind(&sharpsm83::jr_e8, this);
-    opcode_table[0x19] = std::bind(&sharpsm83::add_hl_de, this);
-    opcode_table[0x1A] = std::bind(&sharpsm83::ld_a_memde, this);
-    opcode_table[0x1B] = std::bind(&sharpsm83::dec_de, this);
-    opcode_table[0x1C] = std::bind(&sharpsm83::inc_e, this);
-    opcode_table[0x1D] = std::bind(&sharpsm83::dec_e, this);
-    opcode_table[0x1E] = std::bind(&sharpsm83::ld_e_imm8, this);
-    opcode_table[0x1F] = std::bind(&sharpsm83::rra, this);
-    
-    opcode_table[0x20] = std::bind(&sharpsm83::jr_nz_e8, this);
-    opcode_table[0x21] = std::bind(&sharpsm83::ld_hl_imm16, this);
-    opcode_table[0x22] = std::bind(&sharpsm83::ld_memhlinc_a, this);
-    opcode_table[0x23] = std::bind(&sharpsm83::inc_hl, this);
-    opcode_table[0x24] = std::bind(&sharpsm83::inc_h, this);
-    opcode_table[0x25] = std::bind(&sharpsm83::dec_h, this);
-    opcode_table[0x26] = std::bind(&sharpsm83::ld_h_imm8, this);
-    opcode_table[0x27] = std::bind(&sharpsm83::daa, this);
-    opcode_table[0x28] = std::bind(&sharpsm83::jr_z_e8, this);
-    opcode_table[0x29] = std::bind(&sharpsm83::add_hl_hl, this);
-    opcode_table[0x2A] = std::bind(&sharpsm83::ld_a_memhlinc, this);
-    opcode_table[0x2B] = std::bind(&sharpsm83::dec_hl, this);
-    opcode_table[0x2C] = std::bind(&sharpsm83::inc_l, this);
-    opcode_table[0x2D] = std::bind(&sharpsm83::dec_l, this);
-    opcode_table[0x2E] = std::bind(&sharpsm83::ld_l_imm8, this);
-    opcode_table[0x2F] = std::bind(&sharpsm83::cpl, this);
-
-    opcode_table[0x30] = std::bind(&sharpsm83::jr_nc_e8, this);
-    opcode_table[0x31] = std::bind(&sharpsm83::ld_sp_imm16, this);
-    opcode_table[0x32] = std::bind(&sharpsm83::ld_memhldec_a, this);
-    opcode_table[0x33] = std::bind(&sharpsm83::inc_sp, this);
-    opcode_table[0x34] = std::bind(&sharpsm83::inc_memhl, this);
-    opcode_table[0x35] = std::bind(&sharpsm83::dec_memhl, this);
-    opcode_table[0x36] = std::bind(&sharpsm83::ld_memhl_imm8, this);
-    opcode_table[0x37] = std::bind(&sharpsm83::scf, this);
-    opcode_table[0x38] = std::bind(&sharpsm83::jr_c_e8, this);
-    opcode_table[0x39] = std::bind(&sharpsm83::add_hl_sp, this);
-    opcode_table[0x3A] = std::bind(&sharpsm83::ld_a_memhldec, this);
-    opcode_table[0x3B] = std::bind(&sharpsm83::dec_sp, this);
-    opcode_table[0x3C] = std::bind(&sharpsm83::inc_a, this);
-    opcode_table[0x3D] = std::bind(&sharpsm83::dec_a, this);
-    opcode_table[0x3E] = std::bind(&sharpsm83::ld_a_imm8, this);
-    opcode_table[0x3F] = std::bind(&sharpsm83::ccf, this);
-
-    opcode_table[0x40] = std::bind(&sharpsm83::ld_b_b, this);
-    opcode_table[0x41] = std::bind(&sharpsm83::ld_b_c, this);
-    opcode_table[0x42] = std::bind(&sharpsm83::ld_b_d, this);
-    opcode_table[0x43] = std::bind(&sharpsm83::ld_b_e, this);
-    opcode_table[0x44] = std::bind(&sharpsm83::ld_b_h, this);
-    opcode_table[0x45] = std::bind(&sharpsm83::ld_b_l, this);
-    opcode_table[0x46] = std::bind(&sharpsm83::ld_b_memhl, this);
-    opcode_table[0x47] = std::bind(&sharpsm83::ld_b_a, this);
-    opcode_table[0x48] = std::bind(&sharpsm83::ld_c_b, this);
-    opcode_table[0x49] = std::bind(&sharpsm83::ld_c_c, this);
-    opcode_table[0x4A] = std::bind(&sharpsm83::ld_c_d, this);
-    opcode_table[0x4B] = std::bind(&sharpsm83::ld_c_e, this);
-    opcode_table[0x4C] = std::bind(&sharpsm83::ld_c_h, this);
-    opcode_table[0x4D] = std::bind(&sharpsm83::ld_c_l, this);
-    opcode_table[0x4E] = std::bind(&sharpsm83::ld_c_memhl, this);
-    opcode_table[0x4F] = std::bind(&sharpsm83::ld_c_a, this);
-
-    opcode_table[0x50] = std::bind(&sharpsm83::ld_d_b, this);
-    opcode_table[0x51] = std::bind(&sharpsm83::ld_d_c, this);
-    opcode_table[0x52] = std::bind(&sharpsm83::ld_d_d, this);
-    opcode_table[0x53] = std::bind(&sharpsm83::ld_d_e, this);
-    opcode_table[0x54] = std::bind(&sharpsm83::ld_d_h, this);
-    opcode_table[0x55] = std::bind(&sharpsm83::ld_d_l, this);
-    opcode_table[0x56] = std::bind(&sharpsm83::ld_d_memhl, this);
-    opcode_table[0x57] = std::bind(&sharpsm83::ld_d_a, this);
-    opcode_table[0x58] = std::bind(&sharpsm83::ld_e_b, this);
-    opcode_table[0x59] = std::bind(&sharpsm83::ld_e_c, this);
-    opcode_table[0x5A] = std::bind(&sharpsm83::ld_e_d, this);
-    opcode_table[0x5B] = std::bind(&sharpsm83::ld_e_e, this);
-    opcode_table[0x5C] = std::bind(&sharpsm83::ld_e_h, this);
-    opcode_table[0x5D] = std::bind(&sharpsm83::ld_e_l, this);
-    opcode_table[0x5E] = std::bind(&sharpsm83::ld_e_memhl, this);
-    opcode_table[0x5F] = std::bind(&sharpsm83::ld_e_a, this);
-
-    opcode_table[0x60] = std::bind(&sharpsm83::ld_h_b, this);
-    opcode_table[0x61] = std::bind(&sharpsm83::ld_h_c, this);
-    opcode_table[0x62] = std::bind(&sharpsm83::ld_h_d, this);
-    opcode_table[0x63] = std::bind(&sharpsm83::ld_h_e, this);
-    opcode_table[0x64] = std::bind(&sharpsm83::ld_h_h, this);
-    opcode_table[0x65] = std::bind(&sharpsm83::ld_h_l, this);
-    opcode_table[0x66] = std::bind(&sharpsm83::ld_h_memhl, this);
-    opcode_table[0x67] = std::bind(&sharpsm83::ld_h_a, this);
-    opcode_table[0x68] = std::bind(&sharpsm83::ld_l_b, this);
-    opcode_table[0x69] = std::bind(&sharpsm83::ld_l_c, this);
-    opcode_table[0x6A] = std::bind(&sharpsm83::ld_l_d, this);
-    opcode_table[0x6B] = std::bind(&sharpsm83::ld_l_e, this);
-    opcode_table[0x6C] = std::bind(&sharpsm83::ld_l_h, this);
-    opcode_table[0x6D] = std::bind(&sharpsm83::ld_l_l, this);
-    opcode_table[0x6E] = std::bind(&sharpsm83::ld_l_memhl, this);
-    opcode_table[0x6F] = std::bind(&sharpsm83::ld_l_a, this);
-
-    opcode_table[0x70] = std::bind(&sharpsm83::ld_memhl_b, this);
-    opcode_table[0x71] = std::bind(&sharpsm83::ld_memhl_c, this);
-    opcode_table[0x72] = std::bind(&sharpsm83::ld_memhl_d, this);
-    opcode_table[0x73] = std::bind(&sharpsm83::ld_memhl_e, this);
-    opcode_table[0x74] = std::bind(&sharpsm83::ld_memhl_h, this);
-    opcode_table[0x75] = std::bind(&sharpsm83::ld_memhl_l, this);
-    opcode_table[0x76] = std::bind(&sharpsm83::halt, this);
-    opcode_table[0x77] = std::bind(&sharpsm83::ld_memhl_a, this);
-    opcode_table[0x78] = std::bind(&sharpsm83::ld_a_b, this);
-    opcode_table[0x79] = std::bind(&sharpsm83::ld_a_c, this);
-    opcode_table[0x7A] = std::bind(&sharpsm83::ld_a_d, this);
-    opcode_table[0x7B] = std::bind(&sharpsm83::ld_a_e, this);
-    opcode_table[0x7C] = std::bind(&sharpsm83::ld_a_h, this);
-    opcode_table[0x7D] = std::bind(&sharpsm83::ld_a_l, this);
-    opcode_table[0x7E] = std::bind(&sharpsm83::ld_a_memhl, this);
-    opcode_table[0x7F] = std::bind(&sharpsm83::ld_a_a, this);
-
-    opcode_table[0x80] = std::bind(&sharpsm83::add_a_b, this);
-    opcode_table[0x81] = std::bind(&sharpsm83::add_a_c, this);
-    opcode_table[0x82] = std::bind(&sharpsm83::add_a_d, this);
-    opcode_table[0x83] = std::bind(&sharpsm83::add_a_e, this);
-    opcode_table[0x84] = std::bind(&sharpsm83::add_a_h, this);
-    opcode_table[0x85] = std::bind(&sharpsm83::add_a_l, this);
-    opcode_table[0x86] = std::bind(&sharpsm83::add_a_memhl, this);
-    opcode_table[0x87] = std::bind(&sharpsm83::add_a_a, this);
-    opcode_table[0x88] = std::bind(&sharpsm83::adc_a_b, this);
-    opcode_table[0x89] = std::bind(&sharpsm83::adc_a_c, this);
-    opcode_table[0x8A] = std::bind(&sharpsm83::adc_a_d, this);
-    opcode_table[0x8B] = std::bind(&sharpsm83::adc_a_e, this);
-    opcode_table[0x8C] = std::bind(&sharpsm83::adc_a_h, this);
-    opcode_table[0x8D] = std::bind(&sharpsm83::adc_a_l, this);
-    opcode_table[0x8E] = std::bind(&sharpsm83::adc_a_memhl, this);
-    opcode_table[0x8F] = std::bind(&sharpsm83::adc_a_a, this);
-
-    opcode_table[0x90] = std::bind(&sharpsm83::sub_a_b, this);
-    opcode_table[0x91] = std::bind(&sharpsm83::sub_a_c, this);
-    opcode_table[0x92] = std::bind(&sharpsm83::sub_a_d, this);
-    opcode_table[0x93] = std::bind(&sharpsm83::sub_a_e, this);
-    opcode_table[0x94] = std::bind(&sharpsm83::sub_a_h, this);
-    opcode_table[0x95] = std::bind(&sharpsm83::sub_a_l, this);
-    opcode_table[0x96] = std::bind(&sharpsm83::sub_a_memhl, this);
-    opcode_table[0x97] = std::bind(&sharpsm83::sub_a_a, this);
-    opcode_table[0x98] = std::bind(&sharpsm83::sbc_a_b, this);
-    opcode_table[0x99] = std::bind(&sharpsm83::sbc_a_c, this);
-    opcode_table[0x9A] = std::bind(&sharpsm83::sbc_a_d, this);
-    opcode_table[0x9B] = std::bind(&sharpsm83::sbc_a_e, this);
-    opcode_table[0x9C] = std::bind(&sharpsm83::sbc_a_h, this);
-    opcode_table[0x9D] = std::bind(&sharpsm83::sbc_a_l, this);
-    opcode_table[0x9E] = std::bind(&sharpsm83::sbc_a_memhl, this);
-    opcode_table[0x9F] = std::bind(&sharpsm83::sbc_a_a, this);  
-
-    opcode_table[0xA0] = std::bind(&sharpsm83::and_a_b, this);  
-    opcode_table[0xA1] = std::bind(&sharpsm83::and_a_c, this);  
-    opcode_table[0xA2] = std::bind(&sharpsm83::and_a_d, this);  
-    opcode_table[0xA3] = std::bind(&sharpsm83::and_a_e, this);  
-    opcode_table[0xA4] = std::bind(&sharpsm83::and_a_h, this);  
-    opcode_table[0xA5] = std::bind(&sharpsm83::and_a_l, this);  
-    opcode_table[0xA6] = std::bind(&sharpsm83::and_a_memhl, this);  
-    opcode_table[0xA7] = std::bind(&sharpsm83::and_a_a, this);  
-    opcode_table[0xA8] = std::bind(&sharpsm83::xor_a_b, this);  
-    opcode_table[0xA9] = std::bind(&sharpsm83::xor_a_c, this);  
-    opcode_table[0xAA] = std::bind(&sharpsm83::xor_a_d, this);  
-    opcode_table[0xAB] = std::bind(&sharpsm83::xor_a_e, this);  
-    opcode_table[0xAC] = std::bind(&sharpsm83::xor_a_h, this);  
-    opcode_table[0xAD] = std::bind(&sharpsm83::xor_a_l, this);  
-    opcode_table[0xAE] = std::bind(&sharpsm83::xor_a_memhl, this);  
-    opcode_table[0xAF] = std::bind(&sharpsm83::xor_a_a, this);  
-
-    opcode_table[0xB0] = std::bind(&sharpsm83::or_a_b, this);  
-    opcode_table[0xB1] = std::bind(&sharpsm83::or_a_c, this);  
-    opcode_table[0xB2] = std::bind(&sharpsm83::or_a_d, this);  
-    opcode_table[0xB3] = std::bind(&sharpsm83::or_a_e, this);  
-    opcode_table[0xB4] = std::bind(&sharpsm83::or_a_h, this);  
-    opcode_table[0xB5] = std::bind(&sharpsm83::or_a_l, this);  
-    opcode_table[0xB6] = std::bind(&sharpsm83::or_a_memhl, this);  
-    opcode_table[0xB7] = std::bind(&sharpsm83::or_a_a, this);  
-    opcode_table[0xB8] = std::bind(&sharpsm83::cp_a_b, this);  
-    opcode_table[0xB9] = std::bind(&sharpsm83::cp_a_c, this);  
-    opcode_table[0xBA] = std::bind(&sharpsm83::cp_a_d, this);  
-    opcode_table[0xBB] = std::bind(&sharpsm83::cp_a_e, this);  
-    opcode_table[0xBC] = std::bind(&sharpsm83::cp_a_h, this);  
-    opcode_table[0xBD] = std::bind(&sharpsm83::cp_a_l, this);
-    opcode_table[0xBE] = std::bind(&sharpsm83::cp_a_memhl, this); 
-    opcode_table[0xBF] = std::bind(&sharpsm83::cp_a_a, this);
-
-    opcode_table[0xC0] = std::bind(&sharpsm83::ret_nz, this);
-    opcode_table[0xC1] = std::bind(&sharpsm83::pop_bc, this);
-    opcode_table[0xC2] = std::bind(&sharpsm83::jp_nz_imm16, this);
-    opcode_table[0xC3] = std::bind(&sharpsm83::jp_imm16, this);
-    opcode_table[0xC4] = std::bind(&sharpsm83::call_nz_imm16, this);
-    opcode_table[0xC5] = std::bind(&sharpsm83::push_bc, this);
-    opcode_table[0xC6] = std::bind(&sharpsm83::add_a_imm8, this);
-    opcode_table[0xC7] = std::bind(&sharpsm83::rst_0x00, this);
-    opcode_table[0xC8] = std::bind(&sharpsm83::ret_z, this);
-    opcode_table[0xC9] = std::bind(&sharpsm83::ret, this);
-    opcode_table[0xCA] = std::bind(&sharpsm83::jp_z_imm16, this);
-    opcode_table[0xCB] = std::bind(&sharpsm83::prefix, this);
-    opcode_table[0xCC] = std::bind(&sharpsm83::call_z_imm16, this);
-    opcode_table[0xCD] = std::bind(&sharpsm83::call_imm16, this);
-    opcode_table[0xCE] = std::bind(&sharpsm83::adc_a_imm8, this);
-    opcode_table[0xCF] = std::bind(&sharpsm83::rst_0x08, this);
-
-    opcode_table[0xD0] = std::bind(&sharpsm83::ret_nc, this);
-    opcode_table[0xD1] = std::bind(&sharpsm83::pop_de, this);
-    opcode_table[0xD2] = std::bind(&sharpsm83::jp_nc_imm16, this);
-    opcode_table[0xD3] = std::bind(&sharpsm83::op_0xD3, this);
-    opcode_table[0xD4] = std::bind(&sharpsm83::call_nc_imm16, this);
-    opcode_table[0xD5] = std::bind(&sharpsm83::push_de, this);
-    opcode_table[0xD6] = std::bind(&sharpsm83::sub_a_imm8, this);
-    opcode_table[0xD7] = std::bind(&sharpsm83::rst_0x10, this);
-    opcode_table[0xD8] = std::bind(&sharpsm83::ret_c, this);
-    opcode_table[0xD9] = std::bind(&sharpsm83::reti, this);
-    opcode_table[0xDA] = std::bind(&sharpsm83::jp_c_imm16, this);
-    opcode_table[0xDB] = std::bind(&sharpsm83::op_0xDB, this);
-    opcode_table[0xDC] = std::bind(&sharpsm83::call_c_a16, this);
-    opcode_table[0xDD] = std::bind(&sharpsm83::op_0xDD, this);
-    opcode_table[0xDE] = std::bind(&sharpsm83::sbc_a_imm8, this);
-    opcode_table[0xDF] = std::bind(&sharpsm83::rst_0x18, this);
-
-    opcode_table[0xE0] = std::bind(&sharpsm83::ldh_memimm8_a, this);
-    opcode_table[0xE1] = std::bind(&sharpsm83::pop_hl, this);
-    opcode_table[0xE2] = std::bind(&sharpsm83::ldh_memc_a, this);
-    opcode_table[0xE3] = std::bind(&sharpsm83::op_0xE3, this);
-    opcode_table[0xE4] = std::bind(&sharpsm83::op_0xE4, this);
-    opcode_table[0xE5] = std::bind(&sharpsm83::push_hl, this);
-    opcode_table[0xE6] = std::bind(&sharpsm83::and_a_imm8, this);
-    opcode_table[0xE7] = std::bind(&sharpsm83::rst_0x20, this);
-    opcode_table[0xE8] = std::bind(&sharpsm83::add_sp_e8, this);
-    opcode_table[0xE9] = std::bind(&sharpsm83::jp_hl, this);
-    opcode_table[0xEA] = std::bind(&sharpsm83::ld_memimm16_a, this);
-    opcode_table[0xEB] = std::bind(&sharpsm83::op_0xEB, this);
-    opcode_table[0xEC] = std::bind(&sharpsm83::op_0xEC, this);
-    opcode_table[0xED] = std::bind(&sharpsm83::op_0xED, this);
-    opcode_table[0xEE] = std::bind(&sharpsm83::xor_a_imm8, this);
-    opcode_table[0xEF] = std::bind(&sharpsm83::rst_0x28, this);
-
-    opcode_table[0xF0] = std::bind(&sharpsm83::ldh_a_memimm8, this);
-    opcode_table[0xF1] = std::bind(&sharpsm83::pop_af, this);
-    opcode_table[0xF2] = std::bind(&sharpsm83::ldh_a_memc, this);
-    opcode_table[0xF3] = std::bind(&sharpsm83::di, this);
-    opcode_table[0xF4] = std::bind(&sharpsm83::op_0xF4, this);
-    opcode_table[0xF5] = std::bind(&sharpsm83::push_af, this);
-    opcode_table[0xF6] = std::bind(&sharpsm83::or_a_imm8, this);
-    opcode_table[0xF7] = std::bind(&sharpsm83::rst_0x30, this);
-    opcode_table[0xF8] = std::bind(&sharpsm83::ld_hl_sp_e8, this);
-    opcode_table[0xF9] = std::bind(&sharpsm83::ld_sp_hl, this);
-    opcode_table[0xFA] = std::bind(&sharpsm83::ld_a_memimm16, this);
-    opcode_table[0xFB] = std::bind(&sharpsm83::ei, this);
-    opcode_table[0xFC] = std::bind(&sharpsm83::op_0xFC, this);
-    opcode_table[0xFD] = std::bind(&sharpsm83::op_0xFD, this);
-    opcode_table[0xFE] = std::bind(&sharpsm83::cp_a_imm8, this);
-    opcode_table[0xFF] = std::bind(&sharpsm83::rst_0x38, this); 
-
-}
-
-void sharpsm83::initialize_cbopcodes() 
-{
-    CB_opcode_table[0x00] = std::bind(&sharpsm83::rlc_b, this);
-    CB_opcode_table[0x01] = std::bind(&sharpsm83::rlc_c, this);
-    CB_opcode_table[0x02] = std::bind(&sharpsm83::rlc_d, this);
-    CB_opcode_table[0x03] = std::bind(&sharpsm83::rlc_e, this);
-    CB_opcode_table[0x04] = std::bind(&sharpsm83::rlc_h, this);
-    CB_opcode_table[0x05] = std::bind(&sharpsm83::rlc_l, this);
-    CB_opcode_table[0x06] = std::bind(&sharpsm83::rlc_memhl, this);
-    CB_opcode_table[0x07] = std::bind(&sharpsm83::rlc_a, this);
-    CB_opcode_table[0x08] = std::bind(&sharpsm83::rrc_b, this);
-    CB_opcode_table[0x09] = std::bind(&sharpsm83::rrc_c, this);
-    CB_opcode_table[0x0A] = std::bind(&sharpsm83::rrc_d, this);
-    CB_opcode_table[0x0B] = std::bind(&sharpsm83::rrc_e, this);
-    CB_opcode_table[0x0C] = std::bind(&sharpsm83::rrc_h, this);
-    CB_opcode_table[0x0D] = std::bind(&sharpsm83::rrc_l, this);
-    CB_opcode_table[0x0E] = std::bind(&sharpsm83::rrc_memhl, this);
-    CB_opcode_table[0x0F] = std::bind(&sharpsm83::rrc_a, this);
-
-    CB_opcode_table[0x10] = std::bind(&sharpsm83::rl_b, this);
-    CB_opcode_table[0x11] = std::bind(&sharpsm83::rl_c, this);
-    CB_opcode_table[0x12] = std::bind(&sharpsm83::rl_d, this);
-    CB_opcode_table[0x13] = std::bind(&sharpsm83::rl_e, this);
-    CB_opcode_table[0x14] = std::bind(&sharpsm83::rl_h, this);
-    CB_opcode_table[0x15] = std::bind(&sharpsm83::rl_l, this);
-    CB_opcode_table[0x16] = std::bind(&sharpsm83::rl_memhl, this);
-    CB_opcode_table[0x17] = std::bind(&sharpsm83::rl_a, this);
-    CB_opcode_table[0x18] = std::bind(&sharpsm83::rr_b, this);
-    CB_opcode_table[0x19] = std::bind(&sharpsm83::rr_c, this);
-    CB_opcode_table[0x1A] = std::bind(&sharpsm83::rr_d, this);
-    CB_opcode_table[0x1B] = std::bind(&sharpsm83::rr_e, this);
- 
-    CB_opcode_table[0x1C] = std::bind(&sharpsm83::rr_h, this);
-    CB_opcode_table[0x1D] = std::bind(&sharpsm83::rr_l, this);
-    CB_opcode_table[0x1E] = std::bind(&sharpsm83::rr_memhl, this);
-    CB_opcode_table[0x1F] = std::bind(&sharpsm83::rr_a, this);
-
-    CB_opcode_table[0x20] = std::bind(&sharpsm83::sla_b, this);
-    CB_opcode_table[0x21] = std::bind(&sharpsm83::sla_c, this);
-    CB_opcode_table[0x22] = std::bind(&sharpsm83::sla_d, this);
-    CB_opcode_table[0x23] = std::bind(&sharpsm83::sla_e, this);
-    CB_opcode_table[0x24] = std::bind(&sharpsm83::sla_h, this);
-    CB_opcode_table[0x25] = std::bind(&sharpsm83::sla_l, this);
-    CB_opcode_table[0x26] = std::bind(&sharpsm83::sla_memhl, this);
-    CB_opcode_table[0x27] = std::bind(&sharpsm83::sla_a, this);
-    CB_opcode_table[0x28] = std::bind(&sharpsm83::sra_b, this);
-    CB_opcode_table[0x29] = std::bind(&sharpsm83::sra_c, this);
-    CB_opcode_table[0x2A] = std::bind(&sharpsm83::sra_d, this);
-    CB_opcode_table[0x2B] = std::bind(&sharpsm83::sra_e, this);
-    CB_opcode_table[0x2C] = std::bind(&sharpsm83::sra_h, this);
-    CB_opcode_table[0x2D] = std::bind(&sharpsm83::sra_l, this);
-    CB_opcode_table[0x2E] = std::bind(&sharpsm83::sra_memhl, this);
-    CB_opcode_table[0x2F] = std::bind(&sharpsm83::sra_a, this);
-
-    CB_opcode_table[0x30] = std::bind(&sharpsm83::swap_b, this);
-    CB_opcode_table[0x31] = std::bind(&sharpsm83::swap_c, this);
-    CB_opcode_table[0x32] = std::bind(&sharpsm83::swap_d, this);
-    CB_opcode_table[0x33] = std::bind(&sharpsm83::swap_e, this);
-    CB_opcode_table[0x34] = std::bind(&sharpsm83::swap_h, this);
-    CB_opcode_table[0x35] = std::bind(&sharpsm83::swap_l, this);
-    CB_opcode_table[0x36] = std::bind(&sharpsm83::swap_memhl, this);
-    CB_opcode_table[0x37] = std::bind(&sharpsm83::swap_a, this);
-    CB_opcode_table[0x38] = std::bind(&sharpsm83::srl_b, this);
-    CB_opcode_table[0x39] = std::bind(&sharpsm83::srl_c, this);
-    CB_opcode_table[0x3A] = std::bind(&sharpsm83::srl_d, this);
-    CB_opcode_table[0x3B] = std::bind(&sharpsm83::srl_e, this);
-    CB_opcode_table[0x3C] = std::bind(&sharpsm83::srl_h, this);
-    CB_opcode_table[0x3D] = std::bind(&sharpsm83::srl_l, this);
-    CB_opcode_table[0x3E] = std::bind(&sharpsm83::srl_memhl, this);
-    CB_opcode_table[0x3F] = std::bind(&sharpsm83::srl_a, this);
-
-    CB_opcode_table[0x40] = std::bind(&sharpsm83::bit_0_b, this);
-    CB_opcode_table[0x41] = std::bind(&sharpsm83::bit_0_c, this);
-    CB_opcode_table[0x42] = std::bind(&sharpsm83::bit_0_d, this);
-    CB_opcode_table[0x43] = std::bind(&sharpsm83::bit_0_e, this);
-    CB_opcode_table[0x44] = std::bind(&sharpsm83::bit_0_h, this);
-    CB_opcode_table[0x45] = std::bind(&sharpsm83::bit_0_l, this);
-    CB_opcode_table[0x46] = std::bind(&sharpsm83::bit_0_memhl, this);
-    CB_opcode_table[0x47] = std::bind(&sharpsm83::bit_0_a, this);
-    CB_opcode_table[0x48] = std::bind(&sharpsm83::bit_1_b, this);
-    CB_opcode_table[0x49] = std::bind(&sharpsm83::bit_1_c, this);
-    CB_opcode_table[0x4A] = std::bind(&sharpsm83::bit_1_d, this);
-    CB_opcode_table[0x4B] = std::bind(&sharpsm83::bit_1_e, this);
-    CB_opcode_table[0x4C] = std::bind(&sharpsm83::bit_1_h, this);
-    CB_opcode_table[0x4D] = std::bind(&sharpsm83::bit_1_l, this);
-    CB_opcode_table[0x4E] = std::bind(&sharpsm83::bit_1_memhl, this);
-    CB_opcode_table[0x4F] = std::bind(&sharpsm83::bit_1_a, this);
-
-    CB_opcode_table[0x50] = std::bind(&sharpsm83::bit_2_b, this);
-    CB_opcode_table[0x51] = std::bind(&sharpsm83::bit_2_c, this);
-    CB_opcode_table[0x52] = std::bind(&sharpsm83::bit_2_d, this);
-    CB_opcode_table[0x53] = std::bind(&sharpsm83::bit_2_e, this);
-    CB_opcode_table[0x54] = std::bind(&sharpsm83::bit_2_h, this);
-    CB_opcode_table[0x55] = std::bind(&sharpsm83::bit_2_l, this);
-    CB_opcode_table[0x56] = std::bind(&sharpsm83::bit_2_memhl, this);
-    CB_opcode_table[0x57] = std::bind(&sharpsm83::bit_2_a, this);
-    CB_opcode_table[0x58] = std::bind(&sharpsm83::bit_3_b, this);
-    CB_opcode_table[0x59] = std::bind(&sharpsm83::bit_3_c, this);
-    CB_opcode_table[0x5A] = std::bind(&sharpsm83::bit_3_d, this);
-    CB_opcode_table[0x5B] = std::bind(&sharpsm83::bit_3_e, this);
-    CB_opcode_table[0x5C] = std::bind(&sharpsm83::bit_3_h, this);
-    CB_opcode_table[0x5D] = std::bind(&sharpsm83::bit_3_l, this);
-    CB_opcode_table[0x5E] = std::bind(&sharpsm83::bit_3_memhl, this);
-    CB_opcode_table[0x5F] = std::bind(&sharpsm83::bit_3_a, this);
-
-    CB_opcode_table[0x60] = std::bind(&sharpsm83::bit_4_b, this);
-    CB_opcode_table[0x61] = std::bind(&sharpsm83::bit_4_c, this);
-    CB_opcode_table[0x62] = std::bind(&sharpsm83::bit_4_d, this);
-    CB_opcode_table[0x63] = std::bind(&sharpsm83::bit_4_e, this);
-    CB_opcode_table[0x64] = std::bind(&sharpsm83::bit_4_h, this);
-    CB_opcode_table[0x65] = std::bind(&sharpsm83::bit_4_l, this);
-    CB_opcode_table[0x66] = std::bind(&sharpsm83::bit_4_memhl, this);
-    CB_opcode_table[0x67] = std::bind(&sharpsm83::bit_4_a, this);
-    CB_opcode_table[0x68] = std::bind(&sharpsm83::bit_5_b, this);
-    CB_opcode_table[0x69] = std::bind(&sharpsm83::bit_5_c, this);
-    CB_opcode_table[0x6A] = std::bind(&sharpsm83::bit_5_d, this);
-    CB_opcode_table[0x6B] = std::bind(&sharpsm83::bit_5_e, this);
-    CB_opcode_table[0x6C] = std::bind(&sharpsm83::bit_5_h, this);
-    CB_opcode_table[0x6D] = std::bind(&sharpsm83::bit_5_l, this);
-    CB_opcode_table[0x6E] = std::bind(&sharpsm83::bit_5_memhl, this);
-    CB_opcode_table[0x6F] = std::bind(&sharpsm83::bit_5_a, this);
-
-    CB_opcode_table[0x70] = std::bind(&sharpsm83::bit_6_b, this);
-    CB_opcode_table[0x71] = std::bind(&sharpsm83::bit_6_c, this);
-    CB_opcode_table[0x72] = std::bind(&sharpsm83::bit_6_d, this);
-    CB_opcode_table[0x73] = std::bind(&sharpsm83::bit_6_e, this);
-    CB_opcode_table[0x74] = std::bind(&sharpsm83::bit_6_h, this);
-    CB_opcode_table[0x75] = std::bind(&sharpsm83::bit_6_l, this);
-    CB_opcode_table[0x76] = std::bind(&sharpsm83::bit_6_memhl, this);
-    CB_opcode_table[0x77] = std::bind(&sharpsm83::bit_6_a, this);
-    CB_opcode_table[0x78] = std::bind(&sharpsm83::bit_7_b, this);
-    CB_opcode_table[0x79] = std::bind(&sharpsm83::bit_7_c, this);
-    CB_opcode_table[0x7A] = std::bind(&sharpsm83::bit_7_d, this);
-    CB_opcode_table[0x7B] = std::bind(&sharpsm83::bit_7_e, this);
-    CB_opcode_table[0x7C] = std::bind(&sharpsm83::bit_7_h, this);
-    CB_opcode_table[0x7D] = std::bind(&sharpsm83::bit_7_l, this);
-    CB_opcode_table[0x7E] = std::bind(&sharpsm83::bit_7_memhl, this);
-    CB_opcode_table[0x7F] = std::bind(&sharpsm83::bit_7_a, this);
-
-    CB_opcode_table[0x80] = std::bind(&sharpsm83::res_0_b, this);
-    CB_opcode_table[0x81] = std::bind(&sharpsm83::res_0_c, this);
-    CB_opcode_table[0x82] = std::bind(&sharpsm83::res_0_d, this);
-    CB_opcode_table[0x83] = std::bind(&sharpsm83::res_0_e, this);
-    CB_opcode_table[0x84] = std::bind(&sharpsm83::res_0_h, this);
-    CB_opcode_table[0x85] = std::bind(&sharpsm83::res_0_l, this);
-    CB_opcode_table[0x86] = std::bind(&sharpsm83::res_0_memhl, this);
-    CB_opcode_table[0x87] = std::bind(&sharpsm83::res_0_a, this); 
-    CB_opcode_table[0x88] = std::bind(&sharpsm83::res_1_b, this);
-    CB_opcode_table[0x89] = std::bind(&sharpsm83::res_1_c, this);
-    CB_opcode_table[0x8A] = std::bind(&sharpsm83::res_1_d, this);
-    CB_opcode_table[0x8B] = std::bind(&sharpsm83::res_1_e, this);
-    CB_opcode_table[0x8C] = std::bind(&sharpsm83::res_1_h, this);
-    CB_opcode_table[0x8D] = std::bind(&sharpsm83::res_1_l, this);
-    CB_opcode_table[0x8E] = std::bind(&sharpsm83::res_1_memhl, this);
-    CB_opcode_table[0x8F] = std::bind(&sharpsm83::res_1_a, this);
-
-    CB_opcode_table[0x90] = std::bind(&sharpsm83::res_2_b, this);
-    CB_opcode_table[0x91] = std::bind(&sharpsm83::res_2_c, this);
-    CB_opcode_table[0x92] = std::bind(&sharpsm83::res_2_d, this);
-    CB_opcode_table[0x93] = std::bind(&sharpsm83::res_2_e, this);
-    CB_opcode_table[0x94] = std::bind(&sharpsm83::res_2_h, this);
-    CB_opcode_table[0x95] = std::bind(&sharpsm83::res_2_l, this);
-    CB_opcode_table[0x96] = std::bind(&sharpsm83::res_2_memhl, this);
-    CB_opcode_table[0x97] = std::bind(&sharpsm83::res_2_a, this);
-    CB_opcode_table[0x98] = std::bind(&sharpsm83::res_3_b, this);
-    CB_opcode_table[0x99] = std::bind(&sharpsm83::res_3_c, this);
-    CB_opcode_table[0x9A] = std::bind(&sharpsm83::res_3_d, this);
-    CB_opcode_table[0x9B] = std::bind(&sharpsm83::res_3_e, this);
-    CB_opcode_table[0x9C] = std::bind(&sharpsm83::res_3_h, this);
-    CB_opcode_table[0x9D] = std::bind(&sharpsm83::res_3_l, this);
-    CB_opcode_table[0x9E] = std::bind(&sharpsm83::res_3_memhl, this);
-    CB_opcode_table[0x9F] = std::bind(&sharpsm83::res_3_a, this);
-
-    CB_opcode_table[0xA0] = std::bind(&sharpsm83::res_4_b, this);
-    CB_opcode_table[0xA1] = std::bind(&sharpsm83::res_4_c, this);
-    CB_opcode_table[0xA2] = std::bind(&sharpsm83::res_4_d, this);
-    CB_opcode_table[0xA3] = std::bind(&sharpsm83::res_4_e, this);
-    CB_opcode_table[0xA4] = std::bind(&sharpsm83::res_4_h, this);
-    CB_opcode_table[0xA5] = std::bind(&sharpsm83::res_4_l, this);
-    CB_opcode_table[0xA6] = std::bind(&sharpsm83::res_4_memhl, this);
-    CB_opcode_table[0xA7] = std::bind(&sharpsm83::res_4_a, this);
-    CB_opcode_table[0xA8] = std::bind(&sharpsm83::res_5_b, this);
-    CB_opcode_table[0xA9] = std::bind(&sharpsm83::res_5_c, this);
-    CB_opcode_table[0xAA] = std::bind(&sharpsm83::res_5_d, this);
-    CB_opcode_table[0xAB] = std::bind(&sharpsm83::res_5_e, this);
-    CB_opcode_table[0xAC] = std::bind(&sharpsm83::res_5_h, this);
-    CB_opcode_table[0xAD] = std::bind(&sharpsm83::res_5_l, this);
-    CB_opcode_table[0xAE] = std::bind(&sharpsm83::res_5_memhl, this);
-    CB_opcode_table[0xAF] = std::bind(&sharpsm83::res_5_a, this);
-
-    CB_opcode_table[0xB0] = std::bind(&sharpsm83::res_6_b, this);
-    CB_opcode_table[0xB1] = std::bind(&sharpsm83::res_6_c, this);
-    CB_opcode_table[0xB2] = std::bind(&sharpsm83::res_6_d, this);
-    CB_opcode_table[0xB3] = std::bind(&sharpsm83::res_6_e, this);
-    CB_opcode_table[0xB4] = std::bind(&sharpsm83::res_6_h, this);
-    CB_opcode_table[0xB5] = std::bind(&sharpsm83::res_6_l, this);
-    CB_opcode_table[0xB6] = std::bind(&sharpsm83::res_6_memhl, this);
-    CB_opcode_table[0xB7] = std::bind(&sharpsm83::res_6_a, this);
-    CB_opcode_table[0xB8] = std::bind(&sharpsm83::res_7_b, this);
-    CB_opcode_table[0xB9] = std::bind(&sharpsm83::res_7_c, this);
-    CB_opcode_table[0xBA] = std::bind(&sharpsm83::res_7_d, this);
-    CB_opcode_table[0xBB] = std::bind(&sharpsm83::res_7_e, this);
-    CB_opcode_table[0xBC] = std::bind(&sharpsm83::res_7_h, this);
-    CB_opcode_table[0xBD] = std::bind(&sharpsm83::res_7_l, this);
-    CB_opcode_table[0xBE] = std::bind(&sharpsm83::res_7_memhl, this);
-    CB_opcode_table[0xBF] = std::bind(&sharpsm83::res_7_a, this);
-
-    CB_opcode_table[0xC0] = std::bind(&sharpsm83::set_0_b, this);
-    CB_opcode_table[0xC1] = std::bind(&sharpsm83::set_0_c, this);
-    CB_opcode_table[0xC2] = std::bind(&sharpsm83::set_0_d, this);
-    CB_opcode_table[0xC3] = std::bind(&sharpsm83::set_0_e, this);
-    CB_opcode_table[0xC4] = std::bind(&sharpsm83::set_0_h, this);
-    CB_opcode_table[0xC5] = std::bind(&sharpsm83::set_0_l, this);
-    CB_opcode_table[0xC6] = std::bind(&sharpsm83::set_0_memhl, this);
-    CB_opcode_table[0xC7] = std::bind(&sharpsm83::set_0_a, this);
-    CB_opcode_table[0xC8] = std::bind(&sharpsm83::set_1_b, this);
-    CB_opcode_table[0xC9] = std::bind(&sharpsm83::set_1_c, this);
-    CB_opcode_table[0xCA] = std::bind(&sharpsm83::set_1_d, this);
-    CB_opcode_table[0xCB] = std::bind(&sharpsm83::set_1_e, this);
-    CB_opcode_table[0xCC] = std::bind(&sharpsm83::set_1_h, this);
-    CB_opcode_table[0xCD] = std::bind(&sharpsm83::set_1_l, this);
-    CB_opcode_table[0xCE] = std::bind(&sharpsm83::set_1_memhl, this);
-    CB_opcode_table[0xCF] = std::bind(&sharpsm83::set_1_a, this);
-
-    CB_opcode_table[0xD0] = std::bind(&sharpsm83::set_2_b, this);
-    CB_opcode_table[0xD1] = std::bind(&sharpsm83::set_2_c, this);
-    CB_opcode_table[0xD2] = std::bind(&sharpsm83::set_2_d, this);
-    CB_opcode_table[0xD3] = std::bind(&sharpsm83::set_2_e, this);
-    CB_opcode_table[0xD4] = std::bind(&sharpsm83::set_2_h, this);
-    CB_opcode_table[0xD5] = std::bind(&sharpsm83::set_2_l, this);
-    CB_opcode_table[0xD6] = std::bind(&sharpsm83::set_2_memhl, this);
-    CB_opcode_table[0xD7] = std::bind(&sharpsm83::set_2_a, this);
-    CB_opcode_table[0xD8] = std::bind(&sharpsm83::set_3_b, this);
-    CB_opcode_table[0xD9] = std::bind(&sharpsm83::set_3_c, this);
-    CB_opcode_table[0xDA] = std::bind(&sharpsm83::set_3_d, this);
-    CB_opcode_table[0xDB] = std::bind(&sharpsm83::set_3_e, this);
-    CB_opcode_table[0xDC] = std::bind(&sharpsm83::set_3_h, this);
-    CB_opcode_table[0xDD] = std::bind(&sharpsm83::set_3_l, this);
-    CB_opcode_table[0xDE] = std::bind(&sharpsm83::set_3_memhl, this);
-    CB_opcode_table[0xDF] = std::bind(&sharpsm83::set_3_a, this);
-
-    CB_opcode_table[0xE0] = std::bind(&sharpsm83::set_4_b, this);
-    CB_opcode_table[0xE1] = std::bind(&sharpsm83::set_4_c, this);
-    CB_opcode_table[0xE2] = std::bind(&sharpsm83::set_4_d, this);
-    CB_opcode_table[0xE3] = std::bind(&sharpsm83::set_4_e, this);
-    CB_opcode_table[0xE4] = std::bind(&sharpsm83::set_4_h, this);
-    CB_opcode_table[0xE5] = std::bind(&sharpsm83::set_4_l, this);
-    CB_opcode_table[0xE6] = std::bind(&sharpsm83::set_4_memhl, this);
-    CB_opcode_table[0xE7] = std::bind(&sharpsm83::set_4_a, this);
-    CB_opcode_table[0xE8] = std::bind(&sharpsm83::set_5_b, this);
-    CB_opcode_table[0xE9] = std::bind(&sharpsm83::set_5_c, this);
-    CB_opcode_table[0xEA] = std::bind(&sharpsm83::set_5_d, this);
-    CB_opcode_table[0xEB] = std::bind(&sharpsm83::set_5_e, this);
-    CB_opcode_table[0xEC] = std::bind(&sharpsm83::set_5_h, this);
-    CB_opcode_table[0xED] = std::bind(&sharpsm83::set_5_l, this);
-    CB_opcode_table[0xEE] = std::bind(&sharpsm83::set_5_memhl, this);
-    CB_opcode_table[0xEF] = std::bind(&sharpsm83::set_5_a, this);
-
-    CB_opcode_table[0xF0] = std::bind(&sharpsm83::set_6_b, this);
-    CB_opcode_table[0xF1] = std::bind(&sharpsm83::set_6_c, this);
-    CB_opcode_table[0xF2] = std::bind(&sharpsm83::set_6_d, this);
-    CB_opcode_table[0xF3] = std::bind(&sharpsm83::set_6_e, this);
-    CB_opcode_table[0xF4] = std::bind(&sharpsm83::set_6_h, this);
-    CB_opcode_table[0xF5] = std::bind(&sharpsm83::set_6_l, this);
-    CB_opcode_table[0xF6] = std::bind(&sharpsm83::set_6_memhl, this);
-    CB_opcode_table[0xF7] = std::bind(&sharpsm83::set_6_a, this);
-    CB_opcode_table[0xF8] = std::bind(&sharpsm83::set_7_b, this);
-    CB_opcode_table[0xF9] = std::bind(&sharpsm83::set_7_c, this);
-    CB_opcode_table[0xFA] = std::bind(&sharpsm83::set_7_d, this);
-    CB_opcode_table[0xFB] = std::bind(&sharpsm83::set_7_e, this);
-    CB_opcode_table[0xFC] = std::bind(&sharpsm83::set_7_h, this);
-    CB_opcode_table[0xFD] = std::bind(&sharpsm83::set_7_l, this);
-    CB_opcode_table[0xFE] = std::bind(&sharpsm83::set_7_memhl, this);
-    CB_opcode_table[0xFF] = std::bind(&sharpsm83::set_7_a, this);
-}
-
-//##############################################################################
-void sharpsm83::print_registers()
+    if constexpr(timing_policy::sync_every_cycle)
+    {
+        bus->tick(cycles);
+    }
+    else
+    {
+        unsynced_cycles += cycles;
+    }
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::sync_cycles()
+{
+    if(unsynced_cycles == 0) return;
+
+    bus->tick(unsynced_cycles);
+    unsynced_cycles = 0;
+}
+//##############################################################################
+#define SM83_TABLE_ENTRY(opcode, handler) &basic_sharpsm83::handler,
+
+template<typename bus_type, typename timing_policy>
+constexpr std::array<typename basic_sharpsm83<bus_type, timing_policy>::opcode_handler, 0x1<<CPU_BITS> basic_sharpsm83<bus_type, timing_policy>::opcode_table = 
+{
+    SM83_OPCODES(SM83_TABLE_ENTRY)
+};
+
+template<typename bus_type, typename timing_policy>
+constexpr std::array<typename basic_sharpsm83<bus_type, timing_policy>::opcode_handler, 0x1<<CPU_BITS> basic_sharpsm83<bus_type, timing_policy>::CB_opcode_table = 
+{
+    SM83_CB_OPCODES(SM83_TABLE_ENTRY)
+};
+
+#undef SM83_TABLE_ENTRY
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::print_registers()
 {
+    materialize_flags();
+
     std::cout<<"##############################################################################"<<'\n';
-    std::cout<<"AF: 0x" << std::hex<<static_cast<int>(AF.b0_15)<<'\n';
-    std::cout<<"BC: 0x" << std::hex<<static_cast<int>(BC.b0_15)<<'\n';
-    std::cout<<"DE: 0x" << std::hex<<static_cast<int>(DE.b0_15)<<'\n';
-    std::cout<<"HL: 0x" << std::hex<<static_cast<int>(HL.b0_15)<<'\n';
-    std::cout<<"PC: 0x" << std::hex<<static_cast<int>(PC.b0_15)<<'\n';
-    std::cout<<"SP: 0x" << std::hex<<static_cast<int>(SP.b0_15)<<'\n';
+    std::cout<<"AF: 0x" << std::hex<<static_cast<int>(AF())<<'\n';
+    std::cout<<"BC: 0x" << std::hex<<static_cast<int>(BC())<<'\n';
+    std::cout<<"DE: 0x" << std::hex<<static_cast<int>(DE())<<'\n';
+    std::cout<<"HL: 0x" << std::hex<<static_cast<int>(HL())<<'\n';
+    std::cout<<"PC: 0x" << std::hex<<static_cast<int>(regs.PC)<<'\n';
+    std::cout<<"SP: 0x" << std::hex<<static_cast<int>(regs.SP)<<'\n';
     std::cout<<"Flags: Z: " << get_zero_flag() <<" N: " << get_subtraction_flag() 
         << " H: "<<get_half_carry_flag() << " C: "<<get_carry_flag()<<'\n';
 
@@ -2617,17 +3125,19 @@ void sharpsm83::print_registers()
     //bus->mem.print_memory_layout();
 }
 //##############################################################################
-void sharpsm83::reset()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::reset()
 {
-    //PC.b0_15 = 0x0100;
-    PC.b0_15 = 0x0000;
+    //regs.PC = 0x0100;
+    regs.PC = 0x0000;
 
-    SP.b0_15 = 0xFFFE;
+    regs.SP = 0xFFFE;
 
-    AF.b0_15 = 0x01B0;
-    BC.b0_15 = 0x0013;
-    DE.b0_15 = 0x00D8;
-    HL.b0_15 = 0x014D;
+    AF() = 0x01B0;
+    pending_flags = flag_op::NONE;
+    BC() = 0x0013;
+    DE() = 0x00D8;
+    HL() = 0x014D;
 
     interrupts_enabled = false;
     ei_pending = false;
@@ -2635,106 +3145,460 @@ void sharpsm83::reset()
     is_halted = false;
     exit_on_infinite_jr = false;
 
-    IE.b0_7 = 0x00;
-    IF.b0_7 = 0x00;
+    regs.IE = 0x00;
+    regs.IF = 0x00;
+    interrupt_pending = 0;
+
+    block_cache.clear();
+    current_block = nullptr;
+
+    idle_loops.clear();
+    loop_idiom_stats = {};
+    fusion_stats = {};
+
+    fetch_window = nullptr;
+    unsynced_cycles = 0;
+
+#ifdef CPU_JIT
+    jit.reset();
+#endif
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+const sm83_registers& basic_sharpsm83<bus_type, timing_policy>::get_registers()
+{
+    materialize_flags();
+
+    return regs;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_registers(const sm83_registers& registers)
+{
+    regs = registers;
+    pending_flags = flag_op::NONE;
+
+    update_interrupt_pending();
+
+    current_block = nullptr;
+    idle_loops.disarm();
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_block_cache_enabled(bool enabled)
+{
+    block_cache_enabled = enabled;
+    current_block = nullptr;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+sm83_block_cache& basic_sharpsm83<bus_type, timing_policy>::get_block_cache()
+{
+    return block_cache;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_idle_loop_skip_enabled(bool enabled)
+{
+    idle_loop_skip_enabled = enabled;
+    idle_loops.disarm();
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+sm83_idle_loop_detector& basic_sharpsm83<bus_type, timing_policy>::get_idle_loop_detector()
+{
+    return idle_loops;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_loop_idioms_enabled(bool enabled)
+{
+    loop_idioms_enabled = enabled;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+const sm83_loop_idiom_stats& basic_sharpsm83<bus_type, timing_policy>::get_loop_idiom_stats()
+{
+    return loop_idiom_stats;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_fusion_enabled(bool enabled)
+{
+    fusion_enabled = enabled;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+const sm83_fusion_stats& basic_sharpsm83<bus_type, timing_policy>::get_fusion_stats()
+{
+    return fusion_stats;
+}
+#ifdef CPU_JIT
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_jit_enabled(bool enabled)
+{
+    jit_enabled = enabled;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_jit_threshold(uint32_t threshold)
+{
+    jit_threshold = threshold;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+sm83_jit& basic_sharpsm83<bus_type, timing_policy>::get_jit()
+{
+    return jit;
+}
+#endif
+#ifdef CPU_AOT
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+bool basic_sharpsm83<bus_type, timing_policy>::load_aot_module(const std::string& path)
+{
+    if constexpr(!runs_native_code)
+    {
+        std::cout<<"AOT: modules only run on the Game Boy bus, not loading "<<path<<'\n';
+        return false;
+    }
+    else
+    {
+        if(!bus || !bus->cartridge)
+        {
+            std::cout<<"AOT: no cartridge to load "<<path<<" for"<<'\n';
+            return false;
+        }
+
+        // the blocks decoded so far would keep code of the old module
+        block_cache.clear();
+        current_block = nullptr;
+        idle_loops.disarm();
+
+#ifdef CPU_JIT
+        jit.reset();
+#endif
+
+        return aot.load(path, bus->cartridge->get_data(), &aot_steps);
+    }
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_aot_enabled(bool enabled)
+{
+    aot_enabled = enabled;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+sm83_aot& basic_sharpsm83<bus_type, timing_policy>::get_aot()
+{
+    return aot;
 }
+#endif
 //##############################################################################
-const uint16_t& sharpsm83::get_last_opcode()
+template<typename bus_type, typename timing_policy>
+const uint16_t& basic_sharpsm83<bus_type, timing_policy>::get_last_opcode()
 {
     return last_opcode;
 }
 //##############################################################################
-const uint16_t& sharpsm83::get_current_adrress()
+template<typename bus_type, typename timing_policy>
+const uint16_t& basic_sharpsm83<bus_type, timing_policy>::get_current_adrress()
+{
+    return regs.PC;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_IE(uint8_t value)
+{
+   regs.IE = value;
+
+   update_interrupt_pending();
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+uint8_t basic_sharpsm83<bus_type, timing_policy>::get_IE()
+{
+    return regs.IE;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::set_IF(uint8_t value)
+{
+    regs.IF = value;
+
+    update_interrupt_pending();
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+uint8_t basic_sharpsm83<bus_type, timing_policy>::get_IF()
+{
+    return regs.IF | 0xE0;
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+uint8_t basic_sharpsm83<bus_type, timing_policy>::read_IF(void* context, const uint16_t&)
+{
+    return static_cast<basic_sharpsm83*>(context)->get_IF();
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::write_IF(void* context, const uint16_t&, const uint8_t& data)
+{
+    static_cast<basic_sharpsm83*>(context)->set_IF(data);
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+uint8_t basic_sharpsm83<bus_type, timing_policy>::read_IE(void* context, const uint16_t&)
+{
+    return static_cast<basic_sharpsm83*>(context)->get_IE();
+}
+//##############################################################################
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::write_IE(void* context, const uint16_t&, const uint8_t& data)
 {
-    return PC.b0_15;
+    static_cast<basic_sharpsm83*>(context)->set_IE(data);
 }
 //##############################################################################
-void sharpsm83::set_IE(uint8_t value)
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::update_interrupt_pending()
 {
-   IE.b0_7 = value;
+    interrupt_pending = regs.IE & regs.IF & 0x1F;
 }
 //##############################################################################
-uint8_t sharpsm83::get_IE()
+template<typename bus_type, typename timing_policy>
+int basic_sharpsm83<bus_type, timing_policy>::skip_idle_loop()
 {
-    return IE.b0_7;
+    uint64_t now = bus->scheduler->get_now();
+
+    uint64_t stable_until = std::min(bus->stable_until(current_block->idle_poll_address), now + uint64_t(4) * MAX_HALT_SKIP);
+
+    // interrupts are raised at scheduler deadlines, and their handlers may
+    // change what the loop is waiting for
+    if(interrupts_enabled || ei_pending || ei_scheduled)
+    {
+        stable_until = std::min(stable_until, bus->scheduler->get_next_deadline());
+    }
+
+    return idle_loops.enter(*current_block, now, stable_until);
 }
 //##############################################################################
-void sharpsm83::set_IF(uint8_t value)
+template<typename bus_type, typename timing_policy>
+int basic_sharpsm83<bus_type, timing_policy>::run_loop_idiom()
 {
-    IF.b0_7 = value;
+    using counter_register = sm83_loop_idiom::counter_register;
+    using loop_kind = sm83_loop_idiom::loop_kind;
+
+    const sm83_loop_idiom& idiom = current_block->idiom;
+
+    uint8_t* counter_lo = nullptr;
+    uint8_t* counter_hi = nullptr;
+
+    switch(idiom.counter)
+    {
+        case counter_register::B: counter_lo = &regs.B; break;
+        case counter_register::C: counter_lo = &regs.C; break;
+        case counter_register::D: counter_lo = &regs.D; break;
+        case counter_register::E: counter_lo = &regs.E; break;
+        case counter_register::BC: counter_lo = &regs.C; counter_hi = &regs.B; break;
+        case counter_register::DE: counter_lo = &regs.E; counter_hi = &regs.D; break;
+    }
+
+    // iterations left, the counter is decremented before it is tested
+    uint32_t count = counter_hi ? (*counter_hi << 8 | *counter_lo) : *counter_lo;
+    if(count == 0) count = counter_hi ? 0x10000 : 0x100;
+
+    // the last iteration is interpreted and leaves A and F as they should be
+    uint32_t iterations = count - 1;
+
+    uint32_t iteration_cycles = current_block->cycles + 1;
+    uint64_t iteration = 4ull * iteration_cycles;
+
+    uint64_t now = bus->scheduler->get_now();
+    uint64_t until = now + uint64_t(4) * MAX_HALT_SKIP;
+
+    // an interrupt handler could look at what the loop is doing
+    if(interrupts_enabled || ei_pending || ei_scheduled)
+    {
+        until = std::min(until, bus->scheduler->get_next_deadline());
+    }
+
+    iterations = std::min<uint64_t>(iterations, (until - now) / iteration);
+
+    if(idiom.kind != loop_kind::DELAY && iterations > 0)
+    {
+        uint16_t destination = idiom.copy_to_de ? DE() : HL();
+        int step = idiom.copy_to_de ? idiom.de_step : idiom.hl_step;
+
+        int32_t first = step > 0 ? destination : destination - int32_t(iterations - 1);
+        int32_t last = first + int32_t(iterations - 1);
+
+        if(first < 0 || last > 0xFFFF) return 0;
+        if(!bus->is_plain_memory(first, last, true)) return 0;
+
+        // the loop could overwrite code, itself included
+        for(int32_t page = first >> 8; page <= (last >> 8); ++page)
+        {
+            if(block_cache.is_code_page(page << 8)) return 0;
+        }
+
+        if(idiom.kind == loop_kind::COPY)
+        {
+            uint16_t source = idiom.copy_to_de ? HL() : DE();
+
+            if(source + iterations - 1 > 0xFFFF) return 0;
+            if(!bus->is_plain_memory(source, source + iterations - 1, false)) return 0;
+        }
+
+        // every write has to land before the PPU looks at the range
+        uint64_t observed = bus->next_observation(first, last);
+
+        iterations = std::min<uint64_t>(iterations, (observed - now) / iteration);
+    }
+
+    if(iterations == 0) return 0;
+
+    if(idiom.kind == loop_kind::FILL)
+    {
+        uint8_t value;
+
+        switch(idiom.fill_opcode)
+        {
+            case 0xAF: value = 0x00; break;                     // XOR A
+            case 0x3E: value = idiom.fill_constant; break;      // LD A,d8
+            case 0x78: value = regs.B; break;               // LD A,B
+            case 0x79: value = regs.C; break;               // LD A,C
+            case 0x7A: value = regs.D; break;               // LD A,D
+            case 0x7B: value = regs.E; break;               // LD A,E
+            default: value = regs.A; break;
+        }
+
+        uint16_t address = HL();
+
+        for(uint32_t i = 0; i < iterations; ++i, address += idiom.hl_step)
+        {
+            bus->bus_write(address, value);
+        }
+
+        loop_idiom_stats.bytes += iterations;
+    }
+    else if(idiom.kind == loop_kind::COPY)
+    {
+        uint16_t source = idiom.copy_to_de ? HL() : DE();
+        uint16_t destination = idiom.copy_to_de ? DE() : HL();
+
+        // byte by byte like the guest, the ranges may overlap
+        for(uint32_t i = 0; i < iterations; ++i)
+        {
+            bus->bus_write(destination++, bus->bus_read(source++));
+        }
+
+        loop_idiom_stats.bytes += iterations;
+    }
+
+    HL() += idiom.hl_step * static_cast<int32_t>(iterations);
+    DE() += idiom.de_step * static_cast<int32_t>(iterations);
+
+    count -= iterations;
+    *counter_lo = count & 0xFF;
+    if(counter_hi) *counter_hi = count >> 8;
+
+    loop_idiom_stats.runs++;
+    loop_idiom_stats.iterations += iterations;
+
+    return iterations * iteration_cycles;
 }
 //##############################################################################
-uint8_t sharpsm83::get_IF()
+template<typename bus_type, typename timing_policy>
+int basic_sharpsm83<bus_type, timing_policy>::halt_skip_cycles()
 {
-    return IF.b0_7 | 0xE0;
+    uint64_t now = bus->scheduler->get_now();
+    uint64_t deadline = bus->scheduler->get_next_deadline();
+
+    if(deadline == gb_scheduler::NEVER || deadline - now >= uint64_t(4) * MAX_HALT_SKIP) return MAX_HALT_SKIP;
+
+    // round up so the event runs in the same M-cycle as when stepping one by one
+    return deadline > now ? (deadline - now + 3) / 4 : 1;
 }
 //##############################################################################
-void sharpsm83::handle_interrupts()
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::handle_interrupts()
 {
-    reg8 interrupt_request;
-    interrupt_request.b0_7 = bus->bus_read(0xFFFF) & bus->bus_read(0xFF0F);
+    if(interrupt_pending == 0) return;
 
-    if(interrupt_request.b0_7 == 0) return;
+    uint8_t interrupt_request = interrupt_pending;
 
-    if(is_halted && interrupt_request.b0_7 != 0x0) 
+    if(is_halted && interrupt_request != 0x0) 
     { 
         is_halted = false;
     }
     if(!interrupts_enabled) return;
 
-    stack_push(PC.b0_15);
+    stack_push(regs.PC);
 
     emulate_cycles(5);
 
     interrupts_enabled = false;
 
-    if(interrupt_request.b0)      //V-Blank
+    if(interrupt_request & 0x01)      //V-Blank
     {
         //std::cout<<"HANDLE VBLANK"<<'\n';
-        IF.b0 = 0;
-        PC.b0_15 = interrupt_address::VBLANK;
+        regs.IF &= ~0x01;
+        regs.PC = interrupt_address::VBLANK;
     }
-    else if(interrupt_request.b1)  //LCD STAT
+    else if(interrupt_request & 0x02)  //LCD STAT
     {
         std::cout<<"HANDLE LCDC"<<'\n';
 
-        IF.b1 = 0;
-        PC.b0_15 = interrupt_address::LCDC;
+        regs.IF &= ~0x02;
+        regs.PC = interrupt_address::LCDC;
     }
-    else if(interrupt_request.b2)  //Timer
+    else if(interrupt_request & 0x04)  //Timer
     {
         std::cout<<"HANDLE TIMER"<<'\n';
 
-        IF.b2 = 0;
-        PC.b0_15 = interrupt_address::TIMER;
+        regs.IF &= ~0x04;
+        regs.PC = interrupt_address::TIMER;
     }
-    else if(interrupt_request.b3)  //Serial
+    else if(interrupt_request & 0x08)  //Serial
     {
         std::cout<<"HANDLE SERIAL"<<'\n';
 
-        IF.b3 = 0;
-        PC.b0_15 = interrupt_address::SERIAL;
+        regs.IF &= ~0x08;
+        regs.PC = interrupt_address::SERIAL;
     }
-    else if(interrupt_request.b4)  //Joypad
+    else if(interrupt_request & 0x10)  //Joypad
     {
         std::cout<<"HANDLE JOYPAD"<<'\n';
 
-        IF.b4 = 0;
-        PC.b0_15 = interrupt_address::JOYPAD;
+        regs.IF &= ~0x10;
+        regs.PC = interrupt_address::JOYPAD;
     }
+
+    update_interrupt_pending();
 }
 //##############################################################################
-long int sharpsm83::get_cycle_count()
+template<typename bus_type, typename timing_policy>
+long int basic_sharpsm83<bus_type, timing_policy>::get_cycle_count()
 {
     return cycle_count;
 }
-void sharpsm83::finish_instruction() 
+template<typename bus_type, typename timing_policy>
+void basic_sharpsm83<bus_type, timing_policy>::finish_instruction() 
 {
+#ifdef CPU_VERIFY_FLAGS
+    verify_flags();
+#endif
+
+    // the scheduler runs the events the instruction went past
+    sync_cycles();
+
     if (ei_scheduled) 
     {
         interrupts_enabled = true;
         ei_scheduled = false;
-        std::cout<<"0x"<<std::hex<<(int)PC.b0_15<<": Enable interrupts!"<<'\n';
+        std::cout<<"0x"<<std::hex<<(int)regs.PC<<": Enable interrupts!"<<'\n';
     }
     if (ei_pending) 
     {
@@ -2742,3 +3606,7 @@ void sharpsm83::finish_instruction()
         ei_pending = false;
     }
 }
+//##############################################################################
+template struct basic_sharpsm83<gb_bus, sm83_exact_timing>;
+template struct basic_sharpsm83<gb_bus, sm83_fast_timing>;
+template struct basic_sharpsm83<gb_flat_bus, sm83_exact_timing>;
@@ -3,16 +3,34 @@
 
 #include <cstdint>
 #include <memory>
-#include <functional>
 #include <array>
+#include <type_traits>
 
 #include "../BUS/gb_bus.hpp"
 #include "../CARTRIDGE/gb_cartridge.hpp"
+#include "sm83_block_cache.hpp"
+#include "sm83_idle_loop.hpp"
+#include "sm83_fusion.hpp"
+#include "sm83_timing.hpp"
+#ifdef CPU_JIT
+#include "sm83_jit.hpp"
+#endif
+#ifdef CPU_AOT
+#include "sm83_aot.hpp"
+#endif
 
 #define CPU_BITS 8
 
 const int CLOCK_RATE = 4194304; // 4.194304 MHz
 
+// longest HALT skip in M-cycles (one frame), so a CPU that nothing can wake
+// still hands control back to the frontend
+const int MAX_HALT_SKIP = 17556;
+
+// longest run of linked blocks a single tick() goes through, in M-cycles (one
+// scanline), so the frontend still sees time pass in small steps
+const int MAX_CHAIN_CYCLES = 114;
+
 struct interrupt_address
 {
     static constexpr uint16_t VBLANK = 0x40;
@@ -22,57 +40,96 @@ struct interrupt_address
     static constexpr uint16_t JOYPAD = 0x60;
 };
 
-class gb_bus;
+// SM83 register file. Only plain bytes and words, so it is trivially copyable
+// and a save state can take it with a single memcpy
+struct sm83_registers
+{
+    uint8_t A = 0, F = 0;
+    uint8_t B = 0, C = 0;
+    uint8_t D = 0, E = 0;
+    uint8_t H = 0, L = 0;
+
+    // stack pointer
+    uint16_t SP = 0;
+    // program counter
+    uint16_t PC = 0;
+
+    // interrupt enable register
+    uint8_t IE = 0;
+    // interrupt flags register
+    uint8_t IF = 0;
+};
+
+static_assert(std::is_trivially_copyable<sm83_registers>::value, "sm83_registers must stay memcpy-able");
+
+struct gb_bus;
 
-struct sharpsm83
+// The SM83 core, on the bus it is built for and with the timing policy of
+// sm83_timing.hpp. Bus accesses are direct calls to bus_type, so its fast
+// paths (bus_read, bus_write, tick) inline into the instruction handlers.
+// Every member is instantiated in cpu_sharpsm83.cpp: on gb_bus with both
+// policies (sharpsm83, fast_sharpsm83) and on gb_flat_bus (flat_sharpsm83).
+template<typename bus_type, typename timing_policy>
+struct basic_sharpsm83
 {
 private:
-    union reg8
-    {
-        struct 
-        { 
-            uint8_t b0 : 1;
-            uint8_t b1 : 1;
-            uint8_t b2 : 1;
-            uint8_t b3 : 1;
-            uint8_t b4 : 1;
-            uint8_t b5 : 1;
-            uint8_t b6 : 1;
-            uint8_t b7 : 1;
-        };
-        uint8_t b0_7;
-    };
+    // SM83 registers
+    sm83_registers regs;
 
-    union reg16
+    // two 8-bit registers read and written as one 16-bit register
+    struct reg_pair
     {
-        struct 
+        uint8_t& hi;
+        uint8_t& lo;
+
+        operator uint16_t() const { return (hi << 8) | lo; }
+
+        reg_pair& operator=(uint16_t value)
         {
-            reg8 Lo;
-            reg8 Hi;
-        };
-        uint16_t b0_15;
+            hi = value >> 8;
+            lo = value & 0xFF;
+            return *this;
+        }
+
+        reg_pair& operator=(const reg_pair& other) { return *this = static_cast<uint16_t>(other); }
+        reg_pair& operator+=(int value) { return *this = static_cast<uint16_t>(*this + value); }
+
+        uint16_t operator++(int)
+        {
+            uint16_t old = *this;
+            *this = static_cast<uint16_t>(old + 1);
+            return old;
+        }
+
+        uint16_t operator--(int)
+        {
+            uint16_t old = *this;
+            *this = static_cast<uint16_t>(old - 1);
+            return old;
+        }
     };
 
-    // SM83 registers
+    reg_pair AF() { return {regs.A, regs.F}; }
+    reg_pair BC() { return {regs.B, regs.C}; }
+    reg_pair DE() { return {regs.D, regs.E}; }
+    reg_pair HL() { return {regs.H, regs.L}; }
 
-    // acumulator and flags
-    reg16 AF;
-    // general purpose 
-    reg16 BC;
-    reg16 DE;
-    reg16 HL;
-    // stack pointer
-    reg16 SP;
-    //program counter
-    reg16 PC;
+    // masks of the flags in F
+    static constexpr uint8_t FLAG_Z = 0x80;
+    static constexpr uint8_t FLAG_N = 0x40;
+    static constexpr uint8_t FLAG_H = 0x20;
+    static constexpr uint8_t FLAG_C = 0x10;
 
-    // interrupt enable register
-    reg8 IE; 
-    // interrupt flags register
-    reg8 IF;
+    // IE & IF & 0x1F, refreshed whenever either register changes so the
+    // per-instruction interrupt check does not go through the bus
+    uint8_t interrupt_pending = 0;
+    void update_interrupt_pending();
 
     void handle_interrupts();
 
+    // M-cycles a halted CPU can sleep before the next scheduled event
+    int halt_skip_cycles();
+
     bool is_halted = false;
     bool halt_bug = false;
     bool interrupts_enabled = false;
@@ -87,11 +144,41 @@ private:
     // cpu chip enable  
     bool ce;
 
-    std::shared_ptr<gb_bus> bus;
+    std::shared_ptr<bus_type> bus;
 
     void enable_interrupts();
     void disable_interrupts();
 
+    // ALU operation whose flags have not been written to F yet (CPU_FLAGS=LAZY)
+    enum class flag_op : uint8_t
+    {
+        NONE,
+        ADD,    // ADD, ADC
+        SUB,    // SUB, SBC, CP
+        AND,
+        OR,
+        XOR,
+        INC,
+        DEC
+    };
+
+    flag_op pending_flags = flag_op::NONE;
+    // operands, or the result for AND/OR/XOR
+    uint8_t flag_lhs = 0;
+    uint8_t flag_rhs = 0;
+    // carry into ADD/SUB, the carry kept by INC/DEC
+    bool flag_carry = false;
+
+    void record_flags(flag_op op, uint8_t lhs, uint8_t rhs, bool carry);
+    // Z N H C of the pending operation in the upper nibble
+    uint8_t evaluate_flags();
+    // writes the pending operation to F
+    void materialize_flags();
+    // C without materializing the other flags
+    bool pending_carry();
+    // CPU_FLAGS=VERIFY: F written eagerly against the recorded operation
+    void verify_flags();
+
     // getters for the flags
     bool get_zero_flag();
     void set_zero_flag(bool val);
@@ -110,17 +197,120 @@ private:
     void complement_carry_flag();
 
     uint8_t fetch_data();
+
+    // host memory of fetch_first to fetch_first + fetch_span around PC: its
+    // page, or HRAM on page 0xFF, whose I/O registers keep it out of the
+    // page table; nullptr when PC has to be fetched through the bus (I/O,
+    // OAM, halt bug)
+    const uint8_t* fetch_window = nullptr;
+    uint16_t fetch_first = 0;
+    uint16_t fetch_span = 0;
+    uint32_t fetch_page_generation = 0;
+
+    uint8_t fetch_data_slow();
     void write_data(const uint16_t& address, const uint8_t& data);
 
+    // pre-decoded instructions for code in ROM, WRAM and HRAM
+    sm83_block_cache block_cache;
+    bool block_cache_enabled = true;
+
+    // block being executed and the index of its next instruction
+    const sm83_block* current_block = nullptr;
+    std::size_t current_block_index = 0;
+
+    // immediates of the decoded instruction being executed
+    std::array<uint8_t, 2> decoded_operands;
+    const uint8_t* decoded_operand = nullptr;
+
+    bool is_cacheable(const uint16_t& address);
+    const sm83_decoded_instr* next_decoded_instruction();
+    const sm83_block* decode_block(const uint16_t& address, uint32_t key);
+    void execute_decoded(const sm83_decoded_instr& instr);
+
+    // the checks tick() does between two instructions, for code going on
+    // with instruction index of the current block without returning to it
+    bool block_continues(const sm83_decoded_instr& instr, std::size_t index);
+    bool continues_at(uint16_t address);
+
+    // runs the current block from instr, and the blocks linked after it that
+    // enter plainly, for as long as execution continues and MAX_CHAIN_CYCLES
+    void run_decoded(const sm83_decoded_instr* instr);
+
+    // false if tick() has to look at the block when it is entered (idle
+    // loop, loop idiom, AOT code)
+    bool enters_plainly(const sm83_block& block);
+
+    // fast-forwards loops that wait for an I/O register or RAM flag to change
+    sm83_idle_loop_detector idle_loops;
+    bool idle_loop_skip_enabled = true;
+
+    int skip_idle_loop();
+
+    // runs memset, memcpy and delay loops as one host operation
+    bool loop_idioms_enabled = true;
+    sm83_loop_idiom_stats loop_idiom_stats;
+
+    int run_loop_idiom();
+
+    // runs the instruction pairs marked at decode time as one step
+    bool fusion_enabled = true;
+    sm83_fusion_stats fusion_stats;
+
+    using fused_handler = void (basic_sharpsm83::*)(const sm83_decoded_instr& instr);
+
+    // by sm83_fusion index, shared by every cpu instance
+    static const std::array<fused_handler, sm83_fusion::COUNT + 1> fused_table;
+
+    // the handler of a normal opcode, called directly
+    template<uint8_t opcode>
+    void normal_instruction();
+
+    template<uint8_t first, uint8_t second>
+    void fused_instruction(const sm83_decoded_instr& instr);
+
+    // JIT and AOT code calls into the core through sharpsm83, other buses
+    // and policies stay on the interpreter
+    static constexpr bool runs_native_code = std::is_same<basic_sharpsm83, sharpsm83>::value;
+
+#ifdef CPU_JIT
+    // native code for blocks that ran at least jit_threshold times
+    sm83_jit jit;
+    bool jit_enabled = true;
+    uint32_t jit_threshold = 64;
+
+    // runs the block at the cursor natively, and the compiled blocks linked
+    // after it like run_decoded; false if it is not compiled (yet)
+    bool execute_jit_block();
+
+    // sm83_jit_context of this core
+    static bool jit_step(basic_sharpsm83* cpu, std::size_t index);
+    static bool jit_sync(basic_sharpsm83* cpu);
+#endif
+
+#ifdef CPU_AOT
+    // blocks of the cartridge compiled ahead of time by sm83_aot
+    sm83_aot aot;
+    bool aot_enabled = true;
+
+    template<uint8_t opcode>
+    static bool aot_step(basic_sharpsm83* cpu, const sm83_decoded_instr* instr, uint8_t index);
+
+    // sm83_aot_step_table for sharpsm83
+    using aot_step_table = std::array<bool (*)(basic_sharpsm83* cpu, const sm83_decoded_instr* instr, uint8_t index), 256>;
+
+    // by opcode, handed to the module when it is loaded
+    static const aot_step_table aot_steps;
+#endif
+
     void execute_nop();
     void execute_halt();
     void execute_stop();
 
     // generic left/right rotations with or without carry
-    void rlc(reg8& reg);
-    void rl(reg8& reg);
-    void rrc(reg8& reg);
-    void rr(reg8& reg);
+    void rlc(uint8_t& reg);
+    void rl(uint8_t& reg);
+    void rrc(uint8_t& reg);
+    void rr(uint8_t& reg);
 
     // generic jump instruction
     void jr(bool cond);
@@ -133,25 +323,25 @@ private:
     void rst(const uint16_t& address);
 
     // generic decimal adjust
-    void da(reg8& r);
+    void da(uint8_t& r);
 
     // generic complement register
-    void complement(reg8& reg);
+    void complement(uint8_t& reg);
 
     // writes data to address
     void ld_to_address(const uint16_t& address, const uint8_t& data);
     // writes imm8 data to address indicated by reg
-    void ld_to_address(const reg16& reg);
+    void ld_to_address(const reg_pair& reg);
 
-    void ld_to_address(const reg8& reg);
+    void ld_to_address(const uint8_t& reg);
 
 
-    void ldh_to_address(const reg8& reg);
-    void ldh_to_address(const reg8& to, const reg8& reg);
-    void ldh_from_address(reg8& reg);
-    void ldh_from_address(reg8& to, const reg8& reg);
+    void ldh_to_address(const uint8_t& reg);
+    void ldh_to_address(const uint8_t& to, const uint8_t& reg);
+    void ldh_from_address(uint8_t& reg);
+    void ldh_from_address(uint8_t& to, const uint8_t& reg);
 
-    void ld_hl_reg_e8(const reg16& reg);
+    void ld_hl_reg_e8(const uint16_t& reg);
 
     void ld_a_memimm16_op();
 
@@ -161,6 +351,7 @@ private:
     void ld_from_address(uint8_t& reg, const uint16_t& address);
     // writes 16 bits from memory to the destination
     void ld(uint16_t& to);
+    void ld(reg_pair to);
     // writes 8 bits from memory to the destination
     void ld(uint8_t& to);
     // writes data from a 8 bit location to a 8 bit location
@@ -170,99 +361,101 @@ private:
     void ld_sp();
 
     void inc(uint16_t& reg);
+    void inc(reg_pair reg);
     void inc(uint8_t& reg);
-    void inc_mem(uint16_t& address);
+    void inc_mem(const uint16_t& address);
     void dec(uint8_t& reg);
     void dec(uint16_t& reg);
-    void dec_mem(uint16_t& address);
+    void dec(reg_pair reg);
+    void dec_mem(const uint16_t& address);
 
-    void add(uint16_t& op1, uint16_t& op2);
+    void add(reg_pair op1, const uint16_t& op2);
 
     void add(uint8_t& op1, uint8_t& op2);
-    void add_from_address(uint8_t& op1, uint16_t& address);
-    void add(reg8& reg);
-    void add_e8(reg16& reg);
+    void add_from_address(uint8_t& op1, const uint16_t& address);
+    void add(uint8_t& reg);
+    void add_e8(uint16_t& reg);
 
     void adc(uint8_t& op1, uint8_t& op2);
-    void adc_from_address(uint8_t& op1, uint16_t& address);
-    void adc(reg8& reg);
+    void adc_from_address(uint8_t& op1, const uint16_t& address);
+    void adc(uint8_t& reg);
 
     void sub(uint8_t& op1, uint8_t& op2);
-    void sub_from_address(uint8_t& op1, uint16_t& address);
-    void sub(reg8& reg);
+    void sub_from_address(uint8_t& op1, const uint16_t& address);
+    void sub(uint8_t& reg);
 
     void sbc(uint8_t& op1, uint8_t& op2);
-    void sbc_from_address(uint8_t& op1, uint16_t& address);
-    void sbc(reg8& reg);
+    void sbc_from_address(uint8_t& op1, const uint16_t& address);
+    void sbc(uint8_t& reg);
 
     void and_op(uint8_t& op1, uint8_t& op2);
-    void and_op_from_address(uint8_t& op1, uint16_t& address);
-    void and_op(reg8& reg);
+    void and_op_from_address(uint8_t& op1, const uint16_t& address);
+    void and_op(uint8_t& reg);
 
     void xor_op(uint8_t& op1, uint8_t& op2);
-    void xor_op_from_address(uint8_t& op1, uint16_t& address);
-    void xor_op(reg8& reg);
+    void xor_op_from_address(uint8_t& op1, const uint16_t& address);
+    void xor_op(uint8_t& reg);
 
     void or_op(uint8_t& op1, uint8_t& op2);
-    void or_op_from_address(uint8_t& op1, uint16_t& address);
-    void or_op(reg8& reg);
+    void or_op_from_address(uint8_t& op1, const uint16_t& address);
+    void or_op(uint8_t& reg);
 
     void cp_op(uint8_t& op1, uint8_t& op2);
-    void cp_op_from_address(uint8_t& op1, uint16_t& address);
-    void cp_op(reg8& reg);
+    void cp_op_from_address(uint8_t& op1, const uint16_t& address);
+    void cp_op(uint8_t& reg);
 
-    void rlc_param(reg8& reg);
+    void rlc_param(uint8_t& reg);
 
     void ret_op();
     void ret_condition(bool condition);
     void reti_op();
-    void rlcmem_param(uint16_t& address);
+    void rlcmem_param(const uint16_t& address);
 
-    void rrc_param(reg8& reg);
+    void rrc_param(uint8_t& reg);
 
-    void rrcmem_param(uint16_t& address);
+    void rrcmem_param(const uint16_t& address);
 
-    void rl_param(reg8& reg);
+    void rl_param(uint8_t& reg);
 
-    void rlmem_param(uint16_t& address);
+    void rlmem_param(const uint16_t& address);
 
-    void rr_param(reg8& reg);
+    void rr_param(uint8_t& reg);
 
-    void rrmem_param(uint16_t& address);
+    void rrmem_param(const uint16_t& address);
 
-    void sla_param(reg8& reg);
+    void sla_param(uint8_t& reg);
 
-    void slamem_param(uint16_t& address);
+    void slamem_param(const uint16_t& address);
 
-    void sra_param(reg8& reg);
+    void sra_param(uint8_t& reg);
 
-    void sramem_param(uint16_t& address);
+    void sramem_param(const uint16_t& address);
 
-    void swap_param(reg8& reg);
+    void swap_param(uint8_t& reg);
 
-    void swapmem_param(uint16_t& address);
+    void swapmem_param(const uint16_t& address);
 
-    void srl_param(reg8& reg);
+    void srl_param(uint8_t& reg);
 
-    void srlmem_param(uint16_t& address);
+    void srlmem_param(const uint16_t& address);
 
-    void bit_param(uint8_t bit, reg8& reg);
+    void bit_param(uint8_t bit, uint8_t& reg);
 
-    void bitmem_param(uint8_t bit, uint16_t& address);\
+    void bitmem_param(uint8_t bit, const uint16_t& address);\
 
-    void res_param(uint8_t bit, reg8& reg);
+    void res_param(uint8_t bit, uint8_t& reg);
 
-    void resmem_param(uint8_t bit, uint16_t& address);
+    void resmem_param(uint8_t bit, const uint16_t& address);
 
-    void set_param(uint8_t bit, reg8& reg);
+    void set_param(uint8_t bit, uint8_t& reg);
 
-    void setmem_param(uint8_t bit, uint16_t& address);
+    void setmem_param(uint8_t bit, const uint16_t& address);
 
     void stack_push(const uint16_t& value);
     void stack_pop(uint16_t& value);
 
-    void pop(reg16& reg);
-    void push(reg16& reg);
+    void pop(reg_pair reg);
+    void push(reg_pair reg);
 
     void pop_af_op();
     void push_af_op();
@@ -556,333 +749,39 @@ private:
     void cp_a_imm8();
     void rst_0x38();
 
-    // CB prefixed instructions
+    // CB prefixed instructions, one instance per opcode: bits 7-6 pick
+    // rotate/shift, BIT, RES or SET, bits 5-3 the rotation or the bit and
+    // bits 2-0 the operand (B, C, D, E, H, L, (HL), A)
+    template<uint8_t opcode>
+    void cb_instruction();
 
-    // 0x00 - 0x0F
-    void rlc_b();
-    void rlc_c();
-    void rlc_d();
-    void rlc_e();
-    void rlc_h();
-    void rlc_l();
-    void rlc_memhl();
-    void rlc_a();
-
-    void rrc_b();
-    void rrc_c();
-    void rrc_d();
-    void rrc_e();
-    void rrc_h();
-    void rrc_l();
-    void rrc_memhl();
-    void rrc_a();
+    template<uint8_t operand>
+    uint8_t& cb_register();
 
-    // 0x10 - 0x1F
-    void rl_b();
-    void rl_c();
-    void rl_d();
-    void rl_e();
-    void rl_h();
-    void rl_l();
-    void rl_memhl();
-    void rl_a();
-
-    void rr_b();
-    void rr_c();
-    void rr_d();
-    void rr_e();
-    void rr_h();
-    void rr_l();
-    void rr_memhl();
-    void rr_a();
-
-    // 0x20 - 0x2F
-    void sla_b();
-    void sla_c();
-    void sla_d();
-    void sla_e();
-    void sla_h();
-    void sla_l();
-    void sla_memhl();
-    void sla_a();
-
-    void sra_b();
-    void sra_c();
-    void sra_d();
-    void sra_e();
-    void sra_h();
-    void sra_l();
-    void sra_memhl();
-    void sra_a();
 
-    // 0x30 - 0x3F
-    void swap_b();
-    void swap_c();
-    void swap_d();
-    void swap_e();
-    void swap_h();
-    void swap_l();
-    void swap_memhl();
-    void swap_a();
-
-    void srl_b();
-    void srl_c();
-    void srl_d();
-    void srl_e();
-    void srl_h();
-    void srl_l();
-    void srl_memhl();
-    void srl_a();
+    using opcode_handler = void (basic_sharpsm83::*)();
 
-    // 0x40 - 0x4F
-    void bit_0_b();
-    void bit_0_c();
-    void bit_0_d();
-    void bit_0_e();
-    void bit_0_h();
-    void bit_0_l();
-    void bit_0_memhl();
-    void bit_0_a();
-
-    void bit_1_b();
-    void bit_1_c();
-    void bit_1_d();
-    void bit_1_e();
-    void bit_1_h();
-    void bit_1_l();
-    void bit_1_memhl();
-    void bit_1_a();
+    // normal instructions, shared by every cpu instance
+    static const std::array< opcode_handler, 0x1<<CPU_BITS > opcode_table;
 
-    // 0x50 - 0x5F
-    void bit_2_b();
-    void bit_2_c();
-    void bit_2_d();
-    void bit_2_e();
-    void bit_2_h();
-    void bit_2_l();
-    void bit_2_memhl();
-    void bit_2_a();
-
-    void bit_3_b();
-    void bit_3_c();
-    void bit_3_d();
-    void bit_3_e();
-    void bit_3_h();
-    void bit_3_l();
-    void bit_3_memhl();
-    void bit_3_a();
-
-    // 0x60 - 0x6F
-    void bit_4_b();
-    void bit_4_c();
-    void bit_4_d();
-    void bit_4_e();
-    void bit_4_h();
-    void bit_4_l();
-    void bit_4_memhl();
-    void bit_4_a();
-
-    void bit_5_b();
-    void bit_5_c();
-    void bit_5_d();
-    void bit_5_e();
-    void bit_5_h();
-    void bit_5_l();
-    void bit_5_memhl();
-    void bit_5_a();
-
-    // 0x70 - 0x7F
-    void bit_6_b();
-    void bit_6_c();
-    void bit_6_d();
-    void bit_6_e();
-    void bit_6_h();
-    void bit_6_l();
-    void bit_6_memhl();
-    void bit_6_a();
-
-    void bit_7_b();
-    void bit_7_c();
-    void bit_7_d();
-    void bit_7_e();
-    void bit_7_h();
-    void bit_7_l();
-    void bit_7_memhl();
-    void bit_7_a();
-
-    // 0x80 - 0x8F
-    void res_0_b();
-    void res_0_c();
-    void res_0_d();
-    void res_0_e();
-    void res_0_h();
-    void res_0_l();
-    void res_0_memhl();
-    void res_0_a();
-
-    void res_1_b();
-    void res_1_c();
-    void res_1_d();
-    void res_1_e();
-    void res_1_h();
-    void res_1_l();
-    void res_1_memhl();
-    void res_1_a();
-
-    // 0x90 - 0x9F
-    void res_2_b();
-    void res_2_c();
-    void res_2_d();
-    void res_2_e();
-    void res_2_h();
-    void res_2_l();
-    void res_2_memhl();
-    void res_2_a();
-
-    void res_3_b();
-    void res_3_c();
-    void res_3_d();
-    void res_3_e();
-    void res_3_h();
-    void res_3_l();
-    void res_3_memhl();
-    void res_3_a();
-
-    // 0xA0 - 0xAF
-    void res_4_b();
-    void res_4_c();
-    void res_4_d();
-    void res_4_e();
-    void res_4_h();
-    void res_4_l();
-    void res_4_memhl();
-    void res_4_a();
-
-    void res_5_b();
-    void res_5_c();
-    void res_5_d();
-    void res_5_e();
-    void res_5_h();
-    void res_5_l();
-    void res_5_memhl();
-    void res_5_a();
-
-    // 0xB0 - 0xBF
-    void res_6_b();
-    void res_6_c();
-    void res_6_d();
-    void res_6_e();
-    void res_6_h();
-    void res_6_l();
-    void res_6_memhl();
-    void res_6_a();
-
-    void res_7_b();
-    void res_7_c();
-    void res_7_d();
-    void res_7_e();
-    void res_7_h();
-    void res_7_l();
-    void res_7_memhl();
-    void res_7_a();
-
-    // 0xC0 - 0xCF
-    void set_0_b();
-    void set_0_c();
-    void set_0_d();
-    void set_0_e();
-    void set_0_h();
-    void set_0_l();
-    void set_0_memhl();
-    void set_0_a();
-
-    void set_1_b();
-    void set_1_c();
-    void set_1_d();
-    void set_1_e();
-    void set_1_h();
-    void set_1_l();
-    void set_1_memhl();
-    void set_1_a();
-
-    // 0xD0 - 0xDF
-    void set_2_b();
-    void set_2_c();
-    void set_2_d();
-    void set_2_e();
-    void set_2_h();
-    void set_2_l();
-    void set_2_memhl();
-    void set_2_a();
-
-    void set_3_b();
-    void set_3_c();
-    void set_3_d();
-    void set_3_e();
-    void set_3_h();
-    void set_3_l();
-    void set_3_memhl();
-    void set_3_a();
-
-    // 0xE0 - 0xEF
-    void set_4_b();
-    void set_4_c();
-    void set_4_d();
-    void set_4_e();
-    void set_4_h();
-    void set_4_l();
-    void set_4_memhl();
-    void set_4_a();
-
-    void set_5_b();
-    void set_5_c();
-    void set_5_d();
-    void set_5_e();
-    void set_5_h();
-    void set_5_l();
-    void set_5_memhl();
-    void set_5_a();
-
-    // 0xF0 - 0xFF
-    void set_6_b();
-    void set_6_c();
-    void set_6_d();
-    void set_6_e();
-    void set_6_h();
-    void set_6_l();
-    void set_6_memhl();
-    void set_6_a();
-
-    void set_7_b();
-    void set_7_c();
-    void set_7_d();
-    void set_7_e();
-    void set_7_h();
-    void set_7_l();
-    void set_7_memhl();
-    void set_7_a();
-
-
-    using OpcodeHandler = std::function<void(void)>;
-
-    // normal instructions
-    std::array< OpcodeHandler, 0x1<<CPU_BITS > opcode_table;
-
-    // 0xCB prefix instructions
-    std::array< OpcodeHandler, 0x1<<CPU_BITS > CB_opcode_table;
-
-    void initialize_opcodes();
-    void initialize_cbopcodes();
+    // 0xCB prefix instructions, shared by every cpu instance
+    static const std::array< opcode_handler, 0x1<<CPU_BITS > CB_opcode_table;
 
     void emulate_cycles(int cycles);
     long unsigned int cycle_count = 0;
 
+    // cycles the bus hasn't seen yet, always 0 with sm83_exact_timing
+    int unsynced_cycles = 0;
+
+    // hands unsynced_cycles to the bus
+    void sync_cycles();
+
     bool branch_taken = false;
 public:
-    sharpsm83();
-    ~sharpsm83();
+    basic_sharpsm83();
+    ~basic_sharpsm83();
 
-    void set_bus(const std::shared_ptr<gb_bus>& b);
+    void set_bus(const std::shared_ptr<bus_type>& b);
 
     int tick();
 
@@ -895,6 +794,37 @@ public:
 
     void print_registers();
 
+    // the whole register file, e.g. for save states
+    const sm83_registers& get_registers();
+    void set_registers(const sm83_registers& registers);
+
+    void set_block_cache_enabled(bool enabled);
+    sm83_block_cache& get_block_cache();
+
+    void set_idle_loop_skip_enabled(bool enabled);
+    sm83_idle_loop_detector& get_idle_loop_detector();
+
+    void set_loop_idioms_enabled(bool enabled);
+    const sm83_loop_idiom_stats& get_loop_idiom_stats();
+
+    void set_fusion_enabled(bool enabled);
+    const sm83_fusion_stats& get_fusion_stats();
+
+#ifdef CPU_JIT
+    // false runs every block on the interpreter, for differential checking
+    void set_jit_enabled(bool enabled);
+    void set_jit_threshold(uint32_t threshold);
+    sm83_jit& get_jit();
+#endif
+
+#ifdef CPU_AOT
+    // the module sm83_aot built from the inserted cartridge, false if it
+    // doesn't load or belongs to another ROM
+    bool load_aot_module(const std::string& path);
+    void set_aot_enabled(bool enabled);
+    sm83_aot& get_aot();
+#endif
+
     void reset();
 
     void set_IE(uint8_t value);
@@ -902,9 +832,20 @@ public:
     void set_IF(uint8_t value);
     uint8_t get_IF();
 
+    // I/O handlers for IF (0xFF0F) and IE (0xFFFF)
+    static uint8_t read_IF(void* context, const uint16_t& address);
+    static void write_IF(void* context, const uint16_t& address, const uint8_t& data);
+    static uint8_t read_IE(void* context, const uint16_t& address);
+    static void write_IE(void* context, const uint16_t& address, const uint8_t& data);
+
     long int get_cycle_count();
 };
 
+using sharpsm83 = basic_sharpsm83<gb_bus, sm83_exact_timing>;
+using fast_sharpsm83 = basic_sharpsm83<gb_bus, sm83_fast_timing>;
+
+extern template struct basic_sharpsm83<gb_bus, sm83_exact_timing>;
+extern template struct basic_sharpsm83<gb_bus, sm83_fast_timing>;
 
 
 #endif
\ No newline at end of file
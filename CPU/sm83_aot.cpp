@@ -0,0 +1,119 @@
+#include <iostream>
+
+#include <dlfcn.h>
+
+#include "sm83_aot.hpp"
+
+//##############################################################################
+sm83_aot::~sm83_aot()
+{
+    unload();
+}
+//##############################################################################
+uint32_t sm83_aot::rom_hash(const std::vector<uint8_t>& rom)
+{
+    uint32_t hash = 2166136261u;
+
+    for(uint8_t byte : rom)
+    {
+        hash = (hash ^ byte) * 16777619u;
+    }
+
+    return hash;
+}
+//##############################################################################
+bool sm83_aot::load(const std::string& path, const std::vector<uint8_t>& rom, const sm83_aot_step_table* steps)
+{
+    unload();
+
+    void* library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+    if(!library)
+    {
+        std::cout<<"AOT: can't open "<<path<<": "<<dlerror()<<'\n';
+        return false;
+    }
+
+    using module_function = const sm83_aot_module* (*)();
+    module_function get_module = reinterpret_cast<module_function>(dlsym(library, SM83_AOT_MODULE_FUNCTION));
+
+    const sm83_aot_module* loaded = get_module ? get_module() : nullptr;
+
+    if(!loaded)
+    {
+        std::cout<<"AOT: "<<path<<" is not an sm83_aot module"<<'\n';
+    }
+    else if(loaded->abi_version != SM83_AOT_ABI_VERSION)
+    {
+        std::cout<<"AOT: "<<path<<" was built for ABI version "<<std::dec<<loaded->abi_version
+            <<", this core has version "<<SM83_AOT_ABI_VERSION<<'\n';
+        loaded = nullptr;
+    }
+    else if(loaded->rom_size != rom.size() || loaded->rom_hash != rom_hash(rom))
+    {
+        std::cout<<"AOT: "<<path<<" was built from a different ROM"<<'\n';
+        loaded = nullptr;
+    }
+
+    if(!loaded)
+    {
+        dlclose(library);
+        return false;
+    }
+
+    handle = library;
+    module = loaded;
+    module->bind(steps);
+
+    blocks.reserve(module->block_count);
+
+    for(uint32_t i = 0; i < module->block_count; ++i)
+    {
+        blocks[module->blocks[i].key] = &module->blocks[i];
+    }
+
+    return true;
+}
+//##############################################################################
+void sm83_aot::unload()
+{
+    blocks.clear();
+    module = nullptr;
+
+    if(handle)
+    {
+        dlclose(handle);
+        handle = nullptr;
+    }
+}
+//##############################################################################
+bool sm83_aot::is_loaded() const
+{
+    return module != nullptr;
+}
+//##############################################################################
+sm83_native_code sm83_aot::find(uint32_t key, std::size_t instruction_count)
+{
+    auto it = blocks.find(key);
+
+    if(it == blocks.end()) return nullptr;
+
+    // the tool decodes with sm83_block_cache::decode too, this only trips
+    // if the core changed without a new ABI version
+    if(it->second->instruction_count != instruction_count)
+    {
+        mismatched_blocks++;
+        return nullptr;
+    }
+
+    attached_blocks++;
+
+    return it->second->code;
+}
+//##############################################################################
+void sm83_aot::print_stats()
+{
+    std::cout<<"AOT: "<<std::dec<<(module ? module->block_count : 0)<<" blocks in the module, "
+        <<attached_blocks<<" attached, "
+        <<mismatched_blocks<<" mismatched"<<'\n';
+}
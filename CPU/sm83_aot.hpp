@@ -0,0 +1,91 @@
+#ifndef _SM83_AOT_
+#define _SM83_AOT_
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "sm83_block_cache.hpp"
+
+// Blocks of a ROM compiled ahead of time by the sm83_aot tool (AOT/).
+//
+// The tool writes C++ for every block it can reach from the entry points of a
+// cartridge, which is built into a shared object. Every instruction of a
+// generated block is a call to a step function of the interpreter core, with
+// the opcode known at compile time, so bus accesses and cycle counting stay
+// exactly the same. Blocks the tool didn't find keep running on the
+// interpreter.
+
+// bumped whenever sm83_decoded_instr or the module layout below changes
+#define SM83_AOT_ABI_VERSION 1
+
+// the function every module exports, returning its sm83_aot_module
+#define SM83_AOT_MODULE_FUNCTION "sm83_aot_get_module"
+
+// executes instruction index of the running block, false ends the block
+using sm83_aot_step = bool (*)(sharpsm83* cpu, const sm83_decoded_instr* instr, uint8_t index);
+
+// the step of every opcode, by opcode
+using sm83_aot_step_table = std::array<sm83_aot_step, 256>;
+
+struct sm83_aot_block
+{
+    // block cache key, see sm83_block_cache::make_key
+    uint32_t key;
+    uint8_t instruction_count;
+    sm83_native_code code;
+};
+
+struct sm83_aot_module
+{
+    uint32_t abi_version;
+
+    // the ROM the module was compiled from
+    uint32_t rom_size;
+    uint32_t rom_hash;
+
+    uint32_t block_count;
+    const sm83_aot_block* blocks;
+
+    // hands the module the step table of the loading core
+    void (*bind)(const sm83_aot_step_table* steps);
+};
+
+class sm83_aot
+{
+private:
+    void* handle = nullptr;
+    const sm83_aot_module* module = nullptr;
+
+    std::unordered_map<uint32_t, const sm83_aot_block*> blocks;
+
+    unsigned long int attached_blocks = 0;
+    unsigned long int mismatched_blocks = 0;
+public:
+    sm83_aot() = default;
+    ~sm83_aot();
+
+    sm83_aot(const sm83_aot&) = delete;
+    sm83_aot& operator=(const sm83_aot&) = delete;
+
+    // FNV-1a over the whole ROM, ties a module to the ROM it came from
+    static uint32_t rom_hash(const std::vector<uint8_t>& rom);
+
+    // false (and nothing loaded) if the module can't be opened or was built
+    // for another ROM or another version of the core
+    bool load(const std::string& path, const std::vector<uint8_t>& rom, const sm83_aot_step_table* steps);
+    void unload();
+
+    bool is_loaded() const;
+
+    // code of the block at key, nullptr if the module doesn't have it or the
+    // core decoded it differently
+    sm83_native_code find(uint32_t key, std::size_t instruction_count);
+
+    void print_stats();
+};
+
+#endif
@@ -0,0 +1,236 @@
+#include <iostream>
+#include "sm83_block_cache.hpp"
+
+//##############################################################################
+const std::array<uint8_t, 256> sm83_block_cache::instruction_length =
+{
+    1, 3, 1, 1, 1, 1, 2, 1, 3, 1, 1, 1, 1, 1, 2, 1, // 0x00
+    2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 0x10
+    2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 0x20
+    2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 0x30
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x40
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x50
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x60
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x70
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x80
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x90
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0xA0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0xB0
+    1, 1, 3, 3, 3, 1, 2, 1, 1, 1, 3, 2, 3, 3, 2, 1, // 0xC0
+    1, 1, 3, 1, 3, 1, 2, 1, 1, 1, 3, 1, 3, 1, 2, 1, // 0xD0
+    2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1, // 0xE0
+    2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1  // 0xF0
+};
+//##############################################################################
+const std::array<uint8_t, 256> sm83_block_cache::instruction_cycles =
+{
+    1, 3, 2, 2, 1, 1, 2, 1, 5, 2, 2, 2, 1, 1, 2, 1, // 0x00
+    1, 3, 2, 2, 1, 1, 2, 1, 3, 2, 2, 2, 1, 1, 2, 1, // 0x10
+    2, 3, 2, 2, 1, 1, 2, 1, 2, 2, 2, 2, 1, 1, 2, 1, // 0x20
+    2, 3, 2, 2, 3, 3, 3, 1, 2, 2, 2, 2, 1, 1, 2, 1, // 0x30
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1, // 0x40
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1, // 0x50
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1, // 0x60
+    2, 2, 2, 2, 2, 2, 1, 2, 1, 1, 1, 1, 1, 1, 2, 1, // 0x70
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1, // 0x80
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1, // 0x90
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1, // 0xA0
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1, // 0xB0
+    2, 3, 3, 4, 3, 4, 2, 4, 2, 4, 3, 1, 3, 6, 2, 4, // 0xC0
+    2, 3, 3, 1, 3, 4, 2, 4, 2, 4, 3, 1, 3, 1, 2, 4, // 0xD0
+    3, 3, 2, 1, 1, 4, 2, 4, 4, 1, 4, 1, 1, 1, 2, 4, // 0xE0
+    3, 3, 2, 1, 1, 4, 2, 4, 3, 2, 4, 1, 1, 1, 2, 4  // 0xF0
+};
+//##############################################################################
+uint8_t sm83_block_cache::cb_instruction_cycles(uint8_t cb_opcode)
+{
+    if((cb_opcode & 0x07) != 0x06) return 2;
+
+    // BIT b,(HL) only reads memory
+    return (cb_opcode & 0xC0) == 0x40 ? 3 : 4;
+}
+//##############################################################################
+bool sm83_block_cache::ends_block(uint8_t opcode)
+{
+    switch(opcode)
+    {
+        // jumps
+        case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+        case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: case 0xE9:
+        // calls and returns
+        case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC:
+        case 0xC0: case 0xC8: case 0xC9: case 0xD0: case 0xD8: case 0xD9:
+        // restarts
+        case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+        // halt, stop and interrupt enable changes
+        case 0x76: case 0x10: case 0xF3: case 0xFB:
+        // unused opcodes
+        case 0xD3: case 0xDB: case 0xDD: case 0xE3: case 0xE4: case 0xEB:
+        case 0xEC: case 0xED: case 0xF4: case 0xFC: case 0xFD:
+            return true;
+        default:
+            return false;
+    }
+}
+//##############################################################################
+uint32_t sm83_block_cache::make_key(uint16_t address, uint32_t rom_bank)
+{
+    if(0x4000 <= address && address <= 0x7FFF)
+    {
+        return (rom_bank << 16) | address;
+    }
+
+    return address;
+}
+//##############################################################################
+const sm83_block* sm83_block_cache::find(uint32_t key)
+{
+    auto it = blocks.find(key);
+
+    if(it == blocks.end()) return nullptr;
+
+    hits++;
+
+    return &it->second;
+}
+//##############################################################################
+const sm83_block* sm83_block_cache::get(uint32_t key) const
+{
+    auto it = blocks.find(key);
+
+    return it == blocks.end() ? nullptr : &it->second;
+}
+//##############################################################################
+const sm83_block* sm83_block_cache::insert(uint32_t key, uint16_t address, sm83_block&& block)
+{
+    decoded_blocks++;
+
+    block.key = key;
+
+    // ROM can't be written, only RAM pages have to be tracked
+    if(address >= 0x8000)
+    {
+        uint8_t page = ram_page(address);
+
+        blocks_by_page[page].push_back(key);
+        code_pages[page] = true;
+
+        mark_code(address, block);
+    }
+
+    return &(blocks[key] = std::move(block));
+}
+//##############################################################################
+void sm83_block_cache::mark_code(uint16_t address, const sm83_block& block)
+{
+    const sm83_decoded_instr& last = block.instructions.back();
+
+    // blocks don't cross their page, so neither does the range
+    uint16_t first = ram_address(address);
+    uint16_t end = first + (last.address + last.length - address);
+
+    for(uint16_t byte = first; byte != end; ++byte)
+    {
+        code_bytes[byte] = true;
+    }
+}
+//##############################################################################
+void sm83_block_cache::link(const sm83_block& block, uint16_t address, const sm83_block* successor)
+{
+    if(block.link_generation != link_generation)
+    {
+        block.successors = {};
+        block.link_generation = link_generation;
+    }
+
+    const sm83_decoded_instr& last = block.instructions.back();
+    int exit = address == static_cast<uint16_t>(last.address + last.length);
+
+    block.successors[exit] = successor;
+    block.successor_addresses[exit] = address;
+}
+//##############################################################################
+void sm83_block_cache::unlink_all()
+{
+    link_generation++;
+}
+//##############################################################################
+bool sm83_block_cache::is_code_page(uint16_t address) const
+{
+    return code_pages[ram_page(address)];
+}
+//##############################################################################
+const bool* sm83_block_cache::get_code_pages() const
+{
+    return code_pages.data();
+}
+//##############################################################################
+void sm83_block_cache::invalidate(uint16_t address)
+{
+    uint16_t written = ram_address(address);
+    uint8_t page = written >> 8;
+
+    std::vector<uint32_t>& keys = blocks_by_page[page];
+    std::size_t kept = 0;
+
+    for(uint32_t key : keys)
+    {
+        auto it = blocks.find(key);
+
+        const sm83_decoded_instr& last = it->second.instructions.back();
+
+        uint16_t first = ram_address(key);
+        uint16_t end = first + (last.address + last.length - key);
+
+        if(first <= written && written < end)
+        {
+            blocks.erase(it);
+            invalidated_blocks++;
+        }
+        else
+        {
+            keys[kept++] = key;
+        }
+    }
+
+    keys.resize(kept);
+
+    // the bytes of the blocks left over
+    for(int byte = 0; byte < 256; ++byte)
+    {
+        code_bytes[(page << 8) | byte] = false;
+    }
+
+    for(uint32_t key : keys)
+    {
+        mark_code(key, blocks[key]);
+    }
+
+    code_pages[page] = !keys.empty();
+
+    // links to the dropped blocks would dangle
+    unlink_all();
+}
+//##############################################################################
+void sm83_block_cache::clear()
+{
+    blocks.clear();
+
+    for(auto& keys : blocks_by_page)
+    {
+        keys.clear();
+    }
+    code_pages.fill(false);
+    code_bytes.reset();
+
+    unlink_all();
+}
+//##############################################################################
+void sm83_block_cache::print_stats()
+{
+    std::cout<<"Block cache: "<<std::dec<<blocks.size()<<" blocks, "
+        <<decoded_blocks<<" decoded, "
+        <<hits<<" hits, "
+        <<linked_hits<<" linked, "
+        <<invalidated_blocks<<" invalidated"<<'\n';
+}
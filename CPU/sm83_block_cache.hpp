@@ -0,0 +1,198 @@
+#ifndef _SM83_BLOCK_CACHE_
+#define _SM83_BLOCK_CACHE_
+
+#include <cstdint>
+#include <array>
+#include <bitset>
+#include <vector>
+#include <unordered_map>
+
+#include "sm83_loop_idiom.hpp"
+
+struct gb_bus;
+struct sm83_exact_timing;
+template<typename bus_type, typename timing_policy> struct basic_sharpsm83;
+using sharpsm83 = basic_sharpsm83<gb_bus, sm83_exact_timing>;
+
+// entry point of a block compiled to native code, always for the cycle exact
+// core on the Game Boy bus
+using sm83_native_code = void (*)(sharpsm83* cpu);
+
+// One pre-decoded SM83 instruction: the opcode and its immediate bytes
+// (or the second byte of a 0xCB instruction).
+struct sm83_decoded_instr
+{
+    uint16_t address;
+    uint8_t opcode;
+    std::array<uint8_t, 2> operands;
+    uint8_t length;
+    // machine cycles when no branch is taken
+    uint8_t cycles;
+    // this and the next instruction form a fused pair (sm83_fusion), 0 if not
+    uint8_t fusion = 0;
+};
+
+// A straight-line run of instructions, ending at the first control flow
+// instruction or at the end of the 256 byte page it started in.
+struct sm83_block
+{
+    // make_key of its address, set when it is inserted
+    uint32_t key = 0;
+
+    std::vector<sm83_decoded_instr> instructions;
+    // machine cycles of the whole run when no branch is taken
+    uint32_t cycles = 0;
+
+    // address the block polls if it is an idle loop, 0 otherwise
+    uint16_t idle_poll_address = 0;
+
+    // memset, memcpy or delay loop the block runs, if any
+    sm83_loop_idiom idiom;
+
+    // code the AOT module (sm83_aot) has for this block, if one is loaded
+    sm83_native_code aot_code = nullptr;
+
+    // the blocks execution last went on to from this one, by exit (0 a
+    // branch, 1 falling through), as long as link_generation is the cache's
+    mutable std::array<const sm83_block*, 2> successors{};
+    mutable std::array<uint16_t, 2> successor_addresses{};
+    mutable uint32_t link_generation = 0;
+
+    // JIT bookkeeping, not part of the decoded code
+    mutable uint32_t executions = 0;
+    mutable sm83_native_code native_code = nullptr;
+};
+
+class sm83_block_cache
+{
+private:
+    std::unordered_map<uint32_t, sm83_block> blocks;
+
+    // keys of the blocks decoded from each RAM page, so a write to the page
+    // can drop them
+    std::array<std::vector<uint32_t>, 256> blocks_by_page;
+    std::array<bool, 256> code_pages{};
+
+    // the RAM bytes decoded blocks were read from, a write elsewhere in the
+    // page leaves them alone
+    std::bitset<0x10000> code_bytes;
+
+    // bumped when a block is dropped or the ROM bank may have changed, which
+    // breaks every link between blocks
+    uint32_t link_generation = 1;
+
+    unsigned long int hits = 0;
+    unsigned long int linked_hits = 0;
+    unsigned long int decoded_blocks = 0;
+    unsigned long int invalidated_blocks = 0;
+
+    // echo RAM (0xE000-0xFDFF) aliases 0xC000-0xDDFF
+    static uint16_t ram_address(uint16_t address)
+    {
+        return (0xE000 <= address && address <= 0xFDFF) ? address - 0x2000 : address;
+    }
+    static uint8_t ram_page(uint16_t address) { return ram_address(address) >> 8; }
+
+    // sets the code_bytes of a block decoded from RAM
+    void mark_code(uint16_t address, const sm83_block& block);
+public:
+    static const uint8_t MAX_BLOCK_INSTRUCTIONS = 32;
+
+    // instruction length in bytes and machine cycles, by opcode
+    static const std::array<uint8_t, 256> instruction_length;
+    static const std::array<uint8_t, 256> instruction_cycles;
+    static uint8_t cb_instruction_cycles(uint8_t cb_opcode);
+
+    // true if the instruction ends a straight-line run
+    static bool ends_block(uint8_t opcode);
+
+    // the run of instructions at address, read(pc) gives the byte at pc and
+    // cacheable(pc) whether it may be part of a block
+    template<typename read_function, typename cacheable_function>
+    static sm83_block decode(uint16_t address, read_function read, cacheable_function cacheable);
+
+    // code at 0x4000-0x7FFF is keyed by the ROM bank mapped there
+    static uint32_t make_key(uint16_t address, uint32_t rom_bank);
+
+    const sm83_block* find(uint32_t key);
+    // find() without counting a hit, for bookkeeping
+    const sm83_block* get(uint32_t key) const;
+    const sm83_block* insert(uint32_t key, uint16_t address, sm83_block&& block);
+
+    // the block execution went on to from block at address, without a
+    // lookup, inline as it runs on every block entry
+    const sm83_block* find_successor(const sm83_block& block, uint16_t address)
+    {
+        if(block.link_generation != link_generation) return nullptr;
+
+        for(int exit = 0; exit < 2; ++exit)
+        {
+            if(block.successors[exit] && block.successor_addresses[exit] == address)
+            {
+                linked_hits++;
+
+                return block.successors[exit];
+            }
+        }
+
+        return nullptr;
+    }
+    void link(const sm83_block& block, uint16_t address, const sm83_block* successor);
+    // after an MBC write, the links into 0x4000-0x7FFF may be to another bank
+    void unlink_all();
+
+    bool is_code_page(uint16_t address) const;
+
+    // on every RAM write, inline like gb_bus::bus_read
+    bool is_code(uint16_t address) const
+    {
+        return code_pages[ram_page(address)] && code_bytes[ram_address(address)];
+    }
+    // drops the blocks of the page decoded from address
+    void invalidate(uint16_t address);
+
+    // one flag per page, echo RAM pages go through WRAM's
+    const bool* get_code_pages() const;
+
+    void clear();
+
+    void print_stats();
+};
+//##############################################################################
+template<typename read_function, typename cacheable_function>
+sm83_block sm83_block_cache::decode(uint16_t address, read_function read, cacheable_function cacheable)
+{
+    sm83_block block;
+
+    uint16_t pc = address;
+
+    while(block.instructions.size() < MAX_BLOCK_INSTRUCTIONS)
+    {
+        uint8_t opcode = read(pc);
+        uint8_t length = instruction_length[opcode];
+
+        // the whole instruction has to come from the same page
+        if(((pc + length - 1) >> 8) != (address >> 8) || !cacheable(pc + length - 1)) break;
+
+        sm83_decoded_instr instr;
+        instr.address = pc;
+        instr.opcode = opcode;
+        instr.length = length;
+        instr.operands[0] = length > 1 ? read(pc + 1) : 0x00;
+        instr.operands[1] = length > 2 ? read(pc + 2) : 0x00;
+        instr.cycles = opcode == 0xCB ? 
+            cb_instruction_cycles(instr.operands[0]) : 
+            instruction_cycles[opcode];
+
+        block.instructions.push_back(instr);
+        block.cycles += instr.cycles;
+
+        pc += length;
+
+        if(ends_block(opcode)) break;
+    }
+
+    return block;
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include <iostream>
+#include "sm83_fusion.hpp"
+
+struct sm83_fused_pair
+{
+    uint8_t first;
+    uint8_t second;
+    const char* name;
+};
+
+#define SM83_FUSION_ENTRY(first, second, name) {first, second, name},
+
+const std::array<sm83_fused_pair, sm83_fusion::COUNT> fused_pairs =
+{{
+    SM83_FUSED_PAIRS(SM83_FUSION_ENTRY)
+}};
+
+#undef SM83_FUSION_ENTRY
+//##############################################################################
+uint8_t sm83_fusion::match(uint8_t first, uint8_t second)
+{
+    for(uint8_t i = 0; i < COUNT; ++i)
+    {
+        if(fused_pairs[i].first == first && fused_pairs[i].second == second) return i + 1;
+    }
+
+    return 0;
+}
+//##############################################################################
+const char* sm83_fusion::name(uint8_t fusion)
+{
+    if(fusion == 0 || fusion > COUNT) return "none";
+
+    return fused_pairs[fusion - 1].name;
+}
+//##############################################################################
+void sm83_fusion_stats::print_stats() const
+{
+    unsigned long int total = 0;
+
+    for(uint8_t i = 1; i <= sm83_fusion::COUNT; ++i)
+    {
+        std::cout<<"Fused "<<sm83_fusion::name(i)<<": "<<std::dec<<hits[i]<<'\n';
+
+        total += hits[i];
+    }
+
+    std::cout<<"Fused pairs: "<<std::dec<<total<<" runs"<<'\n';
+}
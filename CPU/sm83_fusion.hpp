@@ -0,0 +1,44 @@
+#ifndef _SM83_FUSION_
+#define _SM83_FUSION_
+
+#include <cstdint>
+#include <array>
+
+// Instruction pairs the decoded path runs as one step, X(first, second, name).
+// Both halves still go through their own handlers with their own timing, the
+// pair only saves the dispatch and the per-instruction bookkeeping of the
+// second one.
+#define SM83_FUSED_PAIRS(X) \
+    X(0x2A, 0x12, "LD A,(HL+) ; LD (DE),A") \
+    X(0x1A, 0x22, "LD A,(DE) ; LD (HL+),A") \
+    X(0x05, 0x20, "DEC B ; JR NZ,e8") \
+    X(0x0D, 0x20, "DEC C ; JR NZ,e8") \
+    X(0x3D, 0x20, "DEC A ; JR NZ,e8") \
+    X(0xFE, 0x28, "CP d8 ; JR Z,e8") \
+    X(0xFE, 0x20, "CP d8 ; JR NZ,e8") \
+    X(0xE6, 0x20, "AND d8 ; JR NZ,e8") \
+    X(0xF0, 0xE6, "LDH A,(a8) ; AND d8") \
+    X(0xF0, 0xFE, "LDH A,(a8) ; CP d8") \
+    X(0x78, 0xB1, "LD A,B ; OR C")
+
+struct sm83_fusion
+{
+    #define SM83_FUSION_COUNT(first, second, name) + 1
+    static constexpr uint8_t COUNT = 0 SM83_FUSED_PAIRS(SM83_FUSION_COUNT);
+    #undef SM83_FUSION_COUNT
+
+    // 1-based index of the pair in SM83_FUSED_PAIRS, 0 if it is not fused
+    static uint8_t match(uint8_t first, uint8_t second);
+
+    static const char* name(uint8_t fusion);
+};
+
+// How often each pair ran fused, by index
+struct sm83_fusion_stats
+{
+    std::array<unsigned long int, sm83_fusion::COUNT + 1> hits{};
+
+    void print_stats() const;
+};
+
+#endif
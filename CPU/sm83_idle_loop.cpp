@@ -0,0 +1,123 @@
+#include <iostream>
+#include "sm83_idle_loop.hpp"
+
+//##############################################################################
+uint16_t sm83_idle_loop_detector::find_polled_address(const sm83_block& block)
+{
+    const std::vector<sm83_decoded_instr>& instructions = block.instructions;
+
+    if(instructions.size() < 2 || instructions.size() > 8) return 0;
+
+    // the loop starts by loading the polled value into A
+    const sm83_decoded_instr& load = instructions.front();
+    uint16_t polled_address;
+
+    switch(load.opcode)
+    {
+        case 0xF0: polled_address = 0xFF00 + load.operands[0]; break;       // LDH A,(a8)
+        case 0xFA: polled_address = load.operands[0] | (load.operands[1] << 8); break; // LD A,(a16)
+        default: return 0;
+    }
+
+    // and ends with a conditional jump back to that load
+    const sm83_decoded_instr& branch = instructions.back();
+    uint16_t target;
+
+    switch(branch.opcode)
+    {
+        case 0x20: case 0x28: case 0x30: case 0x38: // JR cc,r8
+            target = branch.address + 2 + static_cast<int8_t>(branch.operands[0]);
+            break;
+        case 0xC2: case 0xCA: case 0xD2: case 0xDA: // JP cc,a16
+            target = branch.operands[0] | (branch.operands[1] << 8);
+            break;
+        default: return 0;
+    }
+
+    if(target != load.address) return 0;
+
+    // in between only A and F may change, and only from A and registers the
+    // loop never writes, so an iteration depends on nothing but the polled value
+    for(std::size_t i = 1; i + 1 < instructions.size(); ++i)
+    {
+        const sm83_decoded_instr& instr = instructions[i];
+
+        switch(instr.opcode)
+        {
+            case 0xFE: // CP d8
+            case 0xE6: // AND d8
+            case 0xF6: // OR d8
+            case 0xEE: // XOR d8
+            case 0xD6: // SUB d8
+            case 0xA0: case 0xA1: case 0xA2: case 0xA3: case 0xA4: case 0xA5: case 0xA7: // AND r
+            case 0xB0: case 0xB1: case 0xB2: case 0xB3: case 0xB4: case 0xB5: case 0xB7: // OR r
+            case 0xB8: case 0xB9: case 0xBA: case 0xBB: case 0xBC: case 0xBD: case 0xBF: // CP r
+                break;
+            case 0xCB: // BIT b,A
+                if((instr.operands[0] & 0xC7) != 0x47) return 0;
+                break;
+            default:
+                return 0;
+        }
+    }
+
+    return polled_address;
+}
+//##############################################################################
+uint32_t sm83_idle_loop_detector::enter(const sm83_block& block, uint64_t now, uint64_t stable_until)
+{
+    // the closing branch is taken one cycle slower
+    uint32_t iteration_cycles = block.cycles + 1;
+    uint64_t iteration = 4ull * iteration_cycles;
+
+    // exactly one iteration ran since the loop was armed, no interrupt in between
+    if(armed_block == &block && now - armed_time == iteration && armed_until > now)
+    {
+        // every skipped iteration reads the polled value before it can change
+        uint64_t iterations = (armed_until - now) / iteration;
+
+        if(iterations > 0)
+        {
+            armed_block = nullptr;
+
+            sm83_idle_loop_stats& loop = stats[block.instructions.front().address];
+            loop.polled_address = block.idle_poll_address;
+            loop.skips++;
+            loop.skipped_cycles += iterations * iteration_cycles;
+
+            return iterations * iteration_cycles;
+        }
+    }
+
+    armed_block = &block;
+    armed_time = now;
+    armed_until = stable_until;
+
+    return 0;
+}
+//##############################################################################
+const std::map<uint16_t, sm83_idle_loop_stats>& sm83_idle_loop_detector::get_stats() const
+{
+    return stats;
+}
+//##############################################################################
+void sm83_idle_loop_detector::clear()
+{
+    armed_block = nullptr;
+    stats.clear();
+}
+//##############################################################################
+void sm83_idle_loop_detector::print_stats()
+{
+    unsigned long int total = 0;
+
+    for(const auto& [address, loop] : stats)
+    {
+        std::cout<<"Idle loop 0x"<<std::hex<<address<<" polling 0x"<<loop.polled_address<<": "
+            <<std::dec<<loop.skips<<" skips, "<<loop.skipped_cycles<<" cycles skipped"<<'\n';
+
+        total += loop.skipped_cycles;
+    }
+
+    std::cout<<"Idle loops: "<<std::dec<<stats.size()<<" loops, "<<total<<" cycles skipped"<<'\n';
+}
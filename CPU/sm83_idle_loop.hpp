@@ -0,0 +1,51 @@
+#ifndef _SM83_IDLE_LOOP_
+#define _SM83_IDLE_LOOP_
+
+#include <cstdint>
+#include <map>
+
+#include "sm83_block_cache.hpp"
+
+// How much time was skipped in one idle loop
+struct sm83_idle_loop_stats
+{
+    uint16_t polled_address = 0;
+    unsigned long int skips = 0;
+    // machine cycles
+    unsigned long int skipped_cycles = 0;
+};
+
+// Recognizes blocks that only spin on a register until it changes, like
+//     LDH A,(0x44) ; CP 0x90 ; JR NZ,-6
+// Every iteration of such a loop does the same thing as long as the polled
+// value stays the same, so once one iteration has been watched the rest of
+// them, up to the next possible change, can be skipped at once.
+class sm83_idle_loop_detector
+{
+private:
+    // the idle loop entered last, when, and until when its polled value holds
+    const sm83_block* armed_block = nullptr;
+    uint64_t armed_time = 0;
+    uint64_t armed_until = 0;
+
+    // by address of the loop
+    std::map<uint16_t, sm83_idle_loop_stats> stats;
+public:
+    // address polled by the block if it is an idle loop, 0 otherwise
+    static uint16_t find_polled_address(const sm83_block& block);
+
+    // called each time an idle loop is entered at its start, now and
+    // stable_until in T-cycles; returns the machine cycles that can be skipped,
+    // 0 while the loop still has to run an iteration
+    uint32_t enter(const sm83_block& block, uint64_t now, uint64_t stable_until);
+
+    // something other than the armed loop ran
+    void disarm() { armed_block = nullptr; }
+
+    const std::map<uint16_t, sm83_idle_loop_stats>& get_stats() const;
+    void clear();
+
+    void print_stats();
+};
+
+#endif
@@ -0,0 +1,834 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <array>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "sm83_jit.hpp"
+#include "cpu_sharpsm83.hpp"
+
+// x86-64 registers by their encoding, the high eight share the low three bits
+// (rbx: register file, rbp: flag table, r12/r13: read/write page tables,
+// r14: code pages, r15: scheduler)
+static const uint8_t RAX = 0;
+static const uint8_t RCX = 1;
+static const uint8_t RDX = 2;
+static const uint8_t RBX = 3;
+static const uint8_t R15 = 7;
+
+// register file offsets by the 3-bit operand of an opcode, 6 is (HL)
+static const uint8_t REGISTER[8] =
+{
+    offsetof(sm83_registers, B), offsetof(sm83_registers, C),
+    offsetof(sm83_registers, D), offsetof(sm83_registers, E),
+    offsetof(sm83_registers, H), offsetof(sm83_registers, L),
+    0xFF,                        offsetof(sm83_registers, A)
+};
+
+static const uint8_t REG_A = offsetof(sm83_registers, A);
+static const uint8_t REG_F = offsetof(sm83_registers, F);
+static const uint8_t REG_H = offsetof(sm83_registers, H);
+static const uint8_t REG_L = offsetof(sm83_registers, L);
+static const uint8_t REG_SP = offsetof(sm83_registers, SP);
+static const uint8_t REG_PC = offsetof(sm83_registers, PC);
+
+// high and low register of BC, DE, HL, by bits 5-4 of an opcode (3 is SP)
+static const uint8_t PAIR_HI[3] = {offsetof(sm83_registers, B), offsetof(sm83_registers, D), REG_H};
+static const uint8_t PAIR_LO[3] = {offsetof(sm83_registers, C), offsetof(sm83_registers, E), REG_L};
+
+// ADD ADC SUB SBC AND XOR OR CP as "op r/m8, r8", by bits 5-3 of an opcode
+static const uint8_t ALU_OPCODE[8] = {0x00, 0x10, 0x28, 0x18, 0x20, 0x30, 0x08, 0x38};
+
+// Z H C of F by the host flags lahf leaves in AH (ZF bit 6, AF bit 4, CF
+// bit 0). AF is the carry out of bit 3 for 8-bit add/adc/sub/sbb/inc/dec,
+// which is the SM83 half carry.
+static const std::array<uint8_t, 256> host_flags = []
+{
+    std::array<uint8_t, 256> table{};
+
+    for(int ah = 0; ah < 256; ++ah)
+    {
+        table[ah] = ((ah & 0x40) ? 0x80 : 0) | ((ah & 0x10) ? 0x20 : 0) | ((ah & 0x01) ? 0x10 : 0);
+    }
+
+    return table;
+}();
+
+// the instructions of a block that have a native form, with their labels
+struct native_stub
+{
+    std::size_t index;
+    std::size_t fallback;
+    std::size_t events;
+    std::size_t after;
+};
+
+//##############################################################################
+sm83_jit::sm83_jit()
+{
+    int fd = memfd_create("sm83_jit", MFD_CLOEXEC);
+
+    if(fd < 0 || ftruncate(fd, ARENA_SIZE) != 0)
+    {
+        std::cout<<"JIT: can't create the code arena!"<<'\n';
+        exit(-1);
+    }
+
+    void* writable = mmap(nullptr, ARENA_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    void* executable = mmap(nullptr, ARENA_SIZE, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+
+    // the mappings keep the memory
+    close(fd);
+
+    if(writable == MAP_FAILED || executable == MAP_FAILED)
+    {
+        std::cout<<"JIT: can't map the code arena!"<<'\n';
+        exit(-1);
+    }
+
+    arena = static_cast<uint8_t*>(writable);
+    arena_code = static_cast<uint8_t*>(executable);
+}
+//##############################################################################
+sm83_jit::~sm83_jit()
+{
+    munmap(arena, ARENA_SIZE);
+    munmap(arena_code, ARENA_SIZE);
+}
+//##############################################################################
+std::size_t sm83_jit::allocate(std::size_t size)
+{
+    for(auto it = free_ranges.begin(); it != free_ranges.end(); ++it)
+    {
+        if(it->second < size) continue;
+
+        std::size_t offset = it->first;
+        std::size_t left = it->second - size;
+
+        free_ranges.erase(it);
+        if(left) free_ranges[offset + size] = left;
+
+        return offset;
+    }
+
+    if(arena_used + size > ARENA_SIZE) return SIZE_MAX;
+
+    arena_used += size;
+
+    return arena_used - size;
+}
+//##############################################################################
+void sm83_jit::release(std::size_t offset, std::size_t size)
+{
+    // merge with the free ranges on either side
+    auto next = free_ranges.lower_bound(offset);
+
+    if(next != free_ranges.end() && offset + size == next->first)
+    {
+        size += next->second;
+        next = free_ranges.erase(next);
+    }
+
+    if(next != free_ranges.begin())
+    {
+        auto previous = std::prev(next);
+
+        if(previous->first + previous->second == offset)
+        {
+            offset = previous->first;
+            size += previous->second;
+            free_ranges.erase(previous);
+        }
+    }
+
+    // the top of the arena goes back to the bump allocator
+    if(offset + size == arena_used)
+    {
+        arena_used = offset;
+    }
+    else
+    {
+        free_ranges[offset] = size;
+    }
+}
+//##############################################################################
+std::vector<uint8_t> sm83_jit::guest_bytes(const sm83_block& block)
+{
+    std::vector<uint8_t> bytes;
+
+    for(const sm83_decoded_instr& instr : block.instructions)
+    {
+        bytes.push_back(instr.opcode);
+
+        for(int i = 1; i < instr.length; ++i)
+        {
+            bytes.push_back(instr.operands[i - 1]);
+        }
+    }
+
+    return bytes;
+}
+//##############################################################################
+void sm83_jit::emit8(uint8_t value)
+{
+    code.push_back(value);
+}
+//##############################################################################
+void sm83_jit::emit16(uint16_t value)
+{
+    emit8(value);
+    emit8(value >> 8);
+}
+//##############################################################################
+void sm83_jit::emit32(uint32_t value)
+{
+    for(int i = 0; i < 4; ++i)
+    {
+        emit8(value >> (8 * i));
+    }
+}
+//##############################################################################
+void sm83_jit::emit64(uint64_t value)
+{
+    for(int i = 0; i < 8; ++i)
+    {
+        emit8(value >> (8 * i));
+    }
+}
+//##############################################################################
+void sm83_jit::emit_address(uint8_t reg, uint8_t base, int32_t displacement)
+{
+    if(-128 <= displacement && displacement <= 127)
+    {
+        emit8(0x40 | (reg << 3) | base);
+        emit8(displacement);
+    }
+    else
+    {
+        emit8(0x80 | (reg << 3) | base);
+        emit32(displacement);
+    }
+}
+//##############################################################################
+std::size_t sm83_jit::new_label()
+{
+    labels.push_back(SIZE_MAX);
+
+    return labels.size() - 1;
+}
+//##############################################################################
+void sm83_jit::bind(std::size_t label)
+{
+    labels[label] = code.size();
+}
+//##############################################################################
+void sm83_jit::emit_jump(uint8_t condition, std::size_t label)
+{
+    if(condition == 0xFF)
+    {
+        emit8(0xE9);
+    }
+    else
+    {
+        emit8(0x0F); emit8(0x80 | condition);
+    }
+
+    fixups.push_back({code.size(), label});
+    emit32(0);
+}
+//##############################################################################
+void sm83_jit::emit_step(const sm83_jit_context& context, const sm83_decoded_instr& instr, std::size_t index, std::size_t exit)
+{
+    int32_t block_index = reinterpret_cast<char*>(context.block_index) - reinterpret_cast<char*>(context.regs);
+
+    // mov word [rbx+PC], address ; mov qword [rbx+block_index], index+1
+    emit8(0x66); emit8(0xC7); emit_address(0, RBX, REG_PC); emit16(instr.address);
+    emit8(0x48); emit8(0xC7); emit_address(0, RBX, block_index); emit32(index + 1);
+
+    // mov rdi, cpu ; mov esi, index ; mov rax, step ; call rax
+    emit8(0x48); emit8(0xBF); emit64(reinterpret_cast<uint64_t>(context.cpu));
+    emit8(0xBE); emit32(index);
+    emit8(0x48); emit8(0xB8); emit64(reinterpret_cast<uint64_t>(context.step));
+    emit8(0xFF); emit8(0xD0);
+
+    // test al, al ; jz exit
+    emit8(0x84); emit8(0xC0);
+    emit_jump(0x4, exit);
+}
+//##############################################################################
+void sm83_jit::emit_pair_address(uint8_t hi, uint8_t lo)
+{
+    // movzx eax, byte [rbx+hi] ; shl eax, 8 ; mov al, [rbx+lo]
+    emit8(0x0F); emit8(0xB6); emit_address(RAX, RBX, hi);
+    emit8(0xC1); emit8(0xE0); emit8(0x08);
+    emit8(0x8A); emit_address(RAX, RBX, lo);
+}
+//##############################################################################
+void sm83_jit::emit_read(std::size_t fallback)
+{
+    // mov edx, eax ; shr edx, 8 ; mov rcx, [r12+rdx*8]
+    emit8(0x89); emit8(0xC2);
+    emit8(0xC1); emit8(0xEA); emit8(0x08);
+    emit8(0x49); emit8(0x8B); emit8(0x0C); emit8(0xD4);
+
+    // test rcx, rcx ; jz fallback
+    emit8(0x48); emit8(0x85); emit8(0xC9);
+    emit_jump(0x4, fallback);
+
+    // movzx eax, al ; mov cl, [rcx+rax]
+    emit8(0x0F); emit8(0xB6); emit8(0xC0);
+    emit8(0x8A); emit8(0x0C); emit8(0x01);
+}
+//##############################################################################
+void sm83_jit::emit_write_page(std::size_t fallback)
+{
+    // mov edx, eax ; shr edx, 8
+    emit8(0x89); emit8(0xC2);
+    emit8(0xC1); emit8(0xEA); emit8(0x08);
+
+    // echo RAM shares the code page flags of WRAM, leave it to the interpreter
+    // cmp edx, 0xE0 ; jae fallback
+    emit8(0x81); emit8(0xFA); emit32(0xE0);
+    emit_jump(0x3, fallback);
+
+    // mov rcx, [r13+rdx*8] ; test rcx, rcx ; jz fallback
+    emit8(0x49); emit8(0x8B); emit8(0x4C); emit8(0xD5); emit8(0x00);
+    emit8(0x48); emit8(0x85); emit8(0xC9);
+    emit_jump(0x4, fallback);
+
+    // the interpreter drops the blocks decoded from the page
+    // cmp byte [r14+rdx], 0 ; jne fallback
+    emit8(0x41); emit8(0x80); emit8(0x3C); emit8(0x16); emit8(0x00);
+    emit_jump(0x5, fallback);
+
+    // movzx eax, al
+    emit8(0x0F); emit8(0xB6); emit8(0xC0);
+}
+//##############################################################################
+void sm83_jit::emit_flags(uint8_t mask, uint8_t set, uint8_t keep)
+{
+    // lahf ; movzx edx, ah ; mov dl, [rbp+rdx]
+    emit8(0x9F);
+    emit8(0x0F); emit8(0xB6); emit8(0xD4);
+    emit8(0x8A); emit8(0x54); emit8(0x15); emit8(0x00);
+
+    // and dl, mask ; or dl, set
+    if(mask != 0xB0) { emit8(0x80); emit8(0xE2); emit8(mask); }
+    if(set) { emit8(0x80); emit8(0xCA); emit8(set); }
+
+    if(keep)
+    {
+        // mov cl, [rbx+F] ; and cl, keep ; or dl, cl
+        emit8(0x8A); emit_address(RCX, RBX, REG_F);
+        emit8(0x80); emit8(0xE1); emit8(keep);
+        emit8(0x08); emit8(0xCA);
+    }
+
+    // mov [rbx+F], dl
+    emit8(0x88); emit_address(RDX, RBX, REG_F);
+}
+//##############################################################################
+void sm83_jit::emit_alu(uint8_t operation)
+{
+    // mov al, [rbx+A]
+    emit8(0x8A); emit_address(RAX, RBX, REG_A);
+
+    // ADC and SBC: bt dword [rbx+F], 4 puts C in the host carry
+    if(operation == 1 || operation == 3)
+    {
+        emit8(0x0F); emit8(0xBA); emit_address(4, RBX, REG_F); emit8(0x04);
+    }
+
+    // op al, cl
+    emit8(ALU_OPCODE[operation]); emit8(0xC8);
+
+    switch(operation)
+    {
+        case 0: case 1: emit_flags(0xB0, 0x00, 0x00); break; // ADD ADC
+        case 2: case 3: case 7: emit_flags(0xB0, 0x40, 0x00); break; // SUB SBC CP
+        case 4: emit_flags(0x80, 0x20, 0x00); break; // AND
+        default: emit_flags(0x80, 0x00, 0x00); break; // XOR OR
+    }
+
+    // CP only sets the flags, mov [rbx+A], al
+    if(operation != 7)
+    {
+        emit8(0x88); emit_address(RAX, RBX, REG_A);
+    }
+}
+//##############################################################################
+bool sm83_jit::emit_native(const sm83_decoded_instr& instr, std::size_t fallback)
+{
+    uint8_t opcode = instr.opcode;
+    uint8_t pair = (opcode >> 4) & 0x03;
+    uint8_t destination = (opcode >> 3) & 0x07;
+    uint8_t source = opcode & 0x07;
+
+    // LD r, r' / LD r, (HL) / LD (HL), r
+    if(0x40 <= opcode && opcode <= 0x7F && opcode != 0x76)
+    {
+        if(source == 6)
+        {
+            emit_pair_address(REG_H, REG_L);
+            emit_read(fallback);
+            emit8(0x88); emit_address(RCX, RBX, REGISTER[destination]);
+        }
+        else if(destination == 6)
+        {
+            emit_pair_address(REG_H, REG_L);
+            emit_write_page(fallback);
+            // mov dl, [rbx+r] ; mov [rcx+rax], dl
+            emit8(0x8A); emit_address(RDX, RBX, REGISTER[source]);
+            emit8(0x88); emit8(0x14); emit8(0x01);
+        }
+        else if(source != destination)
+        {
+            emit8(0x8A); emit_address(RAX, RBX, REGISTER[source]);
+            emit8(0x88); emit_address(RAX, RBX, REGISTER[destination]);
+        }
+
+        return true;
+    }
+
+    // ALU A, r / ALU A, (HL)
+    if(0x80 <= opcode && opcode <= 0xBF)
+    {
+        if(source == 6)
+        {
+            emit_pair_address(REG_H, REG_L);
+            emit_read(fallback);
+        }
+        else
+        {
+            // mov cl, [rbx+r]
+            emit8(0x8A); emit_address(RCX, RBX, REGISTER[source]);
+        }
+
+        emit_alu(destination);
+
+        return true;
+    }
+
+    switch(opcode)
+    {
+        case 0x00: // NOP
+            return true;
+
+        // ALU A, n: mov cl, n
+        case 0xC6: case 0xCE: case 0xD6: case 0xDE:
+        case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+            emit8(0xB1); emit8(instr.operands[0]);
+            emit_alu(destination);
+            return true;
+
+        // LD r, n: mov byte [rbx+r], n
+        case 0x06: case 0x0E: case 0x16: case 0x1E:
+        case 0x26: case 0x2E: case 0x3E:
+            emit8(0xC6); emit_address(0, RBX, REGISTER[destination]); emit8(instr.operands[0]);
+            return true;
+
+        // LD (HL), n: mov byte [rcx+rax], n
+        case 0x36:
+            emit_pair_address(REG_H, REG_L);
+            emit_write_page(fallback);
+            emit8(0xC6); emit8(0x04); emit8(0x01); emit8(instr.operands[0]);
+            return true;
+
+        // LD rr, nn
+        case 0x01: case 0x11: case 0x21:
+            emit8(0xC6); emit_address(0, RBX, PAIR_HI[pair]); emit8(instr.operands[1]);
+            emit8(0xC6); emit_address(0, RBX, PAIR_LO[pair]); emit8(instr.operands[0]);
+            return true;
+        case 0x31:
+            emit8(0x66); emit8(0xC7); emit_address(0, RBX, REG_SP);
+            emit16(instr.operands[0] | (instr.operands[1] << 8));
+            return true;
+
+        // INC rr: add byte [rbx+lo], 1 ; adc byte [rbx+hi], 0
+        case 0x03: case 0x13: case 0x23:
+            emit8(0x80); emit_address(0, RBX, PAIR_LO[pair]); emit8(0x01);
+            emit8(0x80); emit_address(2, RBX, PAIR_HI[pair]); emit8(0x00);
+            return true;
+        // DEC rr: sub byte [rbx+lo], 1 ; sbb byte [rbx+hi], 0
+        case 0x0B: case 0x1B: case 0x2B:
+            emit8(0x80); emit_address(5, RBX, PAIR_LO[pair]); emit8(0x01);
+            emit8(0x80); emit_address(3, RBX, PAIR_HI[pair]); emit8(0x00);
+            return true;
+        // INC SP / DEC SP: inc/dec word [rbx+SP]
+        case 0x33: case 0x3B:
+            emit8(0x66); emit8(0xFF); emit_address(opcode == 0x3B, RBX, REG_SP);
+            return true;
+
+        // INC r / DEC r: inc/dec byte [rbx+r], C is kept
+        case 0x04: case 0x0C: case 0x14: case 0x1C:
+        case 0x24: case 0x2C: case 0x3C:
+            emit8(0xFE); emit_address(0, RBX, REGISTER[destination]);
+            emit_flags(0xA0, 0x00, 0x10);
+            return true;
+        case 0x05: case 0x0D: case 0x15: case 0x1D:
+        case 0x25: case 0x2D: case 0x3D:
+            emit8(0xFE); emit_address(1, RBX, REGISTER[destination]);
+            emit_flags(0xA0, 0x40, 0x10);
+            return true;
+
+        // ADD HL, rr: as two 8-bit adds, so the host AF is the carry out of
+        // bit 11
+        case 0x09: case 0x19: case 0x29: case 0x39:
+        {
+            uint8_t lo = pair == 3 ? REG_SP : PAIR_LO[pair];
+            uint8_t hi = pair == 3 ? REG_SP + 1 : PAIR_HI[pair];
+
+            // mov al, [rbx+L] ; add al, [rbx+lo] ; mov cl, [rbx+H] ; adc cl, [rbx+hi]
+            emit8(0x8A); emit_address(RAX, RBX, REG_L);
+            emit8(0x02); emit_address(RAX, RBX, lo);
+            emit8(0x8A); emit_address(RCX, RBX, REG_H);
+            emit8(0x12); emit_address(RCX, RBX, hi);
+
+            // mov [rbx+L], al ; mov [rbx+H], cl
+            emit8(0x88); emit_address(RAX, RBX, REG_L);
+            emit8(0x88); emit_address(RCX, RBX, REG_H);
+
+            emit_flags(0x30, 0x00, 0x80);
+            return true;
+        }
+
+        // LD (BC), A / LD (DE), A / LD (HL+), A / LD (HL-), A
+        case 0x02: case 0x12: case 0x22: case 0x32:
+            emit_pair_address(PAIR_HI[opcode < 0x20 ? pair : 2], PAIR_LO[opcode < 0x20 ? pair : 2]);
+            emit_write_page(fallback);
+            emit8(0x8A); emit_address(RDX, RBX, REG_A);
+            emit8(0x88); emit8(0x14); emit8(0x01);
+            break;
+
+        // LD A, (BC) / LD A, (DE) / LD A, (HL+) / LD A, (HL-)
+        case 0x0A: case 0x1A: case 0x2A: case 0x3A:
+            emit_pair_address(PAIR_HI[opcode < 0x20 ? pair : 2], PAIR_LO[opcode < 0x20 ? pair : 2]);
+            emit_read(fallback);
+            emit8(0x88); emit_address(RCX, RBX, REG_A);
+            break;
+
+        // LD (nn), A / LD A, (nn): mov eax, nn
+        case 0xEA:
+            emit8(0xB8); emit32(instr.operands[0] | (instr.operands[1] << 8));
+            emit_write_page(fallback);
+            emit8(0x8A); emit_address(RDX, RBX, REG_A);
+            emit8(0x88); emit8(0x14); emit8(0x01);
+            return true;
+        case 0xFA:
+            emit8(0xB8); emit32(instr.operands[0] | (instr.operands[1] << 8));
+            emit_read(fallback);
+            emit8(0x88); emit_address(RCX, RBX, REG_A);
+            return true;
+
+        // RLCA RRCA RLA RRA: rol/ror/rcl/rcr byte [rbx+A], 1, then F is just C
+        case 0x07: case 0x0F: case 0x17: case 0x1F:
+            if(opcode >= 0x17)
+            {
+                emit8(0x0F); emit8(0xBA); emit_address(4, RBX, REG_F); emit8(0x04);
+            }
+
+            emit8(0xD0); emit_address(destination, RBX, REG_A);
+
+            // setc dl ; shl dl, 4 ; mov [rbx+F], dl
+            emit8(0x0F); emit8(0x92); emit8(0xC2);
+            emit8(0xC0); emit8(0xE2); emit8(0x04);
+            emit8(0x88); emit_address(RDX, RBX, REG_F);
+            return true;
+
+        // CPL: xor byte [rbx+A], 0xFF ; or byte [rbx+F], N|H
+        case 0x2F:
+            emit8(0x80); emit_address(6, RBX, REG_A); emit8(0xFF);
+            emit8(0x80); emit_address(1, RBX, REG_F); emit8(0x60);
+            return true;
+        // SCF: and byte [rbx+F], Z ; or byte [rbx+F], C
+        case 0x37:
+            emit8(0x80); emit_address(4, RBX, REG_F); emit8(0x80);
+            emit8(0x80); emit_address(1, RBX, REG_F); emit8(0x10);
+            return true;
+        // CCF: and byte [rbx+F], Z|C ; xor byte [rbx+F], C
+        case 0x3F:
+            emit8(0x80); emit_address(4, RBX, REG_F); emit8(0x90);
+            emit8(0x80); emit_address(6, RBX, REG_F); emit8(0x10);
+            return true;
+
+        default:
+            return false;
+    }
+
+    // HL+ / HL-, once the access went through
+    if(opcode == 0x22 || opcode == 0x2A)
+    {
+        // add byte [rbx+L], 1 ; adc byte [rbx+H], 0
+        emit8(0x80); emit_address(0, RBX, REG_L); emit8(0x01);
+        emit8(0x80); emit_address(2, RBX, REG_H); emit8(0x00);
+    }
+    else if(opcode == 0x32 || opcode == 0x3A)
+    {
+        // sub byte [rbx+L], 1 ; sbb byte [rbx+H], 0
+        emit8(0x80); emit_address(5, RBX, REG_L); emit8(0x01);
+        emit8(0x80); emit_address(3, RBX, REG_H); emit8(0x00);
+    }
+
+    return true;
+}
+//##############################################################################
+bool sm83_jit::emit_branch(const sm83_jit_context& context, const sm83_block& block, const sm83_decoded_instr& instr)
+{
+    int32_t cycle_count = reinterpret_cast<char*>(context.cycle_count) - reinterpret_cast<char*>(context.regs);
+    int32_t block_index = reinterpret_cast<char*>(context.block_index) - reinterpret_cast<char*>(context.regs);
+    int32_t now = offsetof(gb_scheduler, now);
+    int32_t next_deadline = offsetof(gb_scheduler, next_deadline);
+
+    uint8_t opcode = instr.opcode;
+    uint16_t next = instr.address + instr.length;
+    uint16_t target;
+
+    switch(opcode)
+    {
+        // JR e8, JR cc, e8
+        case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:
+            // JR -2 stops the emulator, the interpreter takes care of it
+            if(static_cast<int8_t>(instr.operands[0]) == -2) return false;
+
+            target = next + static_cast<int8_t>(instr.operands[0]);
+            break;
+
+        // JP nn, JP cc, nn
+        case 0xC3: case 0xC2: case 0xCA: case 0xD2: case 0xDA:
+            target = instr.operands[0] | (instr.operands[1] << 8);
+            break;
+
+        default:
+            return false;
+    }
+
+    if(opcode == 0x18 || opcode == 0xC3)
+    {
+        // mov word [rbx+PC], target ; mov ecx, cycles
+        emit8(0x66); emit8(0xC7); emit_address(0, RBX, REG_PC); emit16(target);
+        emit8(0xB9); emit32(instr.cycles);
+    }
+    else
+    {
+        // Z for NZ/Z, C for NC/C, the second of each pair jumps on the flag set
+        uint8_t flag = (opcode & 0x10) ? 0x10 : 0x80;
+        bool on_set = opcode & 0x08;
+
+        std::size_t not_taken = new_label();
+
+        // mov word [rbx+PC], next ; mov ecx, cycles ; test byte [rbx+F], flag
+        emit8(0x66); emit8(0xC7); emit_address(0, RBX, REG_PC); emit16(next);
+        emit8(0xB9); emit32(instr.cycles);
+        emit8(0xF6); emit_address(0, RBX, REG_F); emit8(flag);
+        emit_jump(on_set ? 0x4 : 0x5, not_taken);
+
+        // taken, one M-cycle more: mov word [rbx+PC], target ; inc ecx
+        emit8(0x66); emit8(0xC7); emit_address(0, RBX, REG_PC); emit16(target);
+        emit8(0xFF); emit8(0xC1);
+
+        bind(not_taken);
+    }
+
+    // mov qword [rbx+block_index], size ; add [rbx+cycle_count], rcx ;
+    // shl ecx, 2 ; add [r15+now], rcx
+    emit8(0x48); emit8(0xC7); emit_address(0, RBX, block_index); emit32(block.instructions.size());
+    emit8(0x48); emit8(0x01); emit_address(RCX, RBX, cycle_count);
+    emit8(0xC1); emit8(0xE1); emit8(0x02);
+    emit8(0x49); emit8(0x01); emit_address(RCX, R15, now);
+
+    // the block ends here, tick() takes any interrupt the events raise
+    // mov rax, [r15+now] ; cmp rax, [r15+next_deadline] ; jb done
+    std::size_t done = new_label();
+
+    emit8(0x49); emit8(0x8B); emit_address(RAX, R15, now);
+    emit8(0x49); emit8(0x3B); emit_address(RAX, R15, next_deadline);
+    emit_jump(0x2, done);
+
+    // mov rdi, cpu ; mov rax, sync ; call rax
+    emit8(0x48); emit8(0xBF); emit64(reinterpret_cast<uint64_t>(context.cpu));
+    emit8(0x48); emit8(0xB8); emit64(reinterpret_cast<uint64_t>(context.sync));
+    emit8(0xFF); emit8(0xD0);
+
+    bind(done);
+
+    return true;
+}
+//##############################################################################
+sm83_native_code sm83_jit::compile(const sm83_block& block, const sm83_jit_context& context)
+{
+    code.clear();
+    labels.clear();
+    fixups.clear();
+
+    int32_t cycle_count = reinterpret_cast<char*>(context.cycle_count) - reinterpret_cast<char*>(context.regs);
+    int32_t block_index = reinterpret_cast<char*>(context.block_index) - reinterpret_cast<char*>(context.regs);
+    int32_t now = offsetof(gb_scheduler, now);
+    int32_t next_deadline = offsetof(gb_scheduler, next_deadline);
+
+    // push rbx ; push rbp ; push r12 ; push r13 ; push r14 ; push r15 ;
+    // sub rsp, 8 (calls need a 16 byte aligned stack)
+    emit8(0x53); emit8(0x55);
+    emit8(0x41); emit8(0x54); emit8(0x41); emit8(0x55);
+    emit8(0x41); emit8(0x56); emit8(0x41); emit8(0x57);
+    emit8(0x48); emit8(0x83); emit8(0xEC); emit8(0x08);
+
+    // mov rbx, regs ; mov rbp, host_flags ; mov r12, read_pages ;
+    // mov r13, write_pages ; mov r14, code_pages ; mov r15, scheduler
+    emit8(0x48); emit8(0xBB); emit64(reinterpret_cast<uint64_t>(context.regs));
+    emit8(0x48); emit8(0xBD); emit64(reinterpret_cast<uint64_t>(host_flags.data()));
+    emit8(0x49); emit8(0xBC); emit64(reinterpret_cast<uint64_t>(context.read_pages));
+    emit8(0x49); emit8(0xBD); emit64(reinterpret_cast<uint64_t>(context.write_pages));
+    emit8(0x49); emit8(0xBE); emit64(reinterpret_cast<uint64_t>(context.code_pages));
+    emit8(0x49); emit8(0xBF); emit64(reinterpret_cast<uint64_t>(context.scheduler));
+
+    std::size_t epilogue = new_label();
+    std::vector<native_stub> stubs;
+    bool last_native = false;
+
+    for(std::size_t i = 0; i < block.instructions.size(); ++i)
+    {
+        const sm83_decoded_instr& instr = block.instructions[i];
+
+        // always the last instruction, it sets PC itself
+        if(emit_branch(context, block, instr))
+        {
+            native_instructions++;
+            last_native = false;
+            break;
+        }
+
+        std::size_t fallback = new_label();
+
+        last_native = emit_native(instr, fallback);
+
+        if(!last_native)
+        {
+            emit_step(context, instr, i, epilogue);
+            interpreted_instructions++;
+            continue;
+        }
+
+        native_instructions++;
+
+        // add qword [rbx+cycle_count], cycles ; add qword [r15+now], 4*cycles
+        emit8(0x48); emit8(0x83); emit_address(0, RBX, cycle_count); emit8(instr.cycles);
+        emit8(0x49); emit8(0x83); emit_address(0, R15, now); emit8(4 * instr.cycles);
+
+        // mov rax, [r15+now] ; cmp rax, [r15+next_deadline] ; jae events
+        emit8(0x49); emit8(0x8B); emit_address(RAX, R15, now);
+        emit8(0x49); emit8(0x3B); emit_address(RAX, R15, next_deadline);
+
+        native_stub stub = {i, fallback, new_label(), new_label()};
+        emit_jump(0x3, stub.events);
+        bind(stub.after);
+
+        stubs.push_back(stub);
+    }
+
+    if(last_native)
+    {
+        // ran off the end of the block, tick() goes on from the next one
+        const sm83_decoded_instr& instr = block.instructions.back();
+
+        emit8(0x66); emit8(0xC7); emit_address(0, RBX, REG_PC); emit16(instr.address + instr.length);
+        emit8(0x48); emit8(0xC7); emit_address(0, RBX, block_index); emit32(block.instructions.size());
+    }
+
+    // add rsp, 8 ; pop r15 ; pop r14 ; pop r13 ; pop r12 ; pop rbp ; pop rbx ; ret
+    bind(epilogue);
+    emit8(0x48); emit8(0x83); emit8(0xC4); emit8(0x08);
+    emit8(0x41); emit8(0x5F); emit8(0x41); emit8(0x5E);
+    emit8(0x41); emit8(0x5D); emit8(0x41); emit8(0x5C);
+    emit8(0x5D); emit8(0x5B);
+    emit8(0xC3);
+
+    // off the straight-line path: the instruction on the interpreter when its
+    // access isn't plain memory, and the scheduler events
+    for(const native_stub& stub : stubs)
+    {
+        const sm83_decoded_instr& instr = block.instructions[stub.index];
+
+        bind(stub.fallback);
+        emit_step(context, instr, stub.index, epilogue);
+        emit_jump(0xFF, stub.after);
+
+        // mov rdi, cpu ; mov rax, sync ; call rax ; test al, al ; jnz after
+        bind(stub.events);
+        emit8(0x48); emit8(0xBF); emit64(reinterpret_cast<uint64_t>(context.cpu));
+        emit8(0x48); emit8(0xB8); emit64(reinterpret_cast<uint64_t>(context.sync));
+        emit8(0xFF); emit8(0xD0);
+        emit8(0x84); emit8(0xC0);
+        emit_jump(0x5, stub.after);
+
+        // an interrupt is due, tick() takes it before the next instruction
+        emit8(0x66); emit8(0xC7); emit_address(0, RBX, REG_PC); emit16(instr.address + instr.length);
+        emit8(0x48); emit8(0xC7); emit_address(0, RBX, block_index); emit32(stub.index + 1);
+        emit_jump(0xFF, epilogue);
+    }
+
+    for(const fixup& jump : fixups)
+    {
+        uint32_t relative = labels[jump.label] - (jump.position + 4);
+
+        std::memcpy(&code[jump.position], &relative, sizeof(relative));
+    }
+
+    // blocks start 16 byte aligned
+    std::size_t size = (code.size() + 15) & ~std::size_t(15);
+    std::size_t offset = allocate(size);
+
+    if(offset == SIZE_MAX) return nullptr;
+
+    // the version compiled from the bytes that were there before
+    auto old = compiled.find(block.key);
+
+    if(old != compiled.end())
+    {
+        release(old->second.offset, old->second.size);
+    }
+
+    compiled[block.key] = {guest_bytes(block), offset, size};
+
+    std::memcpy(arena + offset, code.data(), code.size());
+
+    compiled_blocks++;
+
+    uint8_t* start = arena_code + offset;
+
+    __builtin___clear_cache(reinterpret_cast<char*>(start), reinterpret_cast<char*>(start + code.size()));
+
+    return reinterpret_cast<sm83_native_code>(start);
+}
+//##############################################################################
+sm83_native_code sm83_jit::find(const sm83_block& block)
+{
+    auto it = compiled.find(block.key);
+
+    if(it == compiled.end() || it->second.bytes != guest_bytes(block)) return nullptr;
+
+    reused_blocks++;
+
+    return reinterpret_cast<sm83_native_code>(arena_code + it->second.offset);
+}
+//##############################################################################
+void sm83_jit::reset()
+{
+    arena_used = 0;
+    free_ranges.clear();
+    compiled.clear();
+
+    resets++;
+}
+//##############################################################################
+void sm83_jit::print_stats()
+{
+    std::cout<<"JIT: "<<std::dec<<compiled_blocks<<" blocks compiled, "
+        <<reused_blocks<<" reused, "
+        <<native_instructions<<" native and "
+        <<interpreted_instructions<<" interpreted instructions, "
+        <<arena_used<<" bytes in use, "
+        <<reclaimed_bytes<<" reclaimed, "
+        <<resets<<" resets"<<'\n';
+}
@@ -0,0 +1,189 @@
+#ifndef _SM83_JIT_
+#define _SM83_JIT_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+#include "sm83_block_cache.hpp"
+
+struct sm83_registers;
+class gb_scheduler;
+
+// x86-64 code generator for hot pre-decoded blocks.
+//
+// Register moves, 8-bit ALU operations, 16-bit increments, ADD HL and loads
+// and stores through the bus page table become native code working on the
+// register file, with F computed from the host flags. Every instruction
+// counts its cycles and moves the scheduler clock itself; when a deadline
+// falls due the events run, and the block ends if an interrupt is taken.
+//
+// JP and JR leave the block natively. The rest (calls, returns, stack, CB,
+// I/O...) and any access that doesn't hit plain memory (I/O, OAM, VRAM
+// writes, MBC registers, pages holding decoded code) runs that one
+// instruction on the interpreter through a step function, so bus accesses to
+// the hardware keep their exact M-cycle.
+//
+// The native code doesn't depend on where the decoded block lives, so it is
+// kept by block cache key and handed back when the same bytes are decoded
+// again. It lives in an arena mapped twice, once writable and once
+// executable, so no page is ever both and compiling doesn't flip protections.
+
+// where the native code of one core finds its state, none of it moves until
+// the core is reset
+struct sm83_jit_context
+{
+    // runs instruction index of the running block on the interpreter, false
+    // ends the native block
+    using step_function = bool (*)(sharpsm83* cpu, std::size_t index);
+    // runs the scheduler events that fell due, false ends the native block
+    using sync_function = bool (*)(sharpsm83* cpu);
+
+    sharpsm83* cpu;
+    sm83_registers* regs;
+    unsigned long int* cycle_count;
+    // index of the next instruction in the running block
+    std::size_t* block_index;
+
+    // the bus page table, and sm83_block_cache::get_code_pages
+    const uint8_t* const* read_pages;
+    uint8_t* const* write_pages;
+    const bool* code_pages;
+
+    gb_scheduler* scheduler;
+
+    step_function step;
+    sync_function sync;
+};
+
+class sm83_jit
+{
+public:
+    static const std::size_t ARENA_SIZE = 4 * 1024 * 1024;
+private:
+    // two views of the same memory
+    uint8_t* arena = nullptr;
+    uint8_t* arena_code = nullptr;
+    std::size_t arena_used = 0;
+
+    // ranges below arena_used given back by reclaim(), by offset
+    std::map<std::size_t, std::size_t> free_ranges;
+
+    // the code of one block and the guest bytes it was compiled from
+    struct compiled_block
+    {
+        std::vector<uint8_t> bytes;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    // by block cache key, one version each
+    std::unordered_map<uint32_t, compiled_block> compiled;
+
+    unsigned long int compiled_blocks = 0;
+    unsigned long int reused_blocks = 0;
+    unsigned long int reclaimed_bytes = 0;
+    unsigned long int native_instructions = 0;
+    unsigned long int interpreted_instructions = 0;
+    unsigned long int resets = 0;
+
+    // code of the block being compiled, copied to the arena once complete
+    std::vector<uint8_t> code;
+
+    // positions of the labels and the rel32 fields jumping to them
+    struct fixup
+    {
+        std::size_t position;
+        std::size_t label;
+    };
+
+    std::vector<std::size_t> labels;
+    std::vector<fixup> fixups;
+
+    // offset of size bytes of arena, SIZE_MAX if there is no room
+    std::size_t allocate(std::size_t size);
+    void release(std::size_t offset, std::size_t size);
+
+    static std::vector<uint8_t> guest_bytes(const sm83_block& block);
+
+    void emit8(uint8_t value);
+    void emit16(uint16_t value);
+    void emit32(uint32_t value);
+    void emit64(uint64_t value);
+
+    // ModRM and displacement of [base + displacement], base not rsp/r12
+    void emit_address(uint8_t reg, uint8_t base, int32_t displacement);
+
+    std::size_t new_label();
+    void bind(std::size_t label);
+    // jcc rel32 (condition is the low nibble of 0F 8x), or jmp with 0xFF
+    void emit_jump(uint8_t condition, std::size_t label);
+
+    // runs instr, instruction index of the block, on the interpreter
+    void emit_step(const sm83_jit_context& context, const sm83_decoded_instr& instr, std::size_t index, std::size_t exit);
+
+    // the operand address in eax, then the page of a read (byte in cl) or of
+    // a write (rcx), jumping to fallback if it isn't plain memory
+    void emit_pair_address(uint8_t hi, uint8_t lo);
+    void emit_read(std::size_t fallback);
+    void emit_write_page(std::size_t fallback);
+
+    // op al, cl and the flags it leaves in F
+    void emit_alu(uint8_t operation);
+    // F from the host flags of the last operation: its Z H C masked by mask,
+    // set ORed in and the bits in keep taken from the old F
+    void emit_flags(uint8_t mask, uint8_t set, uint8_t keep);
+
+    // false if the opcode has no native form, nothing emitted then
+    bool emit_native(const sm83_decoded_instr& instr, std::size_t fallback);
+
+    // JP and JR ending the block, with their cycles and the scheduler events
+    // due; false (nothing emitted) for any other instruction
+    bool emit_branch(const sm83_jit_context& context, const sm83_block& block, const sm83_decoded_instr& instr);
+public:
+    sm83_jit();
+    ~sm83_jit();
+
+    sm83_jit(const sm83_jit&) = delete;
+    sm83_jit& operator=(const sm83_jit&) = delete;
+
+    // code compiled before from the same bytes under the key of block,
+    // nullptr if there is none
+    sm83_native_code find(const sm83_block& block);
+
+    // nullptr when the arena is full: reclaim() and try again, or reset() it
+    // together with the block cache
+    sm83_native_code compile(const sm83_block& block, const sm83_jit_context& context);
+
+    // frees the code in_use(key, code) says no live block runs anymore
+    template<typename in_use_function>
+    void reclaim(in_use_function in_use);
+
+    void reset();
+
+    void print_stats();
+};
+//##############################################################################
+template<typename in_use_function>
+void sm83_jit::reclaim(in_use_function in_use)
+{
+    for(auto it = compiled.begin(); it != compiled.end();)
+    {
+        const compiled_block& entry = it->second;
+
+        if(in_use(it->first, reinterpret_cast<sm83_native_code>(arena_code + entry.offset)))
+        {
+            ++it;
+            continue;
+        }
+
+        reclaimed_bytes += entry.size;
+        release(entry.offset, entry.size);
+
+        it = compiled.erase(it);
+    }
+}
+
+#endif
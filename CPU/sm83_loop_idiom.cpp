@@ -0,0 +1,141 @@
+#include "sm83_loop_idiom.hpp"
+#include "sm83_block_cache.hpp"
+
+//##############################################################################
+sm83_loop_idiom sm83_loop_idiom::match(const sm83_block& block)
+{
+    using counter_register = sm83_loop_idiom::counter_register;
+    using loop_kind = sm83_loop_idiom::loop_kind;
+
+    const std::vector<sm83_decoded_instr>& instructions = block.instructions;
+    std::size_t size = instructions.size();
+
+    sm83_loop_idiom idiom;
+
+    if(size < 2 || size > 9) return idiom;
+
+    // JR NZ or JP NZ back to the start of the block
+    const sm83_decoded_instr& branch = instructions.back();
+    uint16_t target;
+
+    switch(branch.opcode)
+    {
+        case 0x20: target = branch.address + 2 + static_cast<int8_t>(branch.operands[0]); break;
+        case 0xC2: target = branch.operands[0] | (branch.operands[1] << 8); break;
+        default: return idiom;
+    }
+
+    if(target != instructions.front().address) return idiom;
+
+    // the counter: DEC r, or DEC rr ; LD A,hi ; OR lo (either order)
+    std::size_t body_size;
+
+    switch(instructions[size - 2].opcode)
+    {
+        case 0x05: idiom.counter = counter_register::B; body_size = size - 2; break;
+        case 0x0D: idiom.counter = counter_register::C; body_size = size - 2; break;
+        case 0x15: idiom.counter = counter_register::D; body_size = size - 2; break;
+        case 0x1D: idiom.counter = counter_register::E; body_size = size - 2; break;
+        default:
+        {
+            if(size < 4) return idiom;
+
+            uint8_t dec = instructions[size - 4].opcode;
+            uint8_t load = instructions[size - 3].opcode;
+            uint8_t test = instructions[size - 2].opcode;
+
+            if(dec == 0x0B && ((load == 0x78 && test == 0xB1) || (load == 0x79 && test == 0xB0)))
+            {
+                idiom.counter = counter_register::BC;
+            }
+            else if(dec == 0x1B && ((load == 0x7A && test == 0xB3) || (load == 0x7B && test == 0xB2)))
+            {
+                idiom.counter = counter_register::DE;
+            }
+            else
+            {
+                return idiom;
+            }
+
+            body_size = size - 4;
+            break;
+        }
+    }
+
+    bool counts_bc = idiom.counter == counter_register::B || idiom.counter == counter_register::C ||
+        idiom.counter == counter_register::BC;
+    bool wide = idiom.counter == counter_register::BC || idiom.counter == counter_register::DE;
+
+    // an optional load of A ahead of a fill
+    std::size_t first = 0;
+    bool sets_a = false;
+
+    if(body_size > 0)
+    {
+        switch(instructions[0].opcode)
+        {
+            case 0xAF: // XOR A
+            case 0x3E: // LD A,d8
+                sets_a = true;
+                break;
+            case 0x78: case 0x79: // LD A,B / LD A,C
+                if(counts_bc) return idiom;
+                sets_a = true;
+                break;
+            case 0x7A: case 0x7B: // LD A,D / LD A,E
+                if(!counts_bc) return idiom;
+                sets_a = true;
+                break;
+        }
+
+        if(sets_a)
+        {
+            first = 1;
+
+            idiom.fill_opcode = instructions[0].opcode;
+            idiom.fill_constant = instructions[0].operands[0];
+        }
+    }
+
+    std::vector<uint8_t> body;
+    for(std::size_t i = first; i < body_size; ++i) body.push_back(instructions[i].opcode);
+
+    if(body.empty())
+    {
+        if(sets_a) return idiom;
+
+        idiom.kind = loop_kind::DELAY;
+    }
+    else if(body == std::vector<uint8_t>{0x22} || body == std::vector<uint8_t>{0x77, 0x23})
+    {
+        idiom.kind = loop_kind::FILL;   // LD (HL+),A
+        idiom.hl_step = 1;
+    }
+    else if(body == std::vector<uint8_t>{0x32} || body == std::vector<uint8_t>{0x77, 0x2B})
+    {
+        idiom.kind = loop_kind::FILL;   // LD (HL-),A
+        idiom.hl_step = -1;
+    }
+    else if(body == std::vector<uint8_t>{0x1A, 0x22, 0x13} && !sets_a && counts_bc)
+    {
+        idiom.kind = loop_kind::COPY;   // LD A,(DE) ; LD (HL+),A ; INC DE
+        idiom.hl_step = 1;
+        idiom.de_step = 1;
+    }
+    else if(body == std::vector<uint8_t>{0x2A, 0x12, 0x13} && !sets_a && counts_bc)
+    {
+        idiom.kind = loop_kind::COPY;   // LD A,(HL+) ; LD (DE),A ; INC DE
+        idiom.hl_step = 1;
+        idiom.de_step = 1;
+        idiom.copy_to_de = true;
+    }
+
+    // with a 16-bit counter A holds hi | lo at the top of the loop, a fill
+    // has to load its value first
+    if(idiom.kind == loop_kind::FILL && wide && !sets_a)
+    {
+        idiom.kind = loop_kind::NONE;
+    }
+
+    return idiom;
+}
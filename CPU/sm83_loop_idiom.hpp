@@ -0,0 +1,56 @@
+#ifndef _SM83_LOOP_IDIOM_
+#define _SM83_LOOP_IDIOM_
+
+#include <cstdint>
+#include <vector>
+
+struct sm83_decoded_instr;
+struct sm83_block;
+
+// A memset, memcpy or delay loop recognized from its decoded block, e.g.
+//     LD (HL+),A ; DEC BC ; LD A,B ; OR C ; JR NZ,-6
+// All of its iterations but the last can run as one host operation: the
+// counter and pointers move by the number of iterations and A and F are
+// rewritten by the last iteration, which is still interpreted.
+struct sm83_loop_idiom
+{
+    enum class loop_kind : uint8_t
+    {
+        NONE,
+        DELAY,  // only counts down
+        FILL,   // (HL) <- A
+        COPY    // (HL) <- (DE), or (DE) <- (HL) when copy_to_de
+    };
+
+    enum class counter_register : uint8_t
+    {
+        B, C, D, E,  // DEC r ; JR NZ
+        BC, DE       // DEC rr ; LD A,hi ; OR lo ; JR NZ
+    };
+
+    loop_kind kind = loop_kind::NONE;
+    counter_register counter = counter_register::B;
+
+    // pointer steps per iteration
+    int8_t hl_step = 0;
+    int8_t de_step = 0;
+
+    bool copy_to_de = false;
+
+    // what a fill stores: the XOR A, LD A,d8 or LD A,r ahead of the store
+    // (0x00 when A is stored as it is) and the d8
+    uint8_t fill_opcode = 0x00;
+    uint8_t fill_constant = 0x00;
+
+    static sm83_loop_idiom match(const sm83_block& block);
+};
+
+// How often each idiom ran in bulk
+struct sm83_loop_idiom_stats
+{
+    unsigned long int runs = 0;
+    unsigned long int iterations = 0;
+    unsigned long int bytes = 0;
+};
+
+#endif
@@ -0,0 +1,294 @@
+#ifndef _SM83_OPCODE_LIST_
+#define _SM83_OPCODE_LIST_
+
+// X-macro lists of the SM83 opcode handlers, in opcode order.
+// X(opcode, handler) is expanded once per entry, which lets the dispatch
+// table and the switch dispatcher be generated from the same list.
+
+#define SM83_OPCODES(X) \
+    X(0x00, nop) \
+    X(0x01, ld_bc_imm16) \
+    X(0x02, ld_membc_a) \
+    X(0x03, inc_bc) \
+    X(0x04, inc_b) \
+    X(0x05, dec_b) \
+    X(0x06, ld_b_imm8) \
+    X(0x07, rlca) \
+    X(0x08, ld_memimm16_sp) \
+    X(0x09, add_hl_bc) \
+    X(0x0A, ld_a_membc) \
+    X(0x0B, dec_bc) \
+    X(0x0C, inc_c) \
+    X(0x0D, dec_c) \
+    X(0x0E, ld_c_imm8) \
+    X(0x0F, rrca) \
+    X(0x10, stop_imm8) \
+    X(0x11, ld_de_imm16) \
+    X(0x12, ld_memde_a) \
+    X(0x13, inc_de) \
+    X(0x14, inc_d) \
+    X(0x15, dec_d) \
+    X(0x16, ld_d_imm8) \
+    X(0x17, rla) \
+    X(0x18, jr_e8) \
+    X(0x19, add_hl_de) \
+    X(0x1A, ld_a_memde) \
+    X(0x1B, dec_de) \
+    X(0x1C, inc_e) \
+    X(0x1D, dec_e) \
+    X(0x1E, ld_e_imm8) \
+    X(0x1F, rra) \
+    X(0x20, jr_nz_e8) \
+    X(0x21, ld_hl_imm16) \
+    X(0x22, ld_memhlinc_a) \
+    X(0x23, inc_hl) \
+    X(0x24, inc_h) \
+    X(0x25, dec_h) \
+    X(0x26, ld_h_imm8) \
+    X(0x27, daa) \
+    X(0x28, jr_z_e8) \
+    X(0x29, add_hl_hl) \
+    X(0x2A, ld_a_memhlinc) \
+    X(0x2B, dec_hl) \
+    X(0x2C, inc_l) \
+    X(0x2D, dec_l) \
+    X(0x2E, ld_l_imm8) \
+    X(0x2F, cpl) \
+    X(0x30, jr_nc_e8) \
+    X(0x31, ld_sp_imm16) \
+    X(0x32, ld_memhldec_a) \
+    X(0x33, inc_sp) \
+    X(0x34, inc_memhl) \
+    X(0x35, dec_memhl) \
+    X(0x36, ld_memhl_imm8) \
+    X(0x37, scf) \
+    X(0x38, jr_c_e8) \
+    X(0x39, add_hl_sp) \
+    X(0x3A, ld_a_memhldec) \
+    X(0x3B, dec_sp) \
+    X(0x3C, inc_a) \
+    X(0x3D, dec_a) \
+    X(0x3E, ld_a_imm8) \
+    X(0x3F, ccf) \
+    X(0x40, ld_b_b) \
+    X(0x41, ld_b_c) \
+    X(0x42, ld_b_d) \
+    X(0x43, ld_b_e) \
+    X(0x44, ld_b_h) \
+    X(0x45, ld_b_l) \
+    X(0x46, ld_b_memhl) \
+    X(0x47, ld_b_a) \
+    X(0x48, ld_c_b) \
+    X(0x49, ld_c_c) \
+    X(0x4A, ld_c_d) \
+    X(0x4B, ld_c_e) \
+    X(0x4C, ld_c_h) \
+    X(0x4D, ld_c_l) \
+    X(0x4E, ld_c_memhl) \
+    X(0x4F, ld_c_a) \
+    X(0x50, ld_d_b) \
+    X(0x51, ld_d_c) \
+    X(0x52, ld_d_d) \
+    X(0x53, ld_d_e) \
+    X(0x54, ld_d_h) \
+    X(0x55, ld_d_l) \
+    X(0x56, ld_d_memhl) \
+    X(0x57, ld_d_a) \
+    X(0x58, ld_e_b) \
+    X(0x59, ld_e_c) \
+    X(0x5A, ld_e_d) \
+    X(0x5B, ld_e_e) \
+    X(0x5C, ld_e_h) \
+    X(0x5D, ld_e_l) \
+    X(0x5E, ld_e_memhl) \
+    X(0x5F, ld_e_a) \
+    X(0x60, ld_h_b) \
+    X(0x61, ld_h_c) \
+    X(0x62, ld_h_d) \
+    X(0x63, ld_h_e) \
+    X(0x64, ld_h_h) \
+    X(0x65, ld_h_l) \
+    X(0x66, ld_h_memhl) \
+    X(0x67, ld_h_a) \
+    X(0x68, ld_l_b) \
+    X(0x69, ld_l_c) \
+    X(0x6A, ld_l_d) \
+    X(0x6B, ld_l_e) \
+    X(0x6C, ld_l_h) \
+    X(0x6D, ld_l_l) \
+    X(0x6E, ld_l_memhl) \
+    X(0x6F, ld_l_a) \
+    X(0x70, ld_memhl_b) \
+    X(0x71, ld_memhl_c) \
+    X(0x72, ld_memhl_d) \
+    X(0x73, ld_memhl_e) \
+    X(0x74, ld_memhl_h) \
+    X(0x75, ld_memhl_l) \
+    X(0x76, halt) \
+    X(0x77, ld_memhl_a) \
+    X(0x78, ld_a_b) \
+    X(0x79, ld_a_c) \
+    X(0x7A, ld_a_d) \
+    X(0x7B, ld_a_e) \
+    X(0x7C, ld_a_h) \
+    X(0x7D, ld_a_l) \
+    X(0x7E, ld_a_memhl) \
+    X(0x7F, ld_a_a) \
+    X(0x80, add_a_b) \
+    X(0x81, add_a_c) \
+    X(0x82, add_a_d) \
+    X(0x83, add_a_e) \
+    X(0x84, add_a_h) \
+    X(0x85, add_a_l) \
+    X(0x86, add_a_memhl) \
+    X(0x87, add_a_a) \
+    X(0x88, adc_a_b) \
+    X(0x89, adc_a_c) \
+    X(0x8A, adc_a_d) \
+    X(0x8B, adc_a_e) \
+    X(0x8C, adc_a_h) \
+    X(0x8D, adc_a_l) \
+    X(0x8E, adc_a_memhl) \
+    X(0x8F, adc_a_a) \
+    X(0x90, sub_a_b) \
+    X(0x91, sub_a_c) \
+    X(0x92, sub_a_d) \
+    X(0x93, sub_a_e) \
+    X(0x94, sub_a_h) \
+    X(0x95, sub_a_l) \
+    X(0x96, sub_a_memhl) \
+    X(0x97, sub_a_a) \
+    X(0x98, sbc_a_b) \
+    X(0x99, sbc_a_c) \
+    X(0x9A, sbc_a_d) \
+    X(0x9B, sbc_a_e) \
+    X(0x9C, sbc_a_h) \
+    X(0x9D, sbc_a_l) \
+    X(0x9E, sbc_a_memhl) \
+    X(0x9F, sbc_a_a) \
+    X(0xA0, and_a_b) \
+    X(0xA1, and_a_c) \
+    X(0xA2, and_a_d) \
+    X(0xA3, and_a_e) \
+    X(0xA4, and_a_h) \
+    X(0xA5, and_a_l) \
+    X(0xA6, and_a_memhl) \
+    X(0xA7, and_a_a) \
+    X(0xA8, xor_a_b) \
+    X(0xA9, xor_a_c) \
+    X(0xAA, xor_a_d) \
+    X(0xAB, xor_a_e) \
+    X(0xAC, xor_a_h) \
+    X(0xAD, xor_a_l) \
+    X(0xAE, xor_a_memhl) \
+    X(0xAF, xor_a_a) \
+    X(0xB0, or_a_b) \
+    X(0xB1, or_a_c) \
+    X(0xB2, or_a_d) \
+    X(0xB3, or_a_e) \
+    X(0xB4, or_a_h) \
+    X(0xB5, or_a_l) \
+    X(0xB6, or_a_memhl) \
+    X(0xB7, or_a_a) \
+    X(0xB8, cp_a_b) \
+    X(0xB9, cp_a_c) \
+    X(0xBA, cp_a_d) \
+    X(0xBB, cp_a_e) \
+    X(0xBC, cp_a_h) \
+    X(0xBD, cp_a_l) \
+    X(0xBE, cp_a_memhl) \
+    X(0xBF, cp_a_a) \
+    X(0xC0, ret_nz) \
+    X(0xC1, pop_bc) \
+    X(0xC2, jp_nz_imm16) \
+    X(0xC3, jp_imm16) \
+    X(0xC4, call_nz_imm16) \
+    X(0xC5, push_bc) \
+    X(0xC6, add_a_imm8) \
+    X(0xC7, rst_0x00) \
+    X(0xC8, ret_z) \
+    X(0xC9, ret) \
+    X(0xCA, jp_z_imm16) \
+    X(0xCB, prefix) \
+    X(0xCC, call_z_imm16) \
+    X(0xCD, call_imm16) \
+    X(0xCE, adc_a_imm8) \
+    X(0xCF, rst_0x08) \
+    X(0xD0, ret_nc) \
+    X(0xD1, pop_de) \
+    X(0xD2, jp_nc_imm16) \
+    X(0xD3, op_0xD3) \
+    X(0xD4, call_nc_imm16) \
+    X(0xD5, push_de) \
+    X(0xD6, sub_a_imm8) \
+    X(0xD7, rst_0x10) \
+    X(0xD8, ret_c) \
+    X(0xD9, reti) \
+    X(0xDA, jp_c_imm16) \
+    X(0xDB, op_0xDB) \
+    X(0xDC, call_c_a16) \
+    X(0xDD, op_0xDD) \
+    X(0xDE, sbc_a_imm8) \
+    X(0xDF, rst_0x18) \
+    X(0xE0, ldh_memimm8_a) \
+    X(0xE1, pop_hl) \
+    X(0xE2, ldh_memc_a) \
+    X(0xE3, op_0xE3) \
+    X(0xE4, op_0xE4) \
+    X(0xE5, push_hl) \
+    X(0xE6, and_a_imm8) \
+    X(0xE7, rst_0x20) \
+    X(0xE8, add_sp_e8) \
+    X(0xE9, jp_hl) \
+    X(0xEA, ld_memimm16_a) \
+    X(0xEB, op_0xEB) \
+    X(0xEC, op_0xEC) \
+    X(0xED, op_0xED) \
+    X(0xEE, xor_a_imm8) \
+    X(0xEF, rst_0x28) \
+    X(0xF0, ldh_a_memimm8) \
+    X(0xF1, pop_af) \
+    X(0xF2, ldh_a_memc) \
+    X(0xF3, di) \
+    X(0xF4, op_0xF4) \
+    X(0xF5, push_af) \
+    X(0xF6, or_a_imm8) \
+    X(0xF7, rst_0x30) \
+    X(0xF8, ld_hl_sp_e8) \
+    X(0xF9, ld_sp_hl) \
+    X(0xFA, ld_a_memimm16) \
+    X(0xFB, ei) \
+    X(0xFC, op_0xFC) \
+    X(0xFD, op_0xFD) \
+    X(0xFE, cp_a_imm8) \
+    X(0xFF, rst_0x38)
+
+// The 0xCB page is regular, every entry is an instance of
+// sharpsm83::cb_instruction<opcode>.
+#define SM83_CB_OPCODES_8(X, base) \
+    X(base + 0x0, cb_instruction<base + 0x0>) \
+    X(base + 0x1, cb_instruction<base + 0x1>) \
+    X(base + 0x2, cb_instruction<base + 0x2>) \
+    X(base + 0x3, cb_instruction<base + 0x3>) \
+    X(base + 0x4, cb_instruction<base + 0x4>) \
+    X(base + 0x5, cb_instruction<base + 0x5>) \
+    X(base + 0x6, cb_instruction<base + 0x6>) \
+    X(base + 0x7, cb_instruction<base + 0x7>)
+
+#define SM83_CB_OPCODES_64(X, base) \
+    SM83_CB_OPCODES_8(X, base + 0x00) \
+    SM83_CB_OPCODES_8(X, base + 0x08) \
+    SM83_CB_OPCODES_8(X, base + 0x10) \
+    SM83_CB_OPCODES_8(X, base + 0x18) \
+    SM83_CB_OPCODES_8(X, base + 0x20) \
+    SM83_CB_OPCODES_8(X, base + 0x28) \
+    SM83_CB_OPCODES_8(X, base + 0x30) \
+    SM83_CB_OPCODES_8(X, base + 0x38)
+
+#define SM83_CB_OPCODES(X) \
+    SM83_CB_OPCODES_64(X, 0x00) \
+    SM83_CB_OPCODES_64(X, 0x40) \
+    SM83_CB_OPCODES_64(X, 0x80) \
+    SM83_CB_OPCODES_64(X, 0xC0)
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef _SM83_TIMING_
+#define _SM83_TIMING_
+
+// When the CPU hands the machine cycles it spends to the bus, and through the
+// scheduler to the PPU and the timer. The timing_policy of basic_sharpsm83,
+// both are built: sharpsm83 is exact, fast_sharpsm83 is fast.
+
+// After every memory access and internal delay, an I/O register read in the
+// middle of an instruction sees the exact M-cycle it happens in
+struct sm83_exact_timing
+{
+    static constexpr bool sync_every_cycle = true;
+};
+
+// Once per instruction, the rest of the machine catches up at its end. Frames
+// come out the same as long as nothing races the PPU within an instruction,
+// but cycle timing tests fail.
+struct sm83_fast_timing
+{
+    static constexpr bool sync_every_cycle = false;
+};
+
+#endif
@@ -1,6 +1,6 @@
 #include "gb_emulator.hpp"
 
-gb_emulator::gb_emulator() 
+gb_emulator::gb_emulator(const std::string& rom, const std::string& aot_module) : rom_path(rom), aot_module_path(aot_module)
 {
     sAppName = "OG Gameboy Emulator";
 }
@@ -18,7 +18,7 @@ void gb_emulator::cpu_task()
 bool gb_emulator::OnUserCreate() 
 {
     // Called once at the start, so create things here
-    gb.load_cartridge("../ROMs/Tetris.gb");
+    gb.load_cartridge(rom_path);
     //gb.load_cartridge("../ROMs/Pokemon-Red.gb");
 
     //gb.load_cartridge("../ROMs/test/cpu_instrs/individual/01-special.gb");
@@ -50,6 +50,14 @@ bool gb_emulator::OnUserCreate()
     //gb.load_cartridge("../ROMs/test/halt_bug.gb");
     //gb.load_cartridge("../ROMs/hello-world.gb");
 
+#ifdef CPU_AOT
+    // a module that doesn't match the ROM is refused, the ROM still runs
+    if(!aot_module_path.empty())
+    {
+        gb.get_cpu()->load_aot_module(aot_module_path);
+    }
+#endif
+
     gb.get_cpu()->reset();
     
     return true;
@@ -109,6 +117,10 @@ bool gb_emulator::OnUserUpdate(float fElapsedTime)
     {
         gb.get_video()->dump_vram("../vram.bin");
     }
+    if(GetKey(olc::Key::T).bReleased)
+    {
+        gb.get_video()->dump_tiles("../tiles.pgm");
+    }
     if(GetKey(olc::Key::R).bReleased)
     {
         OnUserCreate();
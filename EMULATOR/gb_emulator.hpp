@@ -13,8 +13,12 @@ private:
     void cpu_task();
 
     gameboy gb;
+
+    std::string rom_path;
+    // sm83_aot module built for the ROM, empty to run it interpreted
+    std::string aot_module_path;
 public:
-	gb_emulator();
+	gb_emulator(const std::string& rom, const std::string& aot_module = "");
     ~gb_emulator();
 
 	bool OnUserCreate() override;
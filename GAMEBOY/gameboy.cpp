@@ -1,14 +1,17 @@
 #include "gameboy.hpp"
 #include <iostream>
 
-gameboy::gameboy()
+template<typename cpu_type>
+basic_gameboy<cpu_type>::basic_gameboy()
 {
     bus = std::make_shared<gb_bus>();
-    cpu = std::make_shared<sharpsm83>();
+    scheduler = std::make_shared<gb_scheduler>();
+    bus->set_scheduler(scheduler);
+
+    cpu = std::make_shared<cpu_type>();
     video = std::make_shared<gb_ppu>();
 
     cpu->set_bus(bus);
-    bus->set_cpu(cpu);
 
     timer = std::make_shared<gb_timer>();
 
@@ -19,43 +22,57 @@ gameboy::gameboy()
     video->set_bus(bus);   
 }
 
-void gameboy::load_cartridge(const std::string& path)
+template<typename cpu_type>
+void basic_gameboy<cpu_type>::load_cartridge(const std::string& path)
 {
     cartridge = load_and_construct_cartridge(path);
     bus->set_cartridge(cartridge);
 }
 
-const std::shared_ptr<gb_cartridge>& gameboy::get_cartridge()
+template<typename cpu_type>
+const std::shared_ptr<gb_cartridge>& basic_gameboy<cpu_type>::get_cartridge()
 {
     return cartridge;
 }
 
-std::shared_ptr<gb_ppu>& gameboy::get_video()\
+template<typename cpu_type>
+std::shared_ptr<gb_ppu>& basic_gameboy<cpu_type>::get_video()\
 {
     return video;
 }
 
-const std::shared_ptr<sharpsm83>& gameboy::get_cpu() const
+template<typename cpu_type>
+const std::shared_ptr<cpu_type>& basic_gameboy<cpu_type>::get_cpu() const
 {
     return cpu;
 }
 
-std::shared_ptr<sharpsm83>& gameboy::get_cpu()
+template<typename cpu_type>
+std::shared_ptr<cpu_type>& basic_gameboy<cpu_type>::get_cpu()
 {
     return cpu;
 }
 
-std::shared_ptr<gb_bus>& gameboy::get_bus()
+template<typename cpu_type>
+std::shared_ptr<gb_bus>& basic_gameboy<cpu_type>::get_bus()
 {
     return bus;
 }
 
-std::shared_ptr<gb_timer>& gameboy::get_timer()
+template<typename cpu_type>
+std::shared_ptr<gb_scheduler>& basic_gameboy<cpu_type>::get_scheduler()
+{
+    return scheduler;
+}
+
+template<typename cpu_type>
+std::shared_ptr<gb_timer>& basic_gameboy<cpu_type>::get_timer()
 {
     return timer;
 }
 
-void gameboy::run()
+template<typename cpu_type>
+void basic_gameboy<cpu_type>::run()
 {
     is_running = true;
     
@@ -82,14 +99,17 @@ void gameboy::run()
     }
 }
 
-void gameboy::reset()
+template<typename cpu_type>
+void basic_gameboy<cpu_type>::reset()
 {
     cpu->reset();
 }
 
-void gameboy::emulate_cycles(const long int& cycles)
+template<typename cpu_type>
+void basic_gameboy<cpu_type>::emulate_cycles(const long int& cycles)
 {
 
 }
 
-
+template class basic_gameboy<sharpsm83>;
+template class basic_gameboy<fast_sharpsm83>;
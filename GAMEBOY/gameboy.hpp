@@ -7,28 +7,35 @@
 #include "../CARTRIDGE/gb_cartridge.hpp"
 #include "../BUS/gb_bus.hpp"
 #include "../TIMER/gb_timer.hpp"
+#include "gb_scheduler.hpp"
 
-class gameboy{
+// The machine around one of the gb_bus cores: gameboy runs the cycle exact
+// sharpsm83, fast_gameboy the instruction granular fast_sharpsm83 for runs
+// that only need the frames. Both are instantiated in gameboy.cpp.
+template<typename cpu_type>
+class basic_gameboy{
 private:
     std::shared_ptr<gb_bus> bus;
     std::shared_ptr<gb_cartridge> cartridge;
-    std::shared_ptr<sharpsm83> cpu;
+    std::shared_ptr<cpu_type> cpu;
     std::shared_ptr<gb_timer> timer;
     std::shared_ptr<gb_ppu> video;
+    std::shared_ptr<gb_scheduler> scheduler;
 
     bool is_running = false;
     
 public:
-    gameboy();
+    basic_gameboy();
     void load_cartridge(const std::string& path);
 
     const std::shared_ptr<gb_cartridge>& get_cartridge();
 
-    const std::shared_ptr<sharpsm83>& get_cpu() const;
-    std::shared_ptr<sharpsm83>& get_cpu();
+    const std::shared_ptr<cpu_type>& get_cpu() const;
+    std::shared_ptr<cpu_type>& get_cpu();
     std::shared_ptr<gb_bus>& get_bus();
     std::shared_ptr<gb_ppu>& get_video();
     std::shared_ptr<gb_timer>& get_timer();
+    std::shared_ptr<gb_scheduler>& get_scheduler();
 
     void run();
 
@@ -38,4 +45,10 @@ public:
 
     
 };
+
+using gameboy = basic_gameboy<sharpsm83>;
+using fast_gameboy = basic_gameboy<fast_sharpsm83>;
+
+extern template class basic_gameboy<sharpsm83>;
+extern template class basic_gameboy<fast_sharpsm83>;
 #endif
\ No newline at end of file
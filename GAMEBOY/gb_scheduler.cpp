@@ -0,0 +1,61 @@
+#include "gb_scheduler.hpp"
+
+//##############################################################################
+void gb_scheduler::set_callback(gb_event event, event_callback callback, void* context)
+{
+    event_slot& slot = events[static_cast<int>(event)];
+
+    slot.callback = callback;
+    slot.context = context;
+}
+//##############################################################################
+void gb_scheduler::schedule(gb_event event, uint64_t deadline)
+{
+    events[static_cast<int>(event)].deadline = deadline;
+
+    update_next_deadline();
+}
+//##############################################################################
+void gb_scheduler::cancel(gb_event event)
+{
+    schedule(event, NEVER);
+}
+//##############################################################################
+uint64_t gb_scheduler::get_now() const
+{
+    return now;
+}
+//##############################################################################
+uint64_t gb_scheduler::get_next_deadline() const
+{
+    return next_deadline;
+}
+//##############################################################################
+void gb_scheduler::update_next_deadline()
+{
+    next_deadline = NEVER;
+
+    for(const event_slot& slot : events)
+    {
+        if(slot.deadline < next_deadline) next_deadline = slot.deadline;
+    }
+}
+//##############################################################################
+void gb_scheduler::run_events()
+{
+    while(now >= next_deadline)
+    {
+        for(event_slot& slot : events)
+        {
+            if(slot.deadline != next_deadline) continue;
+
+            // the callback posts the component's next deadline
+            slot.deadline = NEVER;
+            slot.callback(slot.context);
+
+            break;
+        }
+
+        update_next_deadline();
+    }
+}
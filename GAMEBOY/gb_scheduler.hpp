@@ -0,0 +1,61 @@
+#ifndef _GB_SCHEDULER_
+#define _GB_SCHEDULER_
+
+#include <cstdint>
+#include <array>
+
+// components that post deadlines to the scheduler
+enum class gb_event
+{
+    PPU_MODE = 0,       // next PPU mode change
+    TIMER_OVERFLOW = 1, // next TIMA overflow
+    COUNT = 2
+};
+
+// Keeps the absolute time of the machine in T-cycles and runs the callback
+// of each component when its deadline is reached, so nothing has to be
+// ticked while the CPU runs between deadlines.
+class gb_scheduler
+{
+public:
+    using event_callback = void (*)(void* context);
+
+    static constexpr uint64_t NEVER = UINT64_MAX;
+private:
+    struct event_slot
+    {
+        uint64_t deadline = NEVER;
+        event_callback callback = nullptr;
+        void* context = nullptr;
+    };
+
+    // there are only a couple of event kinds, a scan beats a heap here
+    std::array<event_slot, static_cast<int>(gb_event::COUNT)> events;
+
+    uint64_t now = 0;
+    uint64_t next_deadline = NEVER;
+
+    // JIT code advances the clock and checks the deadline itself
+    friend class sm83_jit;
+
+    void update_next_deadline();
+    void run_events();
+public:
+    void set_callback(gb_event event, event_callback callback, void* context);
+
+    void schedule(gb_event event, uint64_t deadline);
+    void cancel(gb_event event);
+
+    uint64_t get_now() const;
+    uint64_t get_next_deadline() const;
+
+    // advance the clock, running every event that falls due
+    void advance(uint64_t cycles)
+    {
+        now += cycles;
+
+        if(now >= next_deadline) run_events();
+    }
+};
+
+#endif
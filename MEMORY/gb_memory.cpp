@@ -1,5 +1,6 @@
 #include "gb_memory.hpp"
 #include<iostream>
+#include <algorithm>
 
 uint8_t gb_memory::read_main(uint16_t address)
 {
@@ -55,5 +56,39 @@ uint8_t gb_memory::read_oam(uint16_t address)
 }
 void gb_memory::write_oam(uint16_t address, uint8_t dataIn)
 {
+    // the Y byte moves the object to other lines
+    if(address % 4 == 0 && oam[address] != dataIn)
+    {
+        set_object_lines(address / 4, oam[address], false);
+        set_object_lines(address / 4, dataIn, true);
+    }
+
     oam[address] = dataIn;
+}
+void gb_memory::set_object_lines(uint8_t object, uint8_t y_position, bool covered)
+{
+    uint64_t bit = uint64_t(1) << object;
+
+    // Y is 16 below the top line, objects at 0 or 160 and up are hidden
+    int top = y_position - 16;
+
+    for(int line = std::max(top, 0); line < std::min(top + 16, 144); ++line)
+    {
+        if(covered)
+        {
+            tall_object_lines[line] |= bit;
+            if(line < top + 8) object_lines[line] |= bit;
+        }
+        else
+        {
+            tall_object_lines[line] &= ~bit;
+            if(line < top + 8) object_lines[line] &= ~bit;
+        }
+    }
+}
+uint64_t gb_memory::get_objects_on_line(uint8_t line, bool tall) const
+{
+    if(line >= 144) return 0;
+
+    return tall ? tall_object_lines[line] : object_lines[line];
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define _GB_RAM__
 
 #include <cstdint>
+#include <array>
 
 #define MAIN_MAX_MEMORY_SIZE 8 * 1024
 #define HRAM_MAX_MEMORY_SIZE 0x80
@@ -15,7 +16,15 @@ struct gb_memory
     uint8_t hram[HRAM_MAX_MEMORY_SIZE];
 
     // 160 bytes of OAM memory
-    uint8_t oam[0xA0];
+    uint8_t oam[0xA0] = {};
+
+    // bit n set: object n covers the line, for 8x8 and 8x16 objects; moved
+    // along when write_oam changes a Y position, so the PPU finds the objects
+    // of a line without going through OAM
+    std::array<uint64_t, 144> object_lines{};
+    std::array<uint64_t, 144> tall_object_lines{};
+
+    void set_object_lines(uint8_t object, uint8_t y_position, bool covered);
 
     uint8_t KEY1 = 0x00;
     uint8_t JOYP = 0x3F;
@@ -29,6 +38,9 @@ struct gb_memory
     uint8_t read_oam(uint16_t address);
     void write_oam(uint16_t address, uint8_t dataIn);
 
+    // objects covering a visible line, bit n for object n
+    uint64_t get_objects_on_line(uint8_t line, bool tall) const;
+
     void print_memory_layout();
     void init_memory();
 };
@@ -9,58 +9,85 @@ gb_timer::gb_timer() : div(0xAC00), tima(0), tma(0), tac(0xF8), timer_counter(0)
 }
 gb_timer::~gb_timer() = default;
 
-void gb_timer::tick(int ticks) 
+void gb_timer::sync()
 {
-    if(ticks < 0) 
+    uint64_t now = bus->scheduler->get_now();
+
+    tick(now - last_sync);
+
+    last_sync = now;
+}
+uint64_t gb_timer::stable_until(const uint16_t& address)
+{
+    sync();
+
+    // DIV is the upper byte of the counter
+    if(address == 0xFF04) return last_sync + 0x100 - (div & 0xFF);
+
+    if(!(tac & 0x04)) return gb_scheduler::NEVER;
+
+    uint64_t period = edge_period();
+
+    return last_sync + period - (div & (period - 1));
+}
+uint64_t gb_timer::edge_period() const
+{
+    // TIMA counts on the falling edge of the DIV bit selected by TAC
+    switch (tac & 0x03) 
     {
-        std::cout<<"Can't emulate negative cycles!"<<'\n';
+        case 0: return 1 << 10;  // 4096 Hz, DIV bit 9
+        case 1: return 1 << 4;   // 262144 Hz, DIV bit 3
+        case 2: return 1 << 6;   // 65536 Hz, DIV bit 5
+        default: return 1 << 8;  // 16384 Hz, DIV bit 7
+    }
+}
+void gb_timer::schedule_overflow()
+{
+    if (!(tac & 0x04)) 
+    {
+        bus->scheduler->cancel(gb_event::TIMER_OVERFLOW);
         return;
     }
 
-    while (ticks--)  // handle one CPU cycle at a time
+    // the selected DIV bit falls every period cycles, TIMA overflows on the (0x100 - TIMA)th fall
+    uint64_t period = edge_period();
+    uint64_t first_edge = period - (div & (period - 1));
+
+    bus->scheduler->schedule(gb_event::TIMER_OVERFLOW, last_sync + first_edge + (0xFF - tima) * period);
+}
+void gb_timer::on_overflow(void* context)
+{
+    gb_timer* timer = static_cast<gb_timer*>(context);
+
+    timer->sync();
+    timer->schedule_overflow();
+}
+void gb_timer::tick(uint64_t ticks) 
+{
+    uint64_t old_div = div;
+    uint64_t new_div = old_div + ticks;
+
+    div = new_div;
+
+    if (!(tac & 0x04)) return; // timer disabled
+
+    // falling edges of the selected bit = multiples of the period crossed
+    uint64_t period = edge_period();
+    uint64_t edges = new_div / period - old_div / period;
+
+    if (edges < 0x100u - tima) 
     {
-        uint16_t old_div = div;
-
-        div++;
-        
-        if (!(tac & 0x04)) continue; // timer disabled
-
-        int bit;
-        switch (tac & 0x03) 
-        {
-            case 0: bit = 9; break;   // 4096 Hz
-            case 1: bit = 3; break;   // 262144 Hz
-            case 2: bit = 5; break;   // 65536 Hz
-            case 3: bit = 7; break;   // 16384 Hz
-        }
-
-        // detect falling edge of DIV[bit]
-        bool old_bit = (old_div >> bit ) & 1;
-        bool new_bit = (div >> bit) & 1;
-
-        // 1 -> 0 falling edge
-        if (old_bit && !new_bit) 
-        {
-            // overflow
-            if (tima == 0xFF) 
-            { 
-                tima = 0x00; // reload
-                bus->cpu->set_IF(bus->cpu->get_IF() | 0x4); //s set IF.b2
-                overflow_pending = true;
-            }
-            else 
-            {
-                tima++; 
-            }
-        }
-
-        // if an overflow is pending, reload TIMA with TMA after one machine cycle
-        if (overflow_pending) 
-        {
-            tima = tma;
-            overflow_pending = false;
-        }
+        tima += edges;
+        return;
     }
+
+    // overflow: TIMA reloads from TMA in the same cycle and requests the interrupt,
+    // further overflows reload it again every (0x100 - TMA) edges
+    edges -= 0x100u - tima;
+
+    tima = tma + edges % (0x100u - tma);
+
+    bus->request_interrupt(0x04); // set IF.b2
 }
 
 uint8_t gb_timer::get_DIV() const 
@@ -70,6 +97,8 @@ uint8_t gb_timer::get_DIV() const
 void gb_timer::reset_DIV() 
 { 
     div = 0;
+
+    schedule_overflow();
 }
 uint8_t gb_timer::get_TIMA() const 
 { 
@@ -78,6 +107,8 @@ uint8_t gb_timer::get_TIMA() const
 void gb_timer::set_TIMA(uint8_t v) 
 { 
     tima = v; 
+
+    schedule_overflow();
 }
 uint8_t gb_timer::get_TMA() const 
 { 
@@ -95,10 +126,51 @@ uint8_t gb_timer::get_TAC() const
 void gb_timer::set_TAC(uint8_t v) 
 { 
     tac = v & 0x07; 
+
+    schedule_overflow();
 }
 void gb_timer::set_bus(const std::shared_ptr<gb_bus>& b) 
 {
     bus = b; 
+
+    last_sync = bus->scheduler->get_now();
+
+    bus->scheduler->set_callback(gb_event::TIMER_OVERFLOW, &gb_timer::on_overflow, this);
+    schedule_overflow();
+
+    bus->set_io_handler(0xFF04, {&gb_timer::read_register, &gb_timer::write_register, this});
+    bus->set_io_handler(0xFF05, {&gb_timer::read_register, &gb_timer::write_register, this});
+    bus->set_io_handler(0xFF06, {&gb_timer::read_register, &gb_timer::write_register, this});
+    bus->set_io_handler(0xFF07, {&gb_timer::read_register, &gb_timer::write_register, this, 0xF8, 0x07});
+}
+uint8_t gb_timer::read_register(void* context, const uint16_t& address)
+{
+    gb_timer* timer = static_cast<gb_timer*>(context);
+
+    // the timer only catches up when it is observed
+    timer->sync();
+
+    switch(address)
+    {
+        case 0xFF04: return timer->get_DIV();
+        case 0xFF05: return timer->get_TIMA();
+        case 0xFF06: return timer->get_TMA();
+        default: return timer->get_TAC();
+    }
+}
+void gb_timer::write_register(void* context, const uint16_t& address, const uint8_t& data)
+{
+    gb_timer* timer = static_cast<gb_timer*>(context);
+
+    timer->sync();
+
+    switch(address)
+    {
+        case 0xFF04: timer->reset_DIV(); break;
+        case 0xFF05: timer->set_TIMA(data); break;
+        case 0xFF06: timer->set_TMA(data); break;
+        default: timer->set_TAC(data); break;
+    }
 }
 void gb_timer::print_status()
 {
@@ -19,15 +19,29 @@ public:
     int timer_counter = 0; // counts down CPU cycles until next TIMA tick
     uint clocks = 0;
 
-    bool overflow_pending = false;
+    uint64_t last_sync = 0; // scheduler time the timer was last brought up to
 
     std::shared_ptr<gb_bus> bus; // to request interrupts
 
+    // DIV cycles between two TIMA increments
+    uint64_t edge_period() const;
+
+    // post the next TIMA overflow to the scheduler
+    void schedule_overflow();
+    static void on_overflow(void* context);
+
 public:
     gb_timer();
     ~gb_timer();
 
-    void tick(int ticks); // call this each CPU step
+    // advance DIV and TIMA by a number of T-cycles in one step
+    void tick(uint64_t ticks);
+
+    // catch up with the scheduler clock, before any timer register access
+    void sync();
+
+    // scheduler time of the next change of DIV or TIMA
+    uint64_t stable_until(const uint16_t& address);
 
     uint8_t get_DIV() const;
     void reset_DIV();
@@ -42,6 +56,10 @@ public:
     void set_TAC(uint8_t val);
 
     void set_bus(const std::shared_ptr<gb_bus>& b);
+
+    // I/O handlers for 0xFF04-0xFF07
+    static uint8_t read_register(void* context, const uint16_t& address);
+    static void write_register(void* context, const uint16_t& address, const uint8_t& data);
     
     void print_status();
 };
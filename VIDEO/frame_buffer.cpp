@@ -12,6 +12,16 @@ void frame_buffer::set_pixel(int x, int y, gb_color color)
     buffer[pixel_index(x, y)] = color;
 }
 
+void frame_buffer::set_line(int y, const uint8_t* shades)
+{
+    gb_color* line = &buffer[pixel_index(0, y)];
+
+    for(int x = 0; x < width; ++x)
+    {
+        line[x] = static_cast<gb_color>(shades[x]);
+    }
+}
+
 gb_color frame_buffer::get_pixel(int x, int y) const{ return buffer.at(pixel_index(x, y)); }
 
 int frame_buffer::pixel_index(int x, int y) const { return (y * width) + x; }
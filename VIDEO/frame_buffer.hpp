@@ -11,6 +11,8 @@ public:
     frame_buffer(int width, int height);
 
     void set_pixel(int x, int y, gb_color color) ;
+    // a whole line of shades (0-3, the gb_color values, see get_color)
+    void set_line(int y, const uint8_t* shades);
     gb_color get_pixel(int x, int y) const;
 
     void reset();
@@ -3,6 +3,11 @@
 
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "gb_tile_decode.hpp"
 
 gb_ppu::gb_ppu() : buffer(GAMEBOY_WIDTH, GAMEBOY_HEIGHT)
 {
@@ -16,6 +21,12 @@ gb_ppu::gb_ppu() : buffer(GAMEBOY_WIDTH, GAMEBOY_HEIGHT)
     LYC = 0x00;
 
     BGP = 0xFC;
+
+    WY = 0x00;
+    WX = 0x00;
+
+    // nothing decoded yet
+    dirty_tile_rows.fill(0xFF);
 }
 gb_ppu::~gb_ppu() = default;
 
@@ -23,44 +34,36 @@ void gb_ppu::tick(int cycles)
 {
     cycle_count += cycles;
     
-    switch(mode)
+    // a long batch can cross several mode changes
+    while(cycle_count >= mode_duration())
     {
-        case ppu_mode::OAM_SEARCH:
-        {
-            select_objects_for_line();
+        cycle_count -= mode_duration();
 
-            if(cycle_count >= CLOCKS_PER_OAM_SEARCH)
+        switch(mode)
+        {
+            case ppu_mode::OAM_SEARCH:
             {
-                cycle_count -= CLOCKS_PER_OAM_SEARCH;
+                select_objects_for_line();
 
                 mode = ppu_mode::PIXEL_TRANSFER;
 
                 update_STAT();
-            }
 
-            break;
-        }
-        case ppu_mode::PIXEL_TRANSFER:
-        {
-            // Transfer the pixel data to the LCD driver
-            if(cycle_count >= CLOCKS_PER_PIXEL_TRANSFER) // 172 cycles for pixel transfer
+                break;
+            }
+            case ppu_mode::PIXEL_TRANSFER:
             {
-                cycle_count -= CLOCKS_PER_PIXEL_TRANSFER;
-
+                // Transfer the pixel data to the LCD driver
                 mode = ppu_mode::HBLANK;
 
                 update_STAT();
                 
                 render_scanline();
+
+                break;
             }
-            break;
-        }
-        case ppu_mode::HBLANK:
-        {
-            if(cycle_count >= CLOCKS_PER_HBLANK)
+            case ppu_mode::HBLANK:
             {
-                cycle_count -= CLOCKS_PER_HBLANK;
-
                 LY++;
 
                 if(LY == 144)
@@ -68,7 +71,7 @@ void gb_ppu::tick(int cycles)
                     mode = ppu_mode::VBLANK;
                     
                     // fire VBLANK interrupt
-                    bus->cpu->set_IF(bus->cpu->get_IF() | 0x01);
+                    bus->request_interrupt(0x01);
 
                     update_STAT();
                 }
@@ -78,31 +81,124 @@ void gb_ppu::tick(int cycles)
 
                     update_STAT();
                 }
+                
+                break;
             }
-            
-            break;
-        }
-        case ppu_mode::VBLANK:
-        {
-            if(cycle_count >= CLOCKS_PER_VBLANK)
+            case ppu_mode::VBLANK:
             {
-                cycle_count -= CLOCKS_PER_VBLANK;
-
                 LY++;
 
                 if(LY == 154)
                 {
                     LY = 0;
+                    window_line = 0;
                     mode = ppu_mode::OAM_SEARCH;
                     update_STAT();
                 }
 
+                break;
             }
-
-            break;
         }
     }
 }
+int gb_ppu::mode_duration() const
+{
+    switch(mode)
+    {
+        case ppu_mode::OAM_SEARCH: return CLOCKS_PER_OAM_SEARCH;
+        case ppu_mode::PIXEL_TRANSFER: return CLOCKS_PER_PIXEL_TRANSFER;
+        case ppu_mode::HBLANK: return CLOCKS_PER_HBLANK;
+        default: return CLOCKS_PER_VBLANK;
+    }
+}
+uint64_t gb_ppu::stable_until(const uint16_t& address)
+{
+    sync();
+
+    uint64_t next_mode = last_sync - cycle_count + mode_duration();
+
+    // STAT follows every mode change, LY only moves at the end of a line
+    if(address == 0xFF41) return next_mode;
+
+    switch(mode)
+    {
+        case ppu_mode::OAM_SEARCH: return next_mode + CLOCKS_PER_PIXEL_TRANSFER + CLOCKS_PER_HBLANK;
+        case ppu_mode::PIXEL_TRANSFER: return next_mode + CLOCKS_PER_HBLANK;
+        default: return next_mode;
+    }
+}
+void gb_ppu::sync()
+{
+    uint64_t now = bus->scheduler->get_now();
+
+    tick(now - last_sync);
+
+    last_sync = now;
+}
+uint64_t gb_ppu::cycles_to_line_offset(uint32_t frame_position, uint32_t offset, uint32_t first_line, uint32_t last_line)
+{
+    uint32_t line = frame_position / CLOCKS_PER_VBLANK;
+
+    if(frame_position % CLOCKS_PER_VBLANK >= offset || line < first_line) 
+    {
+        line = line < first_line ? first_line : line + 1;
+    }
+
+    if(line > last_line)
+    {
+        line = first_line + LINES_PER_FRAME;
+    }
+
+    return line * CLOCKS_PER_VBLANK + offset - frame_position;
+}
+void gb_ppu::schedule_next_event()
+{
+    bool visible_line = mode != ppu_mode::VBLANK && LY < 144;
+    bool vblank_line = mode == ppu_mode::VBLANK && 144 <= LY && LY < LINES_PER_FRAME;
+
+    // LY was written with something odd, follow every mode change
+    if(!visible_line && !vblank_line)
+    {
+        bus->scheduler->schedule(gb_event::PPU_MODE, last_sync - cycle_count + mode_duration());
+        return;
+    }
+
+    // position in the frame, lines are OAM search, pixel transfer and HBLANK
+    uint32_t frame_position = LY * CLOCKS_PER_VBLANK + cycle_count;
+
+    if(mode == ppu_mode::PIXEL_TRANSFER) frame_position += CLOCKS_PER_OAM_SEARCH;
+    if(mode == ppu_mode::HBLANK) frame_position += CLOCKS_PER_OAM_SEARCH + CLOCKS_PER_PIXEL_TRANSFER;
+
+    const uint32_t HBLANK_OFFSET = CLOCKS_PER_OAM_SEARCH + CLOCKS_PER_PIXEL_TRANSFER;
+
+    // VBLANK always raises an interrupt
+    uint64_t next = cycles_to_line_offset(frame_position, 0, 144, 144);
+
+    // STAT interrupts, only the mode changes that can raise them wake the PPU up
+    if(STAT & 0x08) 
+    {
+        next = std::min(next, cycles_to_line_offset(frame_position, HBLANK_OFFSET, 0, 143));
+    }
+    if(STAT & 0x20) 
+    {
+        next = std::min(next, cycles_to_line_offset(frame_position, 0, 0, 143));
+    }
+    if((STAT & 0x40) && LYC < 144)
+    {
+        next = std::min(next, cycles_to_line_offset(frame_position, 0, LYC, LYC));
+        next = std::min(next, cycles_to_line_offset(frame_position, CLOCKS_PER_OAM_SEARCH, LYC, LYC));
+        next = std::min(next, cycles_to_line_offset(frame_position, HBLANK_OFFSET, LYC, LYC));
+    }
+
+    bus->scheduler->schedule(gb_event::PPU_MODE, last_sync + next);
+}
+void gb_ppu::on_event(void* context)
+{
+    gb_ppu* ppu = static_cast<gb_ppu*>(context);
+
+    ppu->sync();
+    ppu->schedule_next_event();
+}
 
 uint8_t gb_ppu::read(const uint16_t& address)
 {
@@ -111,30 +207,52 @@ uint8_t gb_ppu::read(const uint16_t& address)
 void gb_ppu::write(const uint16_t& address, const uint8_t& data)
 {
     video_ram[address] = data;
+
+    // tile data, 2 bytes per row
+    if(address < VIDEO_RAM_TILE_COUNT * 16)
+    {
+        dirty_tile_rows[address / 16] |= 1 << ((address % 16) / 2);
+    }
+}
+void gb_ppu::decode_tile(uint32_t tile)
+{
+    const uint8_t* data = &video_ram[tile * 16];
+
+    decode_tile_rows(data, 8, reinterpret_cast<uint8_t*>(&tile_rows[tile * 8]));
+    decode_tile_rows(data, 8, reinterpret_cast<uint8_t*>(&flipped_tile_rows[tile * 8]), true);
+
+    dirty_tile_rows[tile] = 0;
+}
+const uint8_t* gb_ppu::get_video_ram() const
+{
+    return video_ram;
 }
 void gb_ppu::select_objects_for_line() 
 {
     visible_objects.clear();
 
-    int spriteHeight = (LCDC & 0x04) ? 16 : 8;
+    const gb_memory& mem = bus->mem;
 
-    for (int i = 0; i < 40; ++i) 
-    {
-        object_attribute obj;
-        obj.y_position = bus->bus_read(0xFE00 + i*4 + 0);
-        obj.x_position = bus->bus_read(0xFE00 + i*4 + 1);
-        obj.tile_index = bus->bus_read(0xFE00 + i*4 + 2);
-        obj.attributes = bus->bus_read(0xFE00 + i*4 + 3);
+    // the first 10 objects of the line in OAM order, the ones off screen
+    // horizontally count as well
+    uint64_t objects = mem.get_objects_on_line(LY, LCDC & 0x04);
 
-        int top = obj.y_position - 16;
+    for(int i = 0; objects && visible_objects.size() < 10; ++i, objects >>= 1)
+    {
+        if(!(objects & 1)) continue;
 
-        if (LY >= top && LY < top + spriteHeight) 
-        {
-            visible_objects.push_back(obj);
+        object_attribute obj;
+        obj.y_position = mem.oam[i*4 + 0];
+        obj.x_position = mem.oam[i*4 + 1];
+        obj.tile_index = mem.oam[i*4 + 2];
+        obj.attributes = mem.oam[i*4 + 3];
 
-            if (visible_objects.size() == 10) break;
-        }
+        visible_objects.push_back(obj);
     }
+
+    // front to back: the smaller X wins, then the lower OAM index
+    std::stable_sort(visible_objects.begin(), visible_objects.end(),
+        [](const object_attribute& a, const object_attribute& b) { return a.x_position < b.x_position; });
 }
 
 void gb_ppu::render_scanline()
@@ -147,90 +265,106 @@ void gb_ppu::render_scanline()
 
     //std::cout<<"Current LY: "<<(int)LY<<'\n';
 
-    // 1. Backgound
+    uint8_t shades[GAMEBOY_WIDTH];
+
+    // 1. Backgound and window, white when they are off
     if(LCDC & 0x01)
     {
         render_background_line();
+
+        if(LCDC & 0x20)
+        {
+            render_window_line();
+        }
+
+        apply_palette(scanline_color_index, GAMEBOY_WIDTH, BGP, shades);
+    }
+    else
+    {
+        std::memset(scanline_color_index, 0, sizeof(scanline_color_index));
+        std::memset(shades, 0, sizeof(shades));
     }
 
     // 2. Sprites
     if(LCDC & 0x02)
     {
-        render_sprite_line();
+        render_sprite_line(shades);
     }
-    
+
+    buffer.set_line(LY, shades);
 }
 
-void gb_ppu::render_background_line()
+void gb_ppu::fetch_tile_row(uint16_t map_address, uint8_t y, uint8_t first_column, int tile_count, uint8_t* pixels)
 {
-    // Background tile map base address (0x9800 or 0x9C00)
-    uint16_t bg_base_pointer = (LCDC & 0x08) ? 0x9C00 : 0x9800;
-    // Tile data base address (0x8000 unsigned, or 0x8800 signed)
-    uint16_t tile_data_base = (LCDC & 0x10) ? 0x8000 : 0x8800;
-    uint8_t palette = bus->bus_read(0xFF47);
-
-    uint screen_y = LY;
+    const uint8_t* map = &video_ram[map_address - 0x8000 + (y / 8) * 32];
 
-    for (uint screen_x = 0; screen_x < 160; ++screen_x)
+    for(int tile = 0; tile < tile_count; ++tile)
     {
-        // Screen position adjusted by scroll
-        uint scrolled_x = screen_x + SCX;
-        uint scrolled_y = screen_y + SCY;
+        uint8_t tile_index = map[(first_column + tile) & 0x1F];
 
-        // Tile coordinates in the map
-        // uint tile_row = scrolled_y / 8;
-        // uint tile_col = scrolled_x / 8;
+        // tiles from 0x8000 unsigned or around 0x9000 signed
+        uint32_t tile_data = (LCDC & 0x10) ? tile_index : 256 + static_cast<int8_t>(tile_index);
 
-        uint tile_row = (scrolled_y % 256) / 8;
-        uint tile_col = (scrolled_x % 256) / 8;
+        uint64_t row_pixels = get_tile_row(tile_data, y % 8);
 
-        // Fetch tile index from the tile map
-        uint16_t tile_map_address = bg_base_pointer + (tile_row * 32) + tile_col;
-        uint8_t tile_index = bus->bus_read(tile_map_address);
+        std::memcpy(pixels + tile * 8, &row_pixels, sizeof(row_pixels));
+    }
+}
 
-        // Handle signed indexing in 0x8800 mode
-        uint real_index = (LCDC & 0x10) ? tile_index : (int8_t)tile_index;
+void gb_ppu::render_background_line()
+{
+    // Background tile map base address (0x9800 or 0x9C00)
+    uint16_t map_address = (LCDC & 0x08) ? 0x9C00 : 0x9800;
 
-        // Each tile = 16 bytes (2 bytes per row, 8 rows)
-        uint16_t tile_addr = tile_data_base + (real_index * 16);
+    // 21 tiles cover the line at any fine scroll, SCX % 8 only picks where
+    // the line starts in the first one
+    uint8_t pixels[21 * 8];
 
-        // Select row within tile
-        uint8_t tile_line = scrolled_y % 8;
-        uint8_t low  = bus->bus_read(tile_addr + tile_line * 2);
-        uint8_t high = bus->bus_read(tile_addr + tile_line * 2 + 1);
+    fetch_tile_row(map_address, LY + SCY, SCX / 8, 21, pixels);
 
-        // Bit index (MSB = leftmost pixel)
-        int bit = 7 - (scrolled_x % 8);
-        uint8_t pixel_value = ((high >> bit) & 1) << 1 | ((low >> bit) & 1);
+    std::memcpy(scanline_color_index, pixels + SCX % 8, GAMEBOY_WIDTH);
+}
 
-        // Store raw color index (0–3) for sprite blending
-        scanline_color_index[screen_x] = pixel_value;
+void gb_ppu::render_window_line()
+{
+    // WX 7 is the left edge, past 166 the window is off screen
+    if(LY < WY || WX > 166)
+    {
+        return;
+    }
 
-        // Map pixel value through background palette (FF47)
-        uint8_t shade = (palette >> (pixel_value * 2)) & 0x03;
+    uint16_t map_address = (LCDC & 0x40) ? 0x9C00 : 0x9800;
 
-        gb_color color = get_color(shade);
+    // WX below 7 cuts into the first tile the way SCX does for the background
+    int left = WX - 7;
+    int skip = left < 0 ? -left : 0;
+    int first_x = std::max(left, 0);
+    int width = GAMEBOY_WIDTH - first_x;
 
-        buffer.set_pixel(screen_x, screen_y, color);
-    }
-}
+    uint8_t pixels[21 * 8];
 
-void gb_ppu::render_window_line()
-{
+    fetch_tile_row(map_address, window_line, 0, (skip + width + 7) / 8, pixels);
+
+    std::memcpy(scanline_color_index + first_x, pixels + skip, width);
 
+    window_line++;
 }
-void gb_ppu::render_sprite_line()
+
+void gb_ppu::render_sprite_line(uint8_t* shades)
 {
+    if(visible_objects.empty()) return;
+
     int height = (LCDC & 0x04) ? 16 : 8;
 
-    int screen_y = LY;
+    // object pixels laid out like compose_objects wants them, 8 bytes of
+    // margin on both sides so every object row is written whole
+    uint8_t object_line[8 + GAMEBOY_WIDTH + 8] = {};
 
     for(int i=0; i<visible_objects.size(); ++i)
     {
         const object_attribute& sprite = visible_objects[i];
 
-        // TODO: more complicated
-        if (sprite.y_position == 0 || sprite.y_position >= 160) { continue; }
+        // X is 8 right of the leftmost pixel, 0 and 168 and up are off screen
         if (sprite.x_position == 0 || sprite.x_position >= 168) { continue; }
 
         // Y position in screen space: OAM.y - 16
@@ -238,7 +372,7 @@ void gb_ppu::render_sprite_line()
         int y_in_sprite = LY - y_pos;
 
         // Apply vertical flip
-        bool y_flip = sprite.attributes & 0x10;
+        bool y_flip = sprite.attributes & 0x40;
         if (y_flip)
         {
             y_in_sprite = height - 1 - y_in_sprite;
@@ -256,46 +390,92 @@ void gb_ppu::render_sprite_line()
             }
         }
 
-        // Fetch the 2 bytes for this row of tile data
-        uint16_t tile_addr = 0x8000 + (tile_index * 16);
-        uint8_t low  = bus->bus_read(tile_addr + y_in_sprite * 2);
-        uint8_t high = bus->bus_read(tile_addr + y_in_sprite * 2 + 1);
+        // the decoded row, already mirrored for X flip
+        bool x_flip = sprite.attributes & 0x20;
+        uint64_t row = get_tile_row(tile_index, y_in_sprite, x_flip);
 
-        for (int x = 0; x < 8; x++) 
-        {
-            // OAM.x - 8 is the true position
-            int screen_x = sprite.x_position - 8 + x;
+        // palette and BG priority bits on every pixel of the row
+        uint64_t flags = ((sprite.attributes & 0x10) ? 0x04 : 0x00) | ((sprite.attributes & 0x80) ? 0x08 : 0x00);
+        flags *= 0x0101010101010101ULL;
+
+        // 0xFF in the bytes with a color index other than 0
+        uint64_t opaque = ((row | (row >> 1)) & 0x0101010101010101ULL) * 0xFF;
 
-            if (screen_x < 0 || screen_x >= 160) continue;
+        // objects come front to back, a pixel only goes where no object
+        // before it has one; behind the background it still hides the
+        // objects after it
+        uint64_t line;
+        std::memcpy(&line, object_line + sprite.x_position, sizeof(line));
 
-            //bool x_flip = sprite.attributes & 0x20;
-            bool x_flip = false;
+        uint64_t taken = ((line | (line >> 1)) & 0x0101010101010101ULL) * 0xFF;
 
-            int bit = x_flip ? x : (7 - x);
-            uint8_t pixel_value = ((high >> bit) & 1) << 1 | ((low >> bit) & 1);
+        line |= (row | flags) & opaque & ~taken;
 
-            // transparent pixel
-            if (pixel_value == 0) continue;
+        std::memcpy(object_line + sprite.x_position, &line, sizeof(line));
+    }
+
+    compose_objects(object_line + 8, scanline_color_index, GAMEBOY_WIDTH, OBP0, OBP1, shades);
+}
 
-            bool priority = sprite.attributes & 0x80;
-            bool bg_non_zero = (scanline_color_index[screen_x] != 0);
+void gb_ppu::set_bus(const std::shared_ptr<gb_bus>& b) 
+{
+    bus = b; 
 
-            if (priority && bg_non_zero) continue; // behind BG
-            
-            bool pallete_bit = sprite.attributes & 0x10;
-            uint8_t palette = pallete_bit ? bus->bus_read(0xFF49) : bus->bus_read(0xFF48);
+    last_sync = bus->scheduler->get_now();
 
-            uint8_t shade = (palette >> (pixel_value * 2)) & 0x03;
+    bus->scheduler->set_callback(gb_event::PPU_MODE, &gb_ppu::on_event, this);
+    schedule_next_event();
 
-            gb_color color = get_color(shade);
-            buffer.set_pixel(screen_x, screen_y, color);
-        }
+    for(uint16_t address : {0xFF40, 0xFF42, 0xFF43, 0xFF44, 0xFF45, 0xFF47, 0xFF48, 0xFF49, 0xFF4A, 0xFF4B})
+    {
+        bus->set_io_handler(address, {&gb_ppu::read_register, &gb_ppu::write_register, this});
     }
+
+    // mode and coincidence bits are read only
+    bus->set_io_handler(0xFF41, {&gb_ppu::read_register, &gb_ppu::write_register, this, 0x80, 0x78});
 }
+uint8_t gb_ppu::read_register(void* context, const uint16_t& address)
+{
+    gb_ppu* ppu = static_cast<gb_ppu*>(context);
 
-void gb_ppu::set_bus(const std::shared_ptr<gb_bus>& b) 
+    // the PPU only catches up when it is observed
+    ppu->sync();
+
+    switch(address)
+    {
+        case 0xFF40: return ppu->read_LCDC();
+        case 0xFF41: return ppu->read_STAT();
+        case 0xFF42: return ppu->read_SCY();
+        case 0xFF43: return ppu->read_SCX();
+        case 0xFF44: return ppu->read_LY();
+        case 0xFF45: return ppu->read_LYC();
+        case 0xFF47: return ppu->read_BGP();
+        case 0xFF48: return ppu->read_OPB0();
+        case 0xFF49: return ppu->read_OPB1();
+        case 0xFF4A: return ppu->read_WY();
+        default: return ppu->read_WX();
+    }
+}
+void gb_ppu::write_register(void* context, const uint16_t& address, const uint8_t& data)
 {
-    bus = b; 
+    gb_ppu* ppu = static_cast<gb_ppu*>(context);
+
+    ppu->sync();
+
+    switch(address)
+    {
+        case 0xFF40: ppu->write_LCDC(data); break;
+        case 0xFF41: ppu->write_STAT(data); break;
+        case 0xFF42: ppu->write_SCY(data); break;
+        case 0xFF43: ppu->write_SCX(data); break;
+        case 0xFF44: ppu->write_LY(data); break;
+        case 0xFF45: ppu->write_LYC(data); break;
+        case 0xFF47: ppu->write_BGP(data); break;
+        case 0xFF48: ppu->write_OBP0(data); break;
+        case 0xFF49: ppu->write_OBP1(data); break;
+        case 0xFF4A: ppu->write_WY(data); break;
+        default: ppu->write_WX(data); break;
+    }
 }
 void gb_ppu::update_STAT() 
 {
@@ -330,7 +510,7 @@ void gb_ppu::update_STAT()
 
     if (request) 
     {
-        bus->cpu->set_IF(bus->cpu->get_IF() | 0x02);
+        bus->request_interrupt(0x02);
     }
 
     prev_mode = mode;
@@ -338,6 +518,8 @@ void gb_ppu::update_STAT()
 }
 const frame_buffer& gb_ppu::get_frame_buffer()
 {
+    sync();
+
     return buffer;
 }
 uint8_t gb_ppu::read_LCDC()
@@ -354,7 +536,9 @@ uint8_t gb_ppu::read_STAT()
 }
 void gb_ppu::write_STAT(uint8_t data)
 {
-    STAT = data;
+    STAT = (STAT & 0x07) | (data & 0x78);
+
+    schedule_next_event();
 }
 uint8_t gb_ppu::read_SCY()
 {
@@ -379,6 +563,8 @@ uint8_t gb_ppu::read_LY()
 void gb_ppu::write_LY(uint8_t data)
 {
     LY = data;
+
+    schedule_next_event();
 }
 uint8_t gb_ppu::read_LYC()
 {
@@ -387,6 +573,8 @@ uint8_t gb_ppu::read_LYC()
 void gb_ppu::write_LYC(uint8_t data)
 {
     LYC = data;
+
+    schedule_next_event();
 }
 
 uint8_t gb_ppu::read_BGP()
@@ -414,6 +602,22 @@ void gb_ppu::write_OBP1(uint8_t data)
 {
     OBP1 = data;
 }
+uint8_t gb_ppu::read_WY()
+{
+    return WY;
+}
+void gb_ppu::write_WY(uint8_t data)
+{
+    WY = data;
+}
+uint8_t gb_ppu::read_WX()
+{
+    return WX;
+}
+void gb_ppu::write_WX(uint8_t data)
+{
+    WX = data;
+}
 void gb_ppu::dump_vram(const std::string &filename) 
 {
     std::ofstream out(filename, std::ios::binary);
@@ -432,4 +636,36 @@ void gb_ppu::dump_vram(const std::string &filename)
 
     out.close();
     std::cout << "VRAM dumped to " << filename << " (" << size << " bytes)\n";
+}
+void gb_ppu::dump_tiles(const std::string &filename)
+{
+    // every tile row of 0x8000-0x97FF in one go, shaded with BGP
+    std::vector<uint8_t> pixels(VIDEO_RAM_TILE_COUNT * 64);
+
+    decode_tile_rows(video_ram, VIDEO_RAM_TILE_COUNT * 8, pixels.data());
+    apply_palette(pixels.data(), pixels.size(), BGP, pixels.data());
+
+    // 16 tiles per row of the image, as binary PGM
+    const int width = 16 * 8;
+    const int height = VIDEO_RAM_TILE_COUNT / 16 * 8;
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        std::cerr << "Failed to open tile dump file: " << filename << "\n";
+        return;
+    }
+
+    out << "P5\n" << width << ' ' << height << "\n255\n";
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int tile = (y / 8) * 16 + x / 8;
+            uint8_t shade = pixels[tile * 64 + (y % 8) * 8 + x % 8];
+
+            out.put(static_cast<char>(255 - shade * 85));
+        }
+    }
+
+    out.close();
+    std::cout << "Tiles dumped to " << filename << " (" << width << "x" << height << ")\n";
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define _gb_ppu_
 
 #include <cstdint>
+#include <array>
 #include <vector>
 #include <memory>
 
@@ -11,10 +12,14 @@
 
 #define VIDEO_RAM_MAX_MEMORY_SIZE 0x2000
 
+// tiles in 0x8000-0x97FF, 16 bytes each
+#define VIDEO_RAM_TILE_COUNT 384
+
 #define CLOCKS_PER_OAM_SEARCH 80
 #define CLOCKS_PER_PIXEL_TRANSFER 172
 #define CLOCKS_PER_HBLANK 204
 #define CLOCKS_PER_VBLANK 456
+#define LINES_PER_FRAME 154
 
 const uint GAMEBOY_WIDTH = 160;
 const uint GAMEBOY_HEIGHT = 144;
@@ -43,10 +48,31 @@ private:
     // 8 kb of video RAM
     uint8_t video_ram[VIDEO_RAM_MAX_MEMORY_SIZE];
 
+    // every tile row decoded to one color index per byte, leftmost pixel
+    // first, and mirrored for sprites with X flip; a tile is decoded again
+    // when it is used after a write to its data
+    std::array<uint64_t, VIDEO_RAM_TILE_COUNT * 8> tile_rows;
+    std::array<uint64_t, VIDEO_RAM_TILE_COUNT * 8> flipped_tile_rows;
+
+    // bit n set: row n of the tile was written since it was decoded
+    std::array<uint8_t, VIDEO_RAM_TILE_COUNT> dirty_tile_rows;
+
+    void decode_tile(uint32_t tile);
+
+    // decoded row of tile (0x8000 + tile * 16)
+    uint64_t get_tile_row(uint32_t tile, uint32_t row, bool x_flip = false)
+    {
+        if(dirty_tile_rows[tile]) decode_tile(tile);
+
+        return x_flip ? flipped_tile_rows[tile * 8 + row] : tile_rows[tile * 8 + row];
+    }
+
     ppu_mode mode = ppu_mode::OAM_SEARCH;
 
     long int cycle_count = 0;
 
+    uint64_t last_sync = 0; // scheduler time the PPU was last brought up to
+
     std::shared_ptr<gb_bus> bus;
 
     std::vector<object_attribute> visible_objects;
@@ -71,24 +97,53 @@ private:
     uint8_t WX; // Window X position (0xFF4B)
     uint8_t WY; // Window Y position (0xFF4A)
 
+    // line of the window drawn next, it only moves on lines that show it
+    uint8_t window_line = 0;
+
     void select_objects_for_line();
     void render_scanline();
     void render_background_line();
     void render_window_line();
-    void render_sprite_line();
+    // the objects of the line over the background shades
+    void render_sprite_line(uint8_t* shades);
+
+    // color indices of tile_count tiles of the tile map at map_address, from
+    // column first_column on (wrapping) and on line y of the 256x256 map
+    void fetch_tile_row(uint16_t map_address, uint8_t y, uint8_t first_column, int tile_count, uint8_t* pixels);
 
     void update_STAT();
+
+    int mode_duration() const;
+
+    // the PPU only wakes up for mode changes that can raise an interrupt,
+    // anything else is caught up when VRAM, OAM or a register is accessed
+    void schedule_next_event();
+    static void on_event(void* context);
+    static uint64_t cycles_to_line_offset(uint32_t frame_position, uint32_t offset, uint32_t first_line, uint32_t last_line);
 public:
     gb_ppu();
     ~gb_ppu();
 
     void tick(int cycles);
 
+    // catch up with the scheduler clock
+    void sync();
+
+    // scheduler time of the next change of LY or STAT
+    uint64_t stable_until(const uint16_t& address);
+
     uint8_t read(const uint16_t& address);
     void write(const uint16_t& address, const uint8_t& data);
 
+    // for the bus page table, VRAM reads don't need the PPU to catch up
+    const uint8_t* get_video_ram() const;
+
     void set_bus(const std::shared_ptr<gb_bus>& b);
 
+    // I/O handlers for the LCD registers
+    static uint8_t read_register(void* context, const uint16_t& address);
+    static void write_register(void* context, const uint16_t& address, const uint8_t& data);
+
     const frame_buffer& get_frame_buffer();
 
     uint8_t read_LCDC();
@@ -118,7 +173,15 @@ public:
     uint8_t read_OPB1();
     void write_OBP1(uint8_t data);
 
+    uint8_t read_WY();
+    void write_WY(uint8_t data);
+
+    uint8_t read_WX();
+    void write_WX(uint8_t data);
+
     void dump_vram(const std::string &filename);
+    // the tile data as a grayscale PGM image, shaded with BGP
+    void dump_tiles(const std::string &filename);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include <array>
+#include <cstring>
+
+#include "gb_tile_decode.hpp"
+
+#if defined(VIDEO_SCALAR_DECODE)
+// forced portable build
+#elif defined(__AVX2__)
+#define VIDEO_AVX2_DECODE
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#define VIDEO_SSE2_DECODE
+#include <emmintrin.h>
+#endif
+
+// a bitplane byte spread over 8 bytes, leftmost pixel first (or last when
+// flipped), so a whole tile row is spread[low] | spread[high] << 1
+static std::array<uint64_t, 256> make_bitplane_spread(bool flipped)
+{
+    std::array<uint64_t, 256> table{};
+
+    for(uint32_t value = 0; value < 256; ++value)
+    {
+        uint8_t pixels[8];
+
+        for(int x = 0; x < 8; ++x)
+        {
+            pixels[x] = (value >> (flipped ? x : 7 - x)) & 1;
+        }
+
+        std::memcpy(&table[value], pixels, sizeof(pixels));
+    }
+
+    return table;
+}
+
+static const std::array<uint64_t, 256> bitplane_spread = make_bitplane_spread(false);
+static const std::array<uint64_t, 256> flipped_bitplane_spread = make_bitplane_spread(true);
+
+//##############################################################################
+static void decode_tile_rows_scalar(const uint8_t* planes, std::size_t count, uint8_t* pixels, bool flipped)
+{
+    const std::array<uint64_t, 256>& spread = flipped ? flipped_bitplane_spread : bitplane_spread;
+
+    for(std::size_t row = 0; row < count; ++row)
+    {
+        uint64_t row_pixels = spread[planes[row * 2]] | (spread[planes[row * 2 + 1]] << 1);
+
+        std::memcpy(pixels + row * 8, &row_pixels, sizeof(row_pixels));
+    }
+}
+//##############################################################################
+static void apply_palette_scalar(const uint8_t* pixels, std::size_t count, uint8_t palette, uint8_t* shades)
+{
+    uint8_t table[4];
+
+    for(uint8_t pixel = 0; pixel < 4; ++pixel)
+    {
+        table[pixel] = (palette >> (pixel * 2)) & 0x03;
+    }
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        shades[i] = table[pixels[i] & 0x03];
+    }
+}
+//##############################################################################
+static void compose_objects_scalar(const uint8_t* objects, const uint8_t* background, std::size_t count, uint8_t obp0, uint8_t obp1, uint8_t* shades)
+{
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        uint8_t object = objects[i];
+        uint8_t index = object & 0x03;
+
+        if(index == 0) continue;
+        if((object & 0x08) && background[i] != 0) continue;
+
+        uint8_t palette = (object & 0x04) ? obp1 : obp0;
+
+        shades[i] = (palette >> (index * 2)) & 0x03;
+    }
+}
+#ifdef VIDEO_AVX2_DECODE
+//##############################################################################
+void decode_tile_rows(const uint8_t* planes, std::size_t count, uint8_t* pixels, bool flipped)
+{
+    // 4 rows a step: every plane byte broadcast over the 8 pixels of its row,
+    // rows 0-1 in the low lane and 2-3 in the high one
+    const __m256i low_planes = _mm256_setr_epi8(
+        0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2,
+        4, 4, 4, 4, 4, 4, 4, 4, 6, 6, 6, 6, 6, 6, 6, 6);
+    const __m256i high_planes = _mm256_add_epi8(low_planes, _mm256_set1_epi8(1));
+
+    const __m256i bits = flipped ?
+        _mm256_set1_epi64x(0x8040201008040201ULL) :
+        _mm256_set1_epi64x(0x0102040810204080ULL);
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i two = _mm256_set1_epi8(2);
+
+    std::size_t row = 0;
+
+    for(; row + 4 <= count; row += 4)
+    {
+        __m128i step_planes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(planes + row * 2));
+        __m256i both = _mm256_broadcastsi128_si256(step_planes);
+
+        __m256i low = _mm256_shuffle_epi8(both, low_planes);
+        __m256i high = _mm256_shuffle_epi8(both, high_planes);
+
+        low = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(low, bits), bits), one);
+        high = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(high, bits), bits), two);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + row * 8), _mm256_or_si256(low, high));
+    }
+
+    decode_tile_rows_scalar(planes + row * 2, count - row, pixels + row * 8, flipped);
+}
+//##############################################################################
+void apply_palette(const uint8_t* pixels, std::size_t count, uint8_t palette, uint8_t* shades)
+{
+    // the palette as a shuffle table, only entries 0-3 are ever picked
+    const __m256i table = _mm256_setr_epi8(
+        palette & 0x03, (palette >> 2) & 0x03, (palette >> 4) & 0x03, (palette >> 6) & 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        palette & 0x03, (palette >> 2) & 0x03, (palette >> 4) & 0x03, (palette >> 6) & 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i index_mask = _mm256_set1_epi8(0x03);
+
+    std::size_t i = 0;
+
+    for(; i + 32 <= count; i += 32)
+    {
+        __m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i));
+
+        indices = _mm256_and_si256(indices, index_mask);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(shades + i), _mm256_shuffle_epi8(table, indices));
+    }
+
+    apply_palette_scalar(pixels + i, count - i, palette, shades + i);
+}
+//##############################################################################
+void compose_objects(const uint8_t* objects, const uint8_t* background, std::size_t count, uint8_t obp0, uint8_t obp1, uint8_t* shades)
+{
+    // both palettes as one shuffle table, picked by the low 3 bits
+    const __m256i table = _mm256_setr_epi8(
+        obp0 & 0x03, (obp0 >> 2) & 0x03, (obp0 >> 4) & 0x03, (obp0 >> 6) & 0x03,
+        obp1 & 0x03, (obp1 >> 2) & 0x03, (obp1 >> 4) & 0x03, (obp1 >> 6) & 0x03, 0, 0, 0, 0, 0, 0, 0, 0,
+        obp0 & 0x03, (obp0 >> 2) & 0x03, (obp0 >> 4) & 0x03, (obp0 >> 6) & 0x03,
+        obp1 & 0x03, (obp1 >> 2) & 0x03, (obp1 >> 4) & 0x03, (obp1 >> 6) & 0x03, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i index_mask = _mm256_set1_epi8(0x03);
+    const __m256i palette_mask = _mm256_set1_epi8(0x07);
+    const __m256i behind_bit = _mm256_set1_epi8(0x08);
+
+    std::size_t i = 0;
+
+    for(; i + 32 <= count; i += 32)
+    {
+        __m256i object = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(objects + i));
+        __m256i bg = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(background + i));
+        __m256i shade = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(shades + i));
+
+        __m256i transparent = _mm256_cmpeq_epi8(_mm256_and_si256(object, index_mask), zero);
+        __m256i behind = _mm256_andnot_si256(_mm256_cmpeq_epi8(bg, zero),
+            _mm256_cmpeq_epi8(_mm256_and_si256(object, behind_bit), behind_bit));
+        __m256i hidden = _mm256_or_si256(transparent, behind);
+
+        __m256i object_shade = _mm256_shuffle_epi8(table, _mm256_and_si256(object, palette_mask));
+
+        shade = _mm256_blendv_epi8(object_shade, shade, hidden);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(shades + i), shade);
+    }
+
+    compose_objects_scalar(objects + i, background + i, count - i, obp0, obp1, shades + i);
+}
+//##############################################################################
+const char* tile_decode_kernel()
+{
+    return "AVX2";
+}
+#elif defined(VIDEO_SSE2_DECODE)
+//##############################################################################
+void decode_tile_rows(const uint8_t* planes, std::size_t count, uint8_t* pixels, bool flipped)
+{
+    // without a byte shuffle the plane bytes have to be broadcast with
+    // unpacks, which came out slower than the two table loads per row
+    decode_tile_rows_scalar(planes, count, pixels, flipped);
+}
+//##############################################################################
+void apply_palette(const uint8_t* pixels, std::size_t count, uint8_t palette, uint8_t* shades)
+{
+    // no byte shuffle, every index picks its shade with a compare
+    __m128i shade[4];
+    __m128i index[4];
+
+    for(int pixel = 0; pixel < 4; ++pixel)
+    {
+        shade[pixel] = _mm_set1_epi8((palette >> (pixel * 2)) & 0x03);
+        index[pixel] = _mm_set1_epi8(pixel);
+    }
+
+    const __m128i index_mask = _mm_set1_epi8(0x03);
+
+    std::size_t i = 0;
+
+    for(; i + 16 <= count; i += 16)
+    {
+        __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+
+        indices = _mm_and_si128(indices, index_mask);
+
+        __m128i result = _mm_and_si128(_mm_cmpeq_epi8(indices, index[0]), shade[0]);
+        result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi8(indices, index[1]), shade[1]));
+        result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi8(indices, index[2]), shade[2]));
+        result = _mm_or_si128(result, _mm_and_si128(_mm_cmpeq_epi8(indices, index[3]), shade[3]));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(shades + i), result);
+    }
+
+    apply_palette_scalar(pixels + i, count - i, palette, shades + i);
+}
+//##############################################################################
+void compose_objects(const uint8_t* objects, const uint8_t* background, std::size_t count, uint8_t obp0, uint8_t obp1, uint8_t* shades)
+{
+    // no byte shuffle, every palette entry picks its shade with a compare
+    __m128i palette_shade[8];
+    __m128i palette_entry[8];
+
+    for(int entry = 0; entry < 8; ++entry)
+    {
+        uint8_t palette = entry < 4 ? obp0 : obp1;
+
+        palette_shade[entry] = _mm_set1_epi8((palette >> ((entry & 0x03) * 2)) & 0x03);
+        palette_entry[entry] = _mm_set1_epi8(entry);
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i index_mask = _mm_set1_epi8(0x03);
+    const __m128i palette_mask = _mm_set1_epi8(0x07);
+    const __m128i behind_bit = _mm_set1_epi8(0x08);
+
+    std::size_t i = 0;
+
+    for(; i + 16 <= count; i += 16)
+    {
+        __m128i object = _mm_loadu_si128(reinterpret_cast<const __m128i*>(objects + i));
+        __m128i bg = _mm_loadu_si128(reinterpret_cast<const __m128i*>(background + i));
+        __m128i shade = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shades + i));
+
+        __m128i transparent = _mm_cmpeq_epi8(_mm_and_si128(object, index_mask), zero);
+        __m128i behind = _mm_andnot_si128(_mm_cmpeq_epi8(bg, zero),
+            _mm_cmpeq_epi8(_mm_and_si128(object, behind_bit), behind_bit));
+        __m128i hidden = _mm_or_si128(transparent, behind);
+
+        __m128i entry = _mm_and_si128(object, palette_mask);
+        __m128i object_shade = zero;
+
+        // entries 0 and 4 are transparent
+        for(int e = 1; e < 8; ++e)
+        {
+            if(e == 4) continue;
+
+            object_shade = _mm_or_si128(object_shade, _mm_and_si128(_mm_cmpeq_epi8(entry, palette_entry[e]), palette_shade[e]));
+        }
+
+        shade = _mm_or_si128(_mm_and_si128(hidden, shade), _mm_andnot_si128(hidden, object_shade));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(shades + i), shade);
+    }
+
+    compose_objects_scalar(objects + i, background + i, count - i, obp0, obp1, shades + i);
+}
+//##############################################################################
+const char* tile_decode_kernel()
+{
+    return "SSE2";
+}
+#else
+//##############################################################################
+void decode_tile_rows(const uint8_t* planes, std::size_t count, uint8_t* pixels, bool flipped)
+{
+    decode_tile_rows_scalar(planes, count, pixels, flipped);
+}
+//##############################################################################
+void apply_palette(const uint8_t* pixels, std::size_t count, uint8_t palette, uint8_t* shades)
+{
+    apply_palette_scalar(pixels, count, palette, shades);
+}
+//##############################################################################
+void compose_objects(const uint8_t* objects, const uint8_t* background, std::size_t count, uint8_t obp0, uint8_t obp1, uint8_t* shades)
+{
+    compose_objects_scalar(objects, background, count, obp0, obp1, shades);
+}
+//##############################################################################
+const char* tile_decode_kernel()
+{
+    return "scalar";
+}
+#endif
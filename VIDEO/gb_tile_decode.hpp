@@ -0,0 +1,30 @@
+#ifndef _GB_TILE_DECODE_
+#define _GB_TILE_DECODE_
+
+#include <cstdint>
+#include <cstddef>
+
+// Kernels turning 2bpp tile data into pixels and putting the objects over
+// the background, shared by the scanline renderer and the VRAM debug output.
+// VIDEO_SIMD picks them at build time: AVX2 when the compiler targets it,
+// SSE2 on other x86-64 builds (the decode stays on a lookup table there),
+// portable C++ everywhere else.
+
+// count tile rows, each a low and a high bitplane byte, to 8 color indices
+// (0-3) per row, leftmost pixel first or, flipped, last
+void decode_tile_rows(const uint8_t* planes, std::size_t count, uint8_t* pixels, bool flipped = false);
+
+// count color indices to shades (0-3) through a palette laid out like BGP,
+// OBP0 and OBP1
+void apply_palette(const uint8_t* pixels, std::size_t count, uint8_t palette, uint8_t* shades);
+
+// object pixels over count background shades: an object byte is the color
+// index (bits 0-1, 0 is transparent), OBP1 instead of OBP0 (bit 2) and
+// behind background colors 1-3 (bit 3); background holds the color indices
+// the shades came from
+void compose_objects(const uint8_t* objects, const uint8_t* background, std::size_t count, uint8_t obp0, uint8_t obp1, uint8_t* shades);
+
+// the kernels this build uses: "AVX2", "SSE2" or "scalar"
+const char* tile_decode_kernel();
+
+#endif
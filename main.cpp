@@ -10,7 +10,8 @@ int main(int argc, char *argv[])
     // gb.load_cartridge("ROMs/test/halt_bug.gb");
     // gb.run();
 
-    gb_emulator emu;
+    // gbemu [ROM] [sm83_aot module for the ROM]
+    gb_emulator emu(argc > 1 ? argv[1] : "../ROMs/Tetris.gb", argc > 2 ? argv[2] : "");
 
     if (emu.Construct(160, 144, 4, 4))
         emu.Start();